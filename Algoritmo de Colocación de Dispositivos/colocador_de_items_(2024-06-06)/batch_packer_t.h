@@ -0,0 +1,339 @@
+/**
+ * @file     batch_packer_t.h
+ *
+ * @brief    Colocación en paralelo de un lote de pedidos.
+ *
+ * Cada pedido se coloca en su propia box_t, que no comparte estado con las
+ * demás, por lo que los pedidos se reparten entre todos los núcleos con un
+ * work_stealing_pool_t. Los resultados se guardan en la misma posición que el
+ * pedido de entrada, así que salen en el mismo orden en que entraron. Con una
+ * packing_cache_t, los pedidos repetidos no se vuelven a colocar. Con
+ * set_use_arena(), cada hilo coloca sus pedidos sobre su propia
+ * order_arena_t, que se vacía al terminar cada pedido.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del lote de pedidos
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef BATCH_PACKER_T_H
+#define BATCH_PACKER_T_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "box_selector_t.h"
+#include "order_arena_t.h"
+#include "packing_cache_t.h"
+#include "work_stealing_pool_t.h"
+
+using namespace std;
+
+// static const char * BATCH_TAG = __FILE__;
+static const char * BATCH_TAG = "batch_packer_t.h";
+
+// Pedidos que procesa cada tarea del grupo de hilos.
+#define BATCH_CHUNK_SIZE 16
+
+typedef struct
+{
+    boxType_t boxType;
+    list<item_t> items;
+    bool autoBox;       // elegir la caja más pequeña (se ignora boxType)
+
+} order_t;
+
+typedef struct
+{
+    string mqtt_order;     // JSON o MessagePack (ver orderFormat_t)
+    size_t placedItems;    // items colocados en la caja
+    size_t unplacedItems;  // items que no han cabido
+
+} order_result_t;
+
+class batch_packer_t
+{
+    private:
+
+        // ATRIBUTOS.
+        work_stealing_pool_t pool;
+        packingEngine_t engine;
+        packing_cache_t * cache; // caché de resultados (opcional)
+        orderFormat_t format;    // formato de las órdenes
+        bool useArena;           // una order_arena_t por hilo
+        double lastSeconds;
+        size_t lastOrders;
+        atomic<size_t> arenaAllocations; // del último lote
+        atomic<size_t> arenaBytes;
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase batch_packer_t.
+         * @param  numThreads  Número de hilos (0 = uno por núcleo).
+         * @param  engine      Motor de colocación de cada box_t.
+         */
+        batch_packer_t(unsigned numThreads, packingEngine_t engine) : pool(numThreads)
+        {
+            traceln(BATCH_TAG, "batch_packer_t()");
+
+            this->engine = engine;
+            this->cache = NULL;
+            this->format = ORDER_FORMAT_JSON;
+            this->useArena = false;
+            this->lastSeconds = 0.0;
+            this->lastOrders = 0;
+            this->arenaAllocations = 0;
+            this->arenaBytes = 0;
+
+            traceln(BATCH_TAG, "batch_packer_t() - END");
+
+        }   /* batch_packer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca un único pedido (se ejecuta en cualquier hilo). Si el pedido
+         *         pide caja automática y no cabe en ninguna, se llena una caja L.
+         * @param  order       El pedido a colocar.
+         * @param  engine      Motor de colocación de la box_t.
+         * @param  singleLine  Generar la orden JSON en una sola línea.
+         * @param  format      Formato de la orden.
+         * @param  result      Donde se guarda el resultado.
+         * @param  cache       Caché de resultados (o NULL).
+         * @param  arena       Memoria de la caja fija (o NULL para usar el
+         *                     heap). Se vacía con end_order() al terminar.
+         * @return void
+         */
+        static void
+        pack_order(order_t * order, packingEngine_t engine, bool singleLine, orderFormat_t format,
+                   order_result_t * result, packing_cache_t * cache = NULL,
+                   order_arena_t * arena = NULL)
+        {
+            box_t * box = NULL;
+            cached_packing_t cached;
+            string key;
+
+            if (cache != NULL)
+            {
+                key = packing_cache_t::make_key(&(order->items), order->boxType, order->autoBox,
+                                                false, engine, singleLine, format);
+
+                if (cache->lookup(key, &cached))
+                {
+                    result->mqtt_order = cached.mqtt_order;
+                    result->placedItems = cached.placedItems;
+                    result->unplacedItems = cached.unplacedItems;
+                    return;
+                }
+            }
+
+            // Las pruebas de caja se hacen en serie: el paralelismo ya está
+            // en el reparto de pedidos entre hilos.
+            if (!(order->autoBox) ||
+                !(box_selector_t::pack_in_smallest_box(&(order->items), engine, false, &box, NULL,
+                                                       (arena != NULL) ? ((pmr::memory_resource *)arena)
+                                                                       : (pmr::get_default_resource()))))
+            {
+                boxType_t boxType = (order->autoBox) ? (BOX_L) : (order->boxType);
+
+                box = new box_t(boxType, &(order->items),
+                                (arena != NULL) ? ((pmr::memory_resource *)arena)
+                                                : (pmr::get_default_resource()));
+                box->set_engine(engine);
+                box->place_items_in_box();
+            }
+
+            box->generate_mqtt_order(singleLine, format);
+
+            result->mqtt_order = box->get_mqtt_order();
+            result->placedItems = box->get_num_placed_items();
+            result->unplacedItems = box->get_num_items_to_place();
+
+            if (cache != NULL)
+            {
+                cached.mqtt_order = result->mqtt_order;
+                cached.placedItems = result->placedItems;
+                cached.unplacedItems = result->unplacedItems;
+                cache->insert(key, cached);
+            }
+
+            delete box;
+
+            if (arena != NULL)
+            {
+                arena->end_order();
+            }
+
+        }   /* pack_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece la caché de resultados de los siguientes lotes.
+         * @param  cache  La caché (o NULL para no usarla).
+         * @return void
+         */
+        void
+        set_cache(packing_cache_t * cache)
+        {
+            this->cache = cache;
+
+        }   /* set_cache() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece el formato de las órdenes de los siguientes lotes.
+         * @param  format  ORDER_FORMAT_JSON (por defecto) u ORDER_FORMAT_MSGPACK.
+         * @return void
+         */
+        void
+        set_format(orderFormat_t format)
+        {
+            this->format = format;
+
+        }   /* set_format() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Activa o desactiva la arena por pedido de los siguientes lotes.
+         * @param  enable  Verdadero para colocar cada pedido en una order_arena_t.
+         * @return void
+         */
+        void
+        set_use_arena(bool enable)
+        {
+            this->useArena = enable;
+
+        }   /* set_use_arena() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca todos los pedidos del lote repartiéndolos entre los hilos.
+         * @param  orders   Los pedidos de entrada.
+         * @param  results  Los resultados, en el mismo orden que orders.
+         * @return void
+         */
+        void
+        pack(vector<order_t> * orders, vector<order_result_t> * results)
+        {
+            traceln(BATCH_TAG, "pack()");
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+            results->clear();
+            results->resize(orders->size());
+            arenaAllocations = 0;
+            arenaBytes = 0;
+
+            for (size_t first = 0; first < orders->size(); first += BATCH_CHUNK_SIZE)
+            {
+                size_t last = std::min(first + BATCH_CHUNK_SIZE, orders->size());
+
+                pool.submit([this, orders, results, first, last]()
+                {
+                    // Cada hilo reutiliza su arena en todos los lotes.
+                    static thread_local order_arena_t arena;
+                    size_t allocations = arena.get_total_allocations();
+                    size_t bytes = arena.get_total_bytes();
+
+                    for (size_t i = first; i < last; i++)
+                    {
+                        pack_order(&((*orders)[i]), engine, false, format, &((*results)[i]), cache,
+                                   (useArena) ? (&arena) : (NULL));
+                    }
+
+                    arenaAllocations += arena.get_total_allocations() - allocations;
+                    arenaBytes += arena.get_total_bytes() - bytes;
+                });
+            }
+
+            pool.wait_idle();
+
+            lastSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            lastOrders = orders->size();
+
+            traceln(BATCH_TAG, "pack() - END");
+
+        }   /* pack() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el rendimiento del último lote.
+         * @param  void
+         * @return Pedidos colocados por segundo.
+         */
+        double
+        get_orders_per_second(void)
+        {
+            return ((lastSeconds > 0.0) ? (lastOrders / lastSeconds) : (0.0));
+
+        }   /* get_orders_per_second() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la duración del último lote.
+         * @param  void
+         * @return Segundos.
+         */
+        double
+        get_seconds(void)
+        {
+            return lastSeconds;
+
+        }   /* get_seconds() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve las reservas por pedido del último lote en la arena
+         *         (0 si no se ha usado, ver set_use_arena()).
+         * @param  void
+         * @return Reservas por pedido.
+         */
+        double
+        get_arena_allocations_per_order(void)
+        {
+            return ((lastOrders > 0) ? ((double)arenaAllocations / lastOrders) : (0.0));
+
+        }   /* get_arena_allocations_per_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve los bytes por pedido del último lote en la arena
+         *         (0 si no se ha usado, ver set_use_arena()).
+         * @param  void
+         * @return Bytes por pedido.
+         */
+        double
+        get_arena_bytes_per_order(void)
+        {
+            return ((lastOrders > 0) ? ((double)arenaBytes / lastOrders) : (0.0));
+
+        }   /* get_arena_bytes_per_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de hilos usados.
+         * @param  void
+         * @return Número de hilos.
+         */
+        size_t
+        get_num_threads(void)
+        {
+            return pool.get_num_threads();
+
+        }   /* get_num_threads() */
+};
+
+#endif /* BATCH_PACKER_T_H */
+
+/*** end of file ***/
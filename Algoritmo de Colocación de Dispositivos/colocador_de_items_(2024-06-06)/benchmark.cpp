@@ -0,0 +1,538 @@
+/**
+ * @file     benchmark.cpp
+ *
+ * @brief    Banco de pruebas del motor de colocación. Coloca pedidos sintéticos
+ *           (generados con una semilla) y los tres pedidos de ejemplo de
+ *           main.cpp, y escribe en la salida estándar un JSON con la latencia
+ *           (p50 y p99) de place_items_in_box(), update_spaceInUse(),
+ *           is_valid_space() y generate_mqtt_order(), los pedidos por segundo,
+ *           las reservas de memoria por pedido y el llenado de la caja.
+ *
+ *           Se compila como main.cpp, en un ejecutable aparte (sustituye los
+ *           operadores new y delete globales para contar las reservas):
+ *
+ *               g++ -O2 -std=c++17 -pthread benchmark.cpp -o benchmark
+ *
+ *           update_spaceInUse() e is_valid_space() se miden aparte: después de
+ *           colocar cada pedido, se vuelve a colocar en otra caja que apunta la
+ *           duración de cada llamada que hace place_items_in_box() (ver
+ *           box_t::set_call_timings()), también las de posiciones rechazadas.
+ *
+ *           Con --arena, cada caja se construye sobre una order_arena_t que se
+ *           vacía al terminar el pedido, y se informa también de las reservas
+ *           y los bytes que ha servido la arena.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del banco de pruebas
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <new>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "order_arena_t.h"
+#include "example_orders.h"
+
+using namespace std;
+
+// static const char * TAG = __FILE__;
+static const char * TAG = "benchmark.cpp";
+
+// Valores por defecto de la línea de órdenes.
+#define BENCHMARK_ORDERS  2000
+#define BENCHMARK_SEED    1
+#define BENCHMARK_WARMUP  50
+
+// Nombres de los motores, en el orden de packingEngine_t.
+#define NUM_ENGINES 6
+static const char * ENGINE_NAMES[NUM_ENGINES] = {"space-list", "height-map", "extreme-points",
+                                                 "guillotine", "maxrects", "layers"};
+
+/******************************************************************************/
+/* Contador de reservas de memoria                                           */
+/******************************************************************************/
+
+static atomic<size_t> allocations(0);
+
+// GCC confunde estos operadores, una vez integrados en los contenedores de la
+// biblioteca, con un new emparejado con free().
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void * operator new(size_t size)
+{
+	allocations.fetch_add(1, memory_order_relaxed);
+
+	void * p = malloc((size > 0) ? (size) : (1));
+	if (p == NULL)
+	{
+		throw bad_alloc();
+	}
+	return (p);
+}
+
+void * operator new[](size_t size)
+{
+	return (operator new(size));
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+	free(p);
+}
+
+// Los contenedores pmr (box_t) reservan con las versiones alineadas.
+void * operator new(size_t size, align_val_t alignment)
+{
+	allocations.fetch_add(1, memory_order_relaxed);
+
+	size_t align = std::max((size_t)alignment, sizeof(void *));
+	void * p = NULL;
+	if (posix_memalign(&p, align, (size > 0) ? (size) : (1)) != 0)
+	{
+		throw bad_alloc();
+	}
+	return (p);
+}
+
+void operator delete(void * p, align_val_t) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t, align_val_t) noexcept
+{
+	free(p);
+}
+
+/******************************************************************************/
+/* Pedidos                                                                    */
+/******************************************************************************/
+
+// Un escenario: pedidos de entre minItems y maxItems items sacados al azar de
+// pool (los identificadores repetidos salen más a menudo), o un pedido fijo
+// si minItems es 0.
+typedef struct
+{
+	const char * name;
+	boxType_t box;
+	size_t minItems;
+	size_t maxItems;
+	const char * const * pool;
+
+} scenario_t;
+
+// Pedidos pequeños para la caja S: teléfonos, fundas y algún e-reader.
+static const char * const POOL_S_HEAVY[] =
+{
+	"telefono_B_01", "telefono_B_01", "telefono_D_01", "telefono_D_01", "telefono_A_02",
+	"telefono_F_02", "telefono_C_03", "telefono_D_funda", "telefono_B_funda", "reloj_B_01",
+	"ereader_A_02", "ereader_B_funda", NULL
+};
+
+// Pedidos grandes para la caja L: sobre todo tablets y e-readers.
+static const char * const POOL_L_HEAVY[] =
+{
+	"tablet_A_01", "tablet_A_01", "tablet_A_02", "tablet_B_01", "tablet_B_02", "tablet_C_02",
+	"tablet_D_01", "tablet_A_funda", "tablet_B_funda", "tablet_D_funda", "ereader_A_01",
+	"ereader_B_01", "ereader_B_01", "ereader_A_funda", "telefono_B_01", "telefono_D_01", NULL
+};
+
+// Pedidos con muchos relojes y pulseras para la caja M.
+static const char * const POOL_WATCH_HEAVY[] =
+{
+	"reloj_B_01", "reloj_B_01", "reloj_B_02", "pulsera_B_01", "pulsera_B_01", "pulsera_B_01",
+	"reloj_B_01", "pulsera_B_01", "telefono_B_01", "telefono_D_funda", NULL
+};
+
+#define NUM_SCENARIOS 6
+static const scenario_t SCENARIOS[NUM_SCENARIOS] =
+{
+	{"s_heavy",          BOX_S, 3,  10, POOL_S_HEAVY},
+	{"l_heavy",          BOX_L, 10, 30, POOL_L_HEAVY},
+	{"watch_heavy",      BOX_M, 10, 30, POOL_WATCH_HEAVY},
+	{"ejemplo_pedido_s", BOX_S, 0,  0,  EJEMPLO_PEDIDO_S_ITEMS},
+	{"ejemplo_pedido_m", BOX_M, 0,  0,  EJEMPLO_PEDIDO_M_ITEMS},
+	{"ejemplo_pedido_l", BOX_L, 0,  0,  EJEMPLO_PEDIDO_L_ITEMS}
+};
+
+/******************************************************************************/
+/*!
+ * @brief  Genera un pedido del escenario.
+ * @param  scenario  El escenario.
+ * @param  rng       Generador (ya sembrado).
+ * @param  order     Donde se dejan los items (se vacía antes).
+ * @return void
+ */
+static void make_order(const scenario_t & scenario, mt19937_64 & rng, list<item_t> * order)
+{
+	order->clear();
+
+	size_t poolSize = 0;
+	while (scenario.pool[poolSize] != NULL)
+	{
+		poolSize++;
+	}
+
+	if (scenario.minItems == 0)
+	{
+		for (size_t i = 0; i < poolSize; i++)
+		{
+			order->push_back(item_t(scenario.pool[i]));
+		}
+		return;
+	}
+
+	size_t numItems = uniform_int_distribution<size_t>(scenario.minItems, scenario.maxItems)(rng);
+	uniform_int_distribution<size_t> pick(0, poolSize - 1);
+
+	for (size_t i = 0; i < numItems; i++)
+	{
+		order->push_back(item_t(scenario.pool[pick(rng)]));
+	}
+
+}	/* make_order() */
+
+/******************************************************************************/
+/* Medidas                                                                    */
+/******************************************************************************/
+
+// Duraciones de una función, en nanosegundos.
+typedef struct
+{
+	vector<double> samples;
+	double total;
+
+} timing_t;
+
+static inline double elapsed_ns(chrono::steady_clock::time_point start)
+{
+	return (chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+}
+
+static void add_sample(timing_t * timing, double ns)
+{
+	timing->samples.push_back(ns);
+	timing->total += ns;
+}
+
+static double percentile(vector<double> * samples, double p)
+{
+	if (samples->empty())
+	{
+		return (0.0);
+	}
+
+	size_t k = (size_t)(p * (samples->size() - 1) + 0.5);
+	nth_element(samples->begin(), samples->begin() + k, samples->end());
+	return ((*samples)[k]);
+}
+
+/******************************************************************************/
+/*!
+ * @brief  Escribe las medidas de una función como objeto JSON.
+ * @param  name    Nombre de la función.
+ * @param  timing  Sus duraciones.
+ * @param  unit    Divisor de los nanosegundos (1000 para microsegundos).
+ * @param  suffix  Sufijo de las claves ("us" o "ns").
+ * @param  last    Verdadero si es el último campo del objeto.
+ * @return void
+ */
+static void print_timing(const char * name, timing_t * timing, double unit, const char * suffix, bool last)
+{
+	size_t calls = timing->samples.size();
+
+	printf("      \"%s\": {\"calls\": %zu, \"p50_%s\": %.3f, \"p99_%s\": %.3f, \"mean_%s\": %.3f}%s\n",
+	       name, calls,
+	       suffix, percentile(&(timing->samples), 0.50) / unit,
+	       suffix, percentile(&(timing->samples), 0.99) / unit,
+	       suffix, ((calls > 0) ? (timing->total / calls / unit) : (0.0)),
+	       ((last) ? ("") : (",")));
+
+}	/* print_timing() */
+
+/******************************************************************************/
+/*!
+ * @brief  Ejecuta un escenario y escribe su objeto JSON.
+ * @param  scenario  El escenario.
+ * @param  engine    Motor de colocación.
+ * @param  orders    Número de pedidos medidos.
+ * @param  seed      Semilla de los pedidos.
+ * @param  useArena  Construir cada caja sobre una order_arena_t.
+ * @param  last      Verdadero si es el último escenario.
+ * @return void
+ */
+static void run_scenario(const scenario_t & scenario, packingEngine_t engine, size_t orders,
+                         uint64_t seed, bool useArena, bool last)
+{
+	traceln(TAG, "run_scenario()");
+
+	mt19937_64 rng(seed);
+	list<item_t> order;
+	timing_t place = {vector<double>(), 0.0};
+	timing_t update = {vector<double>(), 0.0};
+	timing_t valid = {vector<double>(), 0.0};
+	timing_t mqtt = {vector<double>(), 0.0};
+	call_timings_t calls;
+	size_t placeAllocations = 0;
+	size_t orderAllocations = 0;
+	size_t totalItems = 0;
+	size_t totalPlaced = 0;
+	size_t complete = 0;
+	double fillSum = 0.0;
+	double fillMin = 1.0;
+	size_t orderBytes = 0;
+	order_arena_t arena;
+	size_t arenaAllocations = 0;
+	size_t arenaBytes = 0;
+	pmr::memory_resource * resource = (useArena) ? ((pmr::memory_resource *)&arena)
+	                                             : (pmr::get_default_resource());
+
+	place.samples.reserve(orders);
+	mqtt.samples.reserve(orders);
+
+	for (size_t n = 0; n < (BENCHMARK_WARMUP + orders); n++)
+	{
+		bool measured = (n >= BENCHMARK_WARMUP);
+
+		// La caja del pedido anterior ya no existe: se vacía la arena.
+		arena.end_order();
+		if (n == BENCHMARK_WARMUP)
+		{
+			arenaAllocations = arena.get_total_allocations();
+			arenaBytes = arena.get_total_bytes();
+		}
+
+		make_order(scenario, rng, &order);
+		size_t numItems = order.size();
+
+		// place_items_in_box() (con la construcción de la caja, que copia
+		// el pedido, como en main.cpp).
+		size_t allocationsBefore = allocations.load(memory_order_relaxed);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		box_t box(scenario.box, &order, resource);
+		box.set_engine(engine);
+		box.place_items_in_box();
+
+		double placeNs = elapsed_ns(start);
+		size_t placeCount = allocations.load(memory_order_relaxed) - allocationsBefore;
+
+		// generate_mqtt_order().
+		allocationsBefore = allocations.load(memory_order_relaxed);
+		start = chrono::steady_clock::now();
+
+		box.generate_mqtt_order(true);
+
+		double mqttNs = elapsed_ns(start);
+		size_t mqttCount = allocations.load(memory_order_relaxed) - allocationsBefore;
+
+		if (!measured)
+		{
+			continue;
+		}
+
+		add_sample(&place, placeNs);
+		add_sample(&mqtt, mqttNs);
+		placeAllocations += placeCount;
+		orderAllocations += mqttCount;
+		orderBytes += box.get_mqtt_order().size();
+
+		double fill = box.get_fill_ratio();
+		fillSum += fill;
+		fillMin = std::min(fillMin, fill);
+		totalItems += numItems;
+		totalPlaced += box.get_num_placed_items();
+		complete += (box.get_num_items_to_place() == 0) ? (1) : (0);
+
+		// update_spaceInUse() e is_valid_space(): se vuelve a colocar el
+		// pedido midiendo cada llamada (fuera de la medida de arriba, porque
+		// leer el reloj en cada llamada la alarga).
+		calls.isValidSpace.clear();
+		calls.updateSpaceInUse.clear();
+
+		box_t timed(scenario.box, &order);
+		timed.set_engine(engine);
+		timed.set_call_timings(&calls);
+		timed.place_items_in_box();
+
+		for (size_t c = 0; c < calls.isValidSpace.size(); c++)
+		{
+			add_sample(&valid, calls.isValidSpace[c]);
+		}
+
+		for (size_t c = 0; c < calls.updateSpaceInUse.size(); c++)
+		{
+			add_sample(&update, calls.updateSpaceInUse[c]);
+		}
+	}
+
+	arena.end_order();
+	arenaAllocations = arena.get_total_allocations() - arenaAllocations;
+	arenaBytes = arena.get_total_bytes() - arenaBytes;
+
+	printf("    {\n");
+	printf("      \"name\": \"%s\",\n", scenario.name);
+	printf("      \"box\": \"%s\",\n",
+	       (scenario.box == BOX_S) ? ("S") : ((scenario.box == BOX_M) ? ("M") : ("L")));
+	printf("      \"orders\": %zu,\n", orders);
+	printf("      \"items_per_order\": %.2f,\n", (double)totalItems / orders);
+	printf("      \"placed_per_order\": %.2f,\n", (double)totalPlaced / orders);
+	printf("      \"complete_orders\": %zu,\n", complete);
+	printf("      \"orders_per_sec\": %.1f,\n", (place.total + mqtt.total > 0.0) ?
+	       (orders * 1e9 / (place.total + mqtt.total)) : (0.0));
+	printf("      \"allocs_per_order\": %.2f,\n", (double)(placeAllocations + orderAllocations) / orders);
+	printf("      \"place_allocs_per_order\": %.2f,\n", (double)placeAllocations / orders);
+	printf("      \"order_allocs_per_order\": %.2f,\n", (double)orderAllocations / orders);
+	if (useArena)
+	{
+		printf("      \"arena_allocs_per_order\": %.2f,\n", (double)arenaAllocations / orders);
+		printf("      \"arena_bytes_per_order\": %.1f,\n", (double)arenaBytes / orders);
+		printf("      \"arena_peak_bytes\": %zu,\n", arena.get_peak_bytes());
+	}
+	printf("      \"order_bytes\": %.1f,\n", (double)orderBytes / orders);
+	printf("      \"fill_ratio\": {\"mean\": %.4f, \"min\": %.4f},\n", fillSum / orders, fillMin);
+	print_timing("place_items_in_box", &place, 1000.0, "us", false);
+	print_timing("generate_mqtt_order", &mqtt, 1000.0, "us", false);
+	print_timing("update_spaceInUse", &update, 1.0, "ns", false);
+	print_timing("is_valid_space", &valid, 1.0, "ns", true);
+	printf("    }%s\n", ((last) ? ("") : (",")));
+
+	traceln(TAG, "run_scenario() - END");
+
+}	/* run_scenario() */
+
+/******************************************************************************/
+/*!
+ * @brief  Uso: benchmark [--orders N] [--seed S] [--engine MOTOR] [--scenario NOMBRE]
+ *                        [--arena]
+ *         --orders   Pedidos medidos por escenario (por defecto 2000; antes se
+ *                    colocan BENCHMARK_WARMUP sin medir).
+ *         --seed     Semilla de los pedidos sintéticos (por defecto 1). Cada
+ *                    escenario usa la misma secuencia con la misma semilla.
+ *         --engine   Motor de colocación de box_t (por defecto space-list).
+ *         --scenario Solo ejecuta ese escenario (s_heavy, l_heavy, watch_heavy,
+ *                    ejemplo_pedido_s, ejemplo_pedido_m o ejemplo_pedido_l).
+ *         --arena    Construye cada caja sobre una order_arena_t (ver
+ *                    order_arena_t.h).
+ */
+int main(int argc, char * argv[])
+{
+	size_t orders = BENCHMARK_ORDERS;
+	uint64_t seed = BENCHMARK_SEED;
+	packingEngine_t engine = ENGINE_SPACE_LIST;
+	const char * only = NULL;
+	bool useArena = false;
+
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if ((strcmp(argv[arg], "--orders") == 0) && ((arg + 1) < argc))
+		{
+			orders = strtoul(argv[++arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--seed") == 0) && ((arg + 1) < argc))
+		{
+			seed = strtoull(argv[++arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--engine") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			int e = 0;
+			while ((e < NUM_ENGINES) && (strcmp(argv[arg], ENGINE_NAMES[e]) != 0))
+			{
+				e++;
+			}
+
+			if (e == NUM_ENGINES)
+			{
+				fprintf(stderr, "Motor desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+			engine = (packingEngine_t)e;
+		}
+		else if ((strcmp(argv[arg], "--scenario") == 0) && ((arg + 1) < argc))
+		{
+			only = argv[++arg];
+		}
+		else if (strcmp(argv[arg], "--arena") == 0)
+		{
+			useArena = true;
+		}
+		else
+		{
+			fprintf(stderr, "Uso: %s [--orders N] [--seed S] [--engine MOTOR] [--scenario NOMBRE] [--arena]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (orders == 0)
+	{
+		fprintf(stderr, "--orders tiene que ser mayor que 0\n");
+		return 1;
+	}
+
+	vector<int> selected;
+	for (int s = 0; s < NUM_SCENARIOS; s++)
+	{
+		if ((only == NULL) || (strcmp(only, SCENARIOS[s].name) == 0))
+		{
+			selected.push_back(s);
+		}
+	}
+
+	if (selected.empty())
+	{
+		fprintf(stderr, "Escenario desconocido: %s\n", only);
+		return 1;
+	}
+
+	printf("{\n");
+	printf("  \"benchmark\": \"colocador_de_items\",\n");
+	printf("  \"engine\": \"%s\",\n", ENGINE_NAMES[engine]);
+	printf("  \"seed\": %llu,\n", (unsigned long long)seed);
+	printf("  \"arena\": %s,\n", (useArena) ? ("true") : ("false"));
+	printf("  \"scenarios\": [\n");
+
+	for (size_t s = 0; s < selected.size(); s++)
+	{
+		run_scenario(SCENARIOS[selected[s]], engine, orders, seed, useArena, (s + 1) == selected.size());
+		fflush(stdout);
+	}
+
+	printf("  ]\n");
+	printf("}\n");
+
+	return 0;
+}
+
+/*** end of file ***/
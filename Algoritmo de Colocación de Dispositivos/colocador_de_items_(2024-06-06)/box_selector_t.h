@@ -0,0 +1,215 @@
+/**
+ * @file     box_selector_t.h
+ *
+ * @brief    Selección automática de la caja más pequeña en la que cabe un pedido.
+ *
+ * Antes de colocar nada se descartan los tipos de caja que no pueden servir
+ * (algún item no cabe en el suelo o en la altura de la caja, o el volumen
+ * total supera el de la caja). Con los tipos restantes se hace una prueba de
+ * colocación por tipo, en paralelo, y en cuanto una caja pequeña consigue
+ * colocarlo todo se cancelan las pruebas de las cajas más grandes.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la selección de caja
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef BOX_SELECTOR_T_H
+#define BOX_SELECTOR_T_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <thread>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+
+using namespace std;
+
+// static const char * BOX_SELECTOR_TAG = __FILE__;
+static const char * BOX_SELECTOR_TAG = "box_selector_t.h";
+
+#define NUM_BOX_TYPES 3
+
+class box_selector_t
+{
+    private:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Prueba de colocación de un tipo de caja (se ejecuta en un hilo).
+         * @param  box        La caja a llenar.
+         * @param  engine     Motor de colocación.
+         * @param  cancel     Bandera de cancelación de esta prueba.
+         * @param  succeeded  Devuelve si se han colocado todos los items.
+         * @param  others     Banderas de cancelación de las pruebas más grandes.
+         * @param  numOthers  Número de elementos de others.
+         * @return void
+         */
+        static void
+        run_trial(box_t * box, packingEngine_t engine, atomic<bool> * cancel,
+                  bool * succeeded, atomic<bool> * others, int numOthers)
+        {
+            box->set_engine(engine);
+            box->set_cancel_flag(cancel);
+            box->place_items_in_box();
+
+            *succeeded = !(box->is_cancelled()) && (box->get_num_items_to_place() == 0);
+
+            // Si cabe todo, ninguna caja más grande puede ser la elegida.
+            for (int i = 0; (i < numOthers) && (*succeeded); i++)
+            {
+                others[i] = true;
+            }
+
+        }   /* run_trial() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Cota inferior barata: indica si es posible que los items quepan
+         *         en el tipo de caja. Si devuelve falso, seguro que no caben.
+         * @param  type   El tipo de caja.
+         * @param  items  Los items del pedido.
+         * @return Verdadero si la caja puede servir.
+         */
+        static bool
+        may_fit(boxType_t type, list<item_t> * items)
+        {
+            traceln(BOX_SELECTOR_TAG, "may_fit()");
+
+            space_t boxSize = box_t::size_of(type);
+            uint64_t boxVolume = (uint64_t)boxSize.max_x() * boxSize.max_y() * boxSize.max_z();
+            uint64_t itemsVolume = 0;
+            bool answer = true;
+
+            for (list<item_t>::iterator it = items->begin();
+                ((it != items->end()) && (answer == true)); ++it)
+            {
+                space_t itemSize = it->get_size();
+
+                // 1) La huella (en alguna de sus dos orientaciones) y la altura
+                //    del item tienen que caber en la caja.
+                if (((itemSize.max_x() > boxSize.max_x()) || (itemSize.max_y() > boxSize.max_y())) &&
+                    ((itemSize.max_y() > boxSize.max_x()) || (itemSize.max_x() > boxSize.max_y())))
+                {
+                    answer = false;
+                }
+
+                if (itemSize.max_z() > boxSize.max_z())
+                {
+                    answer = false;
+                }
+
+                itemsVolume += (uint64_t)itemSize.max_x() * itemSize.max_y() * itemSize.max_z();
+            }
+
+            // 2) El volumen total no puede superar el de la caja.
+            if (itemsVolume > boxVolume)
+            {
+                answer = false;
+            }
+
+            traceln(BOX_SELECTOR_TAG, "may_fit() - END");
+            return (answer);
+
+        }   /* may_fit() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca los items en la caja más pequeña en la que caben todos.
+         * @param  items     Los items del pedido.
+         * @param  engine    Motor de colocación.
+         * @param  parallel  Si es verdadero, las pruebas de S, M y L se lanzan en
+         *                   hilos a la vez; si no, se prueban de menor a mayor.
+         * @param  result    Devuelve la caja ya llena (reservada con new, la
+         *                   libera quien llama) o NULL si no cabe en ninguna.
+         * @param  deadline  Instante límite opcional para todas las pruebas.
+         * @param  resource  Memoria de las cajas de prueba. Tiene que ser
+         *                   segura entre hilos si parallel es verdadero (una
+         *                   order_arena_t solo sirve en serie).
+         * @return Verdadero si se ha encontrado una caja.
+         */
+        static bool
+        pack_in_smallest_box(list<item_t> * items, packingEngine_t engine,
+                             bool parallel, box_t ** result,
+                             const chrono::steady_clock::time_point * deadline = NULL,
+                             pmr::memory_resource * resource = pmr::get_default_resource())
+        {
+            traceln(BOX_SELECTOR_TAG, "pack_in_smallest_box()");
+
+            const boxType_t types[NUM_BOX_TYPES] = {BOX_S, BOX_M, BOX_L};
+            box_t * boxes[NUM_BOX_TYPES] = {NULL, NULL, NULL};
+            atomic<bool> cancel[NUM_BOX_TYPES];
+            bool succeeded[NUM_BOX_TYPES] = {false, false, false};
+            thread trials[NUM_BOX_TYPES];
+
+            for (int i = 0; i < NUM_BOX_TYPES; i++)
+            {
+                cancel[i] = false;
+            }
+
+            // 1) Lanzar una prueba por cada tipo que supere la cota inferior.
+            for (int i = 0; i < NUM_BOX_TYPES; i++)
+            {
+                if (!(may_fit(types[i], items)))
+                {
+                    continue;
+                }
+
+                boxes[i] = new box_t(types[i], items, resource);
+
+                if (deadline != NULL)
+                {
+                    boxes[i]->set_deadline(*deadline);
+                }
+
+                if (parallel)
+                {
+                    trials[i] = thread(run_trial, boxes[i], engine, &cancel[i], &succeeded[i],
+                                       &cancel[i + 1], NUM_BOX_TYPES - i - 1);
+                }
+                else
+                {
+                    run_trial(boxes[i], engine, &cancel[i], &succeeded[i], &cancel[i + 1], 0);
+                    if (succeeded[i])
+                    {
+                        break;
+                    }
+                }
+            }
+
+            // 2) Esperar a las pruebas y quedarse con la caja más pequeña.
+            *result = NULL;
+            for (int i = 0; i < NUM_BOX_TYPES; i++)
+            {
+                if (trials[i].joinable())
+                {
+                    trials[i].join();
+                }
+
+                if (succeeded[i] && (*result == NULL))
+                {
+                    *result = boxes[i];
+                }
+                else
+                {
+                    delete boxes[i];
+                }
+            }
+
+            traceln(BOX_SELECTOR_TAG, "pack_in_smallest_box() - END");
+            return (*result != NULL);
+
+        }   /* pack_in_smallest_box() */
+};
+
+#endif /* BOX_SELECTOR_T_H */
+
+/*** end of file ***/
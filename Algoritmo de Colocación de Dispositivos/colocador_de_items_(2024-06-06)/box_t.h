@@ -21,18 +21,45 @@
 #ifndef BOX_T_H
 #define BOX_T_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <list>
+#include <memory_resource>
 #include <string>
+#include <vector>
 #include "defines.h"
 #include "logger.h"
 #include "space_t.h"
 #include "item_t.h"
+#include "space_index_t.h"
+#include "space_soa_t.h"
+#include "height_map_t.h"
+#include "voxel_grid_t.h"
+#include "placement_validator_t.h"
+#include "undo_log_t.h"
+#include "failed_skus_t.h"
+#include "order_writer_t.h"
+#include "placement_strategy_t.h"
+#include "extreme_points_strategy_t.h"
+#include "guillotine_strategy_t.h"
+#include "maxrects_strategy_t.h"
+#include "layer_strategy_t.h"
 
 using namespace std;
 
 // static const char * BOX_TAG = __FILE__;
 static const char * BOX_TAG = "box_t.h";
 
+// Duración (ns) de cada llamada a is_valid_space() y update_spaceInUse(), en
+// el orden en que se hacen (ver box_t::set_call_timings()).
+typedef struct
+{
+    vector<double> isValidSpace;
+    vector<double> updateSpaceInUse;
+
+} call_timings_t;
+
 class box_t
 {
     private:
@@ -40,10 +67,30 @@ class box_t
         // ATRIBUTOS.
         boxType_t type;
         space_t size;
-        list<space_t> spaceInUse;
-        list<item_t> itemsToPlace;
-        list<item_t> placedItems;
-        string mqtt_order; // JSON format
+        pmr::list<space_t> spaceInUse;
+        pmr::list<item_t> itemsToPlace;
+        pmr::list<item_t> placedItems;
+        pmr::string mqtt_order; // JSON format
+        space_index_t spaceIndex; // índice espacial sobre spaceInUse
+        bool useSpaceIndex;
+        space_soa_t spaceSoa; // spaceInUse en arrays
+        bool spaceSoaStale;   // spaceSoa no sigue a spaceInUse desde rollback()
+        pmr::vector<uint8_t> spaceDominated; // auxiliares de update_spaceInUse()
+        pmr::vector<uint8_t> spaceErased;
+        voxel_grid_t occupancy; // unión de spaceInUse en vóxeles
+        bool useOccupancyGrid;
+        packingEngine_t engine;
+        bool allowRotation; // probar los items girados 90º sobre z
+        height_map_t heightMap; // solo para ENGINE_HEIGHT_MAP
+        placement_validator_t validator; // validación común de todos los motores
+        itemOrder_t itemOrder;
+        epScore_t epScore; // orden de los puntos de ENGINE_EXTREME_POINTS
+        placement_strategy_t * strategy; // estrategia externa (opcional)
+        const atomic<bool> * cancelFlag; // cancelación cooperativa (opcional)
+        call_timings_t * callTimings;    // medidas de benchmark.cpp (opcional)
+        chrono::steady_clock::time_point deadline; // límite de tiempo (opcional)
+        bool hasDeadline;
+        undo_log_t undoLog; // cambios desde el primer checkpoint()
 
     public:
 
@@ -51,42 +98,69 @@ class box_t
         /*!
          * @brief  El constructor de la clase box_t.
          * @param  type  Indica qué tipo de caja es.
-         * @param  itemsToPlaceInOrder  Lista de elementos a colocar en la caja. 
+         * @param  itemsToPlaceInOrder  Lista de elementos a colocar en la caja
+         *                              (se copia; NULL para una caja vacía).
+         * @param  resource  De donde salen las listas, los arrays auxiliares y
+         *                   la orden de la caja (por ejemplo, una order_arena_t,
+         *                   que tiene que durar más que la caja).
          */
-        box_t(boxType_t type, list<item_t> * itemsToPlaceInOrder)
+        box_t(boxType_t type, list<item_t> * itemsToPlaceInOrder,
+              pmr::memory_resource * resource = pmr::get_default_resource()) :
+            spaceInUse(resource), itemsToPlace(resource), placedItems(resource), mqtt_order(resource),
+            spaceIndex(resource), spaceSoa(resource), spaceDominated(resource), spaceErased(resource),
+            heightMap(resource), validator(resource), undoLog(resource)
         {
             traceln(BOX_TAG, "box_t()");
             this->type = type;
 
-            switch (type)
-            {
-                case BOX_S:
-                    this->size.set_space(0, 0, 0, 240, 300, 240);
-                    this->spaceInUse.push_back(space_t(0, 0, 0, 240, 300, 0));
-                    break;
-                
-                case BOX_M:
-                    this->size.set_space(0, 0, 0, 320, 300, 240);
-                    this->spaceInUse.push_back(space_t(0, 0, 0, 320, 300, 0));
-                    break;
+            // El suelo de la caja es el primer espacio en uso (de altura 0).
+            this->size = size_of(type);
+            this->spaceInUse.push_back(space_t(0, 0, 0, this->size.max_x(), this->size.max_y(), 0));
 
-                case BOX_L:
-                    this->size.set_space(0, 0, 0, 480, 300, 240);
-                    this->spaceInUse.push_back(space_t(0, 0, 0, 480, 300, 0));
-                    break;
+            if (itemsToPlaceInOrder != NULL)
+            {
+                this->itemsToPlace.assign(itemsToPlaceInOrder->begin(), itemsToPlaceInOrder->end());
+            }
+            this->mqtt_order = "";
 
-                default:
-                    break;
+            this->useSpaceIndex = USE_SPACE_INDEX;
+            this->spaceIndex.rebuild(this->spaceInUse);
+            this->spaceSoa.rebuild(this->spaceInUse);
+            this->spaceSoaStale = false;
 
-            }
+            this->useOccupancyGrid = USE_OCCUPANCY_GRID;
+            this->occupancy.reset(this->size);
 
-            this->itemsToPlace = *itemsToPlaceInOrder;
-            this->mqtt_order = "";
+            this->engine = ENGINE_SPACE_LIST;
+            this->allowRotation = ALLOW_ROTATION;
+            this->validator.reset(this->size);
+            this->itemOrder = ORDER_INPUT;
+            this->epScore = EP_SCORE_ZXY;
+            this->strategy = NULL;
+            this->cancelFlag = NULL;
+            this->callTimings = NULL;
+            this->hasDeadline = false;
 
             traceln(BOX_TAG, "box_t() - END");
 
         }   /* box_t() */
 
+        /******************************************************************************/
+        /*!
+         * @brief  Constructor que se queda con los nodos de la lista del
+         *         llamante con splice(), sin copiar ningún item (la lista queda
+         *         vacía). La caja usa el memory_resource de la lista: los nodos
+         *         solo pueden pasar entre listas del mismo.
+         * @param  type   Indica qué tipo de caja es.
+         * @param  items  Lista de elementos a colocar en la caja.
+         */
+        box_t(boxType_t type, pmr::list<item_t> && items) :
+            box_t(type, NULL, items.get_allocator().resource())
+        {
+            this->itemsToPlace.splice(this->itemsToPlace.end(), items);
+
+        }   /* box_t() */
+
         /******************************************************************************/
         /*!
          * @brief  El destructor de la clase box_t.
@@ -110,8 +184,14 @@ class box_t
         is_valid_space(space_t newSpace)
         {
             traceln(BOX_TAG, "is_valid_space()");
+            chrono::steady_clock::time_point start;
             bool answer = true;
 
+            if (callTimings != NULL)
+            {
+                start = chrono::steady_clock::now();
+            }
+
             if ((newSpace.max_x() > this->size.max_x()) ||
                 (newSpace.max_y() > this->size.max_y()) ||
                 (newSpace.max_z() > this->size.max_z()))
@@ -119,21 +199,207 @@ class box_t
                 answer = false;
             }
 
-            for (list<space_t>::iterator it = spaceInUse.begin();
-                ((it != spaceInUse.end())); ++it)
+            // Filtro rápido: si ningún vóxel de newSpace está ocupado, newSpace
+            // no puede ser subconjunto de ningún espacio en uso.
+            bool mustScan = (answer == true) &&
+                            !(useOccupancyGrid && occupancy.is_region_free(newSpace));
+
+            if (mustScan && useSpaceIndex)
+            {
+                if (spaceIndex.any_contains(newSpace))
+                {
+                    answer = false;
+                }
+            }
+            else if (mustScan)
             {
-                if (newSpace.is_subset_of(*it))
+                refresh_spaceSoa();
+                if (spaceSoa.any_contains(newSpace))
                 {
                     answer = false;
                 }
             }
 
+            if (callTimings != NULL)
+            {
+                callTimings->isValidSpace.push_back(
+                    chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+            }
+
             traceln(BOX_TAG, "is_valid_space() - END");
 
             return (answer);
 
         }   /* is_valid_space() */
 
+        /******************************************************************************/
+        /*!
+         * @brief  Activa o desactiva el índice espacial de spaceInUse. Si se
+         *         desactiva, is_valid_space() recorre la lista completa.
+         * @param  enable  Verdadero para usar el índice.
+         * @return void
+         */
+        void
+        set_use_space_index(bool enable)
+        {
+            traceln(BOX_TAG, "set_use_space_index()");
+
+            this->useSpaceIndex = enable;
+
+            if (enable)
+            {
+                spaceIndex.rebuild(spaceInUse);
+            }
+
+            traceln(BOX_TAG, "set_use_space_index() - END");
+
+        }   /* set_use_space_index() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Activa o desactiva el filtro de la rejilla de vóxeles en
+         *         is_valid_space(). La rejilla se sigue actualizando siempre.
+         * @param  enable  Verdadero para usar la rejilla.
+         * @return void
+         */
+        void
+        set_use_occupancy_grid(bool enable)
+        {
+            this->useOccupancyGrid = enable;
+
+        }   /* set_use_occupancy_grid() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Selecciona el motor de colocación que usará place_items_in_box().
+         * @param  engine  ENGINE_SPACE_LIST (por defecto) o cualquier otro packingEngine_t.
+         * @return void
+         */
+        void
+        set_engine(packingEngine_t engine)
+        {
+            this->engine = engine;
+
+        }   /* set_engine() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Selecciona la regla con la que se ordenan los items antes de
+         *         colocarlos (con cualquier motor o estrategia).
+         * @param  order  ORDER_INPUT (por defecto) o una de las ordenaciones.
+         * @return void
+         */
+        void
+        set_item_order(itemOrder_t order)
+        {
+            this->itemOrder = order;
+
+        }   /* set_item_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Selecciona el orden en que ENGINE_EXTREME_POINTS prueba los
+         *         puntos candidatos (ver extreme_points_strategy_t).
+         * @param  score  EP_SCORE_ZXY (por defecto) o cualquier otro epScore_t.
+         * @return void
+         */
+        void
+        set_ep_score(epScore_t score)
+        {
+            this->epScore = score;
+
+        }   /* set_ep_score() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece una estrategia de colocación externa, que sustituye
+         *         al motor seleccionado con set_engine(). La estrategia no pasa
+         *         a ser propiedad de la caja.
+         * @param  strategy  La estrategia (NULL para volver al motor).
+         * @return void
+         */
+        void
+        set_strategy(placement_strategy_t * strategy)
+        {
+            this->strategy = strategy;
+
+        }   /* set_strategy() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Permite o no colocar los items girados 90º sobre el eje z. Cada
+         *         item se prueba primero en su orientación original.
+         * @param  enable  Verdadero para permitir el giro.
+         * @return void
+         */
+        void
+        set_allow_rotation(bool enable)
+        {
+            this->allowRotation = enable;
+
+        }   /* set_allow_rotation() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece una bandera de cancelación. Si otro hilo la pone a
+         *         verdadero, place_items_in_box() termina en la siguiente iteración
+         *         dejando los items restantes en itemsToPlace.
+         * @param  cancel  Puntero a la bandera (NULL para no usar cancelación).
+         * @return void
+         */
+        void
+        set_cancel_flag(const atomic<bool> * cancel)
+        {
+            this->cancelFlag = cancel;
+
+        }   /* set_cancel_flag() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece donde se apunta la duración de cada llamada a
+         *         is_valid_space() y update_spaceInUse(), incluidas las que hace
+         *         place_items_in_box(). Medir cuesta dos lecturas del reloj por
+         *         llamada y puede reservar memoria.
+         * @param  timings  Las medidas (NULL para no medir).
+         * @return void
+         */
+        void
+        set_call_timings(call_timings_t * timings)
+        {
+            this->callTimings = timings;
+
+        }   /* set_call_timings() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece un instante límite. Al superarse, place_items_in_box()
+         *         termina igual que si se hubiera cancelado.
+         * @param  limit  El instante límite.
+         * @return void
+         */
+        void
+        set_deadline(chrono::steady_clock::time_point limit)
+        {
+            this->deadline = limit;
+            this->hasDeadline = true;
+
+        }   /* set_deadline() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si se ha pedido cancelar la colocación o si se ha
+         *         superado el instante límite.
+         * @param  void
+         * @return Verdadero o falso.
+         */
+        bool
+        is_cancelled(void)
+        {
+            return (((cancelFlag != NULL) && (cancelFlag->load(memory_order_relaxed))) ||
+                    (hasDeadline && (chrono::steady_clock::now() >= deadline)));
+
+        }   /* is_cancelled() */
+
         /******************************************************************************/
         /*!
          * @brief  Encuentra un nuevo punto donde se colocará el siguiente elemento.
@@ -153,27 +419,8 @@ class box_t
             newPoint.z = this->size.max_z();
 
             // 2) Calculate the intersection point betwen all spaceInUses.
-            for (list<space_t>::iterator it = spaceInUse.begin();
-                ((it != spaceInUse.end())); ++it)
-            {
-                // Calculate the x.
-                if (it->max_x() < newPoint.x)
-                {
-                    newPoint.x = it->max_x();
-                }    
-
-                // Calculate the y.
-                if (it->max_y() < newPoint.y)
-                {
-                    newPoint.y = it->max_y();
-                } 
-
-                // Calculate the z.
-                if (it->max_z() < newPoint.z)
-                {
-                    newPoint.z = it->max_z();
-                } 
-            }
+            refresh_spaceSoa();
+            newPoint = spaceSoa.min_of_max(newPoint);
 
             // 3) If any coordinate is on the limit of the box, it is set to 0.
             if (newPoint.x == this->size.max_x())
@@ -194,7 +441,7 @@ class box_t
                         newPoint.x + 1, newPoint.y + 1, newPoint.z + 1);
 
             #if 0
-            for (list<space_t>::iterator it = spaceInUse.begin();
+            for (pmr::list<space_t>::iterator it = spaceInUse.begin();
                 ((it != spaceInUse.end())); ++it)
             {
                 if (aux.is_subset_of(* it))
@@ -217,6 +464,57 @@ class box_t
         
         }   /* search_newOriginPoint() */
 
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve a copiar spaceInUse en spaceSoa si rollback() la ha
+         *         dejado atrás.
+         * @param  void
+         * @return void
+         */
+        void
+        refresh_spaceSoa(void)
+        {
+            if (spaceSoaStale)
+            {
+                spaceSoa.rebuild(spaceInUse);
+                spaceSoaStale = false;
+            }
+
+        }   /* refresh_spaceSoa() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade un espacio de spaceInUse al índice espacial, si se usa.
+         * @param  space  El espacio añadido (o con su nuevo valor).
+         * @return void
+         */
+        void
+        index_insert(space_t space)
+        {
+            if (useSpaceIndex)
+            {
+                spaceIndex.insert(space);
+            }
+
+        }   /* index_insert() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Quita un espacio de spaceInUse del índice espacial, si se usa.
+         *         Se llama antes de borrarlo o modificarlo.
+         * @param  space  El espacio (con su valor actual).
+         * @return void
+         */
+        void
+        index_remove(space_t space)
+        {
+            if (useSpaceIndex)
+            {
+                spaceIndex.remove(space);
+            }
+
+        }   /* index_remove() */
+
         /******************************************************************************/
         /*!
          * @brief  Busca posibles uniones de volumen que puedan existir entre el aux
@@ -229,7 +527,7 @@ class box_t
          * @return void 
          */
         void
-        search_possible_unions(space_t * aux, list<space_t>::iterator * it,
+        search_possible_unions(space_t * aux, pmr::list<space_t>::iterator * it,
                                bool * needsToBeAdded)
         {
             traceln(BOX_TAG, "search_possible_unions()");
@@ -250,7 +548,8 @@ class box_t
                                    aux->max_x(), aux->max_y(), aux->max_z());
 
                     // Borrar el contenido de it y modificar el puntero it al siguiente iterador.
-                    (*it) = spaceInUse.erase((*it));
+                    index_remove(**it);
+                    (*it) = undoLog.erase_space(&spaceInUse, (*it));
                     (*needsToBeAdded) = true;
                 }
                 // DIFERENCIAS POSITIVAS EN EL EJE (Y O Z) O (Y Y Z). (IT ES SUPERIOR).
@@ -270,8 +569,12 @@ class box_t
                 else if (((*it)->max_y() <= aux->max_y()) && ((*it)->max_z() <= aux->max_z()))
                 {
                     // Añadir aux sin modificar y modificar el max de it.
+                    undoLog.before_set_space(*it);
+                    index_remove(**it);
                     (*it)->set_space((*it)->min_x(), (*it)->min_y(), (*it)->min_z(),
                                       aux->max_x(), (*it)->max_y(), (*it)->max_z());
+                    undoLog.set_region(&occupancy, **it);
+                    index_insert(**it);
 
                     // Modificar el puntero it al siguiente iterador.
                     ++(*it);
@@ -300,7 +603,8 @@ class box_t
                                    (*it)->max_x(), aux->max_y(), aux->max_z());
 
                     // Borrar el contenido de it y modificar el puntero it al siguiente iterador.
-                    (*it) = spaceInUse.erase((*it));
+                    index_remove(**it);
+                    (*it) = undoLog.erase_space(&spaceInUse, (*it));
                     (*needsToBeAdded) = true;
                 }
                 // DIFERENCIAS POSITIVAS EN EL EJE (Y O Z) O (Y Y Z). (IT ES SUPERIOR).
@@ -320,8 +624,12 @@ class box_t
                 else if (((*it)->max_y() <= aux->max_y()) && ((*it)->max_z() <= aux->max_z()))
                 {
                     // Añadir aux sin modificar y modificar el min de it.
+                    undoLog.before_set_space(*it);
+                    index_remove(**it);
                     (*it)->set_space(aux->min_x(), aux->min_y(), aux->min_z(),
                                       (*it)->max_x(), (*it)->max_y(), (*it)->max_z());
+                    undoLog.set_region(&occupancy, **it);
+                    index_insert(**it);
 
                     // Modificar el puntero it al siguiente iterador.
                     ++(*it);
@@ -348,7 +656,8 @@ class box_t
                     aux->set_space((*it)->min_x(), (*it)->min_y(), (*it)->min_z(),
                                    aux->max_x(), aux->max_y(), aux->max_z());
                     // Borrar el contenido de it y modificar el puntero it al siguiente iterador.
-                    (*it) = spaceInUse.erase((* it));
+                    index_remove(**it);
+                    (*it) = undoLog.erase_space(&spaceInUse, (*it));
                     (*needsToBeAdded) = true;
                 }
                 /// DIFERENCIAS POSITIVAS EN EL EJE (X O Z) O (X Y Z). (IT ES SUPERIOR)
@@ -366,8 +675,12 @@ class box_t
                 else if (((*it)->max_x() <= aux->max_x()) && ((*it)->max_z() <= aux->max_z()))
                 {
                     // Añadir aux sin modificar y modificar el max de it.
+                    undoLog.before_set_space(*it);
+                    index_remove(**it);
                     (*it)->set_space((*it)->min_x(), (*it)->min_y(), (*it)->min_z(),
                                       (*it)->max_x(), aux->max_y(), (*it)->max_z());
+                    undoLog.set_region(&occupancy, **it);
+                    index_insert(**it);
 
                     // Modificar el puntero it al siguiente iterador.
                     ++(*it);
@@ -396,7 +709,8 @@ class box_t
                                    aux->max_x(), (*it)->max_y(), aux->max_z());
 
                     // Borrar el contenido de it y modificar el puntero it al siguiente iterador.
-                    (*it) = spaceInUse.erase((*it));
+                    index_remove(**it);
+                    (*it) = undoLog.erase_space(&spaceInUse, (*it));
                     (*needsToBeAdded) = true;
                 }
                 // DIFERENCIAS POSITIVAS EN EL EJE (X O Z) O (X Y Z). (IT ES SUPERIOR).
@@ -416,8 +730,12 @@ class box_t
                 else if (((*it)->max_x() <= aux->max_x()) && ((*it)->max_z() <= aux->max_z()))
                 {
                     // Añadir aux sin modificar y modificar el min de it.
+                    undoLog.before_set_space(*it);
+                    index_remove(**it);
                     (*it)->set_space(aux->min_x(), aux->min_y(), aux->min_z(),
                                       (*it)->max_x(), (*it)->max_y(), (*it)->max_z());
+                    undoLog.set_region(&occupancy, **it);
+                    index_insert(**it);
 
                     // Modificar el puntero it al siguiente iterador.
                     ++(*it);
@@ -455,95 +773,212 @@ class box_t
         update_spaceInUse(space_t toAdd)
         { 
             traceln(BOX_TAG, "update_spaceInUse()");
+            chrono::steady_clock::time_point start;
+
+            if (callTimings != NULL)
+            {
+                start = chrono::steady_clock::now();
+            }
 
             space_t aux(toAdd.min_x(), toAdd.min_y(), 0, toAdd.max_x(), toAdd.max_y(), toAdd.max_z());
             bool needsToBeAdded = false;
-            string info;
             
             #if 0
-            info = "spaceInUse (before): ";
-            for (list<space_t>::iterator it = spaceInUse.begin();
-                (it != spaceInUse.end()); ++it)
+            if (LOG_ENABLED(DEBUG))
             {
-                info += it->space_to_str() + " & ";
+                for (pmr::list<space_t>::iterator it = spaceInUse.begin();
+                    (it != spaceInUse.end()); ++it)
+                {
+                    debugf(BOX_TAG, "spaceInUse (before): [(%d, %d, %d)(%d, %d, %d)]",
+                           it->min_x(), it->min_y(), it->min_z(), it->max_x(), it->max_y(), it->max_z());
+                }
             }
-            debugln(BOX_TAG, info.c_str());
             #endif            
             
             #if 1
             /////////////////////////////////////////////////////////
             // Mira las posibles uniones space_t que se pueden hacer.
-            for (list<space_t>::iterator it2 = spaceInUse.begin(); (it2 != spaceInUse.end());
+            for (pmr::list<space_t>::iterator it2 = spaceInUse.begin(); (it2 != spaceInUse.end());
             /* Los incrementos de it2 se realizan en la función search_possible_unions(). */)
             {
                 search_possible_unions(&aux, &it2, &needsToBeAdded);  
             }
 
-            spaceInUse.push_front(aux); // Inserta aux al principio de la lista.
+            undoLog.push_front_space(&spaceInUse, aux); // Inserta aux al principio de la lista.
+            undoLog.set_region(&occupancy, aux);
+            index_insert(aux);
             #endif 
 
-            #if 1
-            info = "spaceInUse (before): ";
-            for (list<space_t>::iterator it = spaceInUse.begin();
-                (it != spaceInUse.end()); ++it)
+            // Los argumentos de debugf() no se evalúan si DEBUG no está activo.
+            if (LOG_ENABLED(DEBUG))
             {
-                info += it->space_to_str() + " & ";
+                for (pmr::list<space_t>::iterator it = spaceInUse.begin();
+                    (it != spaceInUse.end()); ++it)
+                {
+                    debugf(BOX_TAG, "spaceInUse (before): [(%d, %d, %d)(%d, %d, %d)]",
+                           it->min_x(), it->min_y(), it->min_z(), it->max_x(), it->max_y(), it->max_z());
+                }
             }
-            debugln(BOX_TAG, info.c_str());
-            #endif 
 
             ////////////////////////////////////////////////////////////////////
             // Si algún espacio de la lista se compone de otros espacios de la
             // misma lista, los subconjuntos se eliminan de la lista spaceInUse.
-            for (list<space_t>::iterator it1 = spaceInUse.begin();
-                 it1 != spaceInUse.end(); ++it1)
+            // Se recorren en orden y cada espacio que sigue en la lista borra
+            // a todos los que contiene (dominated_by() los marca de una vez).
+            spaceSoa.rebuild(spaceInUse);
+            spaceSoaStale = false;
+            spaceDominated.resize(spaceSoa.size());
+            spaceErased.assign(spaceSoa.size(), 0);
+
+            for (size_t i = 0; i < spaceSoa.size(); i++)
             {
-                list<space_t>::iterator it2 = it1;
-                ++it2;
-                if (it2 == spaceInUse.end())
+                if ((spaceErased[i] != 0) ||
+                    (spaceSoa.dominated_by(*(spaceSoa.node(i)), spaceDominated.data()) <= 1))
                 {
-                    it2 = spaceInUse.begin();
+                    continue; // borrado o solo se contiene a sí mismo
                 }
 
-                while (it2 != it1)
+                for (size_t j = 0; j < spaceSoa.size(); j++)
                 {
-
-                    if(it1->is_made_up_of(*it2))
-                    {
-                        it2 = spaceInUse.erase(it2);
-                    }
-                    else
+                    if ((j != i) && (spaceDominated[j] != 0) && (spaceErased[j] == 0))
                     {
-                        ++it2;
-                    }
-                    
-                    if (it2 == spaceInUse.end())
-                    {
-                        it2 = spaceInUse.begin();
+                        index_remove(*(spaceSoa.node(j)));
+                        undoLog.erase_space(&spaceInUse, spaceSoa.node(j));
+                        spaceErased[j] = 1;
                     }
                 }
             }
 
-            #if 1
-            info = "spaceInUse (after):  ";
-            for (list<space_t>::iterator it = spaceInUse.begin();
-                (it != spaceInUse.end()); ++it)
+            if (LOG_ENABLED(DEBUG))
             {
-                info += it->space_to_str() + " & ";
+                for (pmr::list<space_t>::iterator it = spaceInUse.begin();
+                    (it != spaceInUse.end()); ++it)
+                {
+                    debugf(BOX_TAG, "spaceInUse (after):  [(%d, %d, %d)(%d, %d, %d)]",
+                           it->min_x(), it->min_y(), it->min_z(), it->max_x(), it->max_y(), it->max_z());
+                }
+            }
+
+            // El índice espacial ya se ha actualizado cambio a cambio; a la
+            // copia en arrays solo le sobran los espacios borrados.
+            spaceSoa.remove_marked(spaceErased.data());
+
+            if (callTimings != NULL)
+            {
+                callTimings->updateSpaceInUse.push_back(
+                    chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
             }
-            info += "\n";
-            debugln(BOX_TAG, info.c_str());
-            #endif
 
             traceln(BOX_TAG, "update_spaceInUse() - END");
 
         }   /* update_spaceInUse() */
 
+        /******************************************************************************/
+        /*!
+         * @brief  Ejecuta una estrategia de colocación sobre la caja.
+         * @param  placer  La estrategia.
+         * @return void
+         */
+        void
+        run_strategy(placement_strategy_t * placer)
+        {
+            traceln(BOX_TAG, "run_strategy()");
+
+            placement_job_t job;
+
+            job.boxSize = this->size;
+            job.itemsToPlace = &itemsToPlace;
+            job.placedItems = &placedItems;
+            job.validator = &validator;
+            job.allowRotation = allowRotation;
+            job.undoLog = &undoLog;
+            job.isCancelled = [this]() { return is_cancelled(); };
+
+            placer->place(&job);
+
+            traceln(BOX_TAG, "run_strategy() - END");
+
+        }   /* run_strategy() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Siguientes orígenes del motor ENGINE_SPACE_LIST, cuando en el
+         *         de search_newOriginPoint() no cabe nada: prueba los items de
+         *         itemsToPlace en las esquinas de los items colocados (y en el
+         *         origen de la caja), de la más baja a la más alta, y coloca el
+         *         primero que tenga una posición válida.
+         * @param  number  Número del item para la traza.
+         * @return Verdadero si se ha colocado algún item.
+         */
+        bool
+        place_at_corner(int number)
+        {
+            traceln(BOX_TAG, "place_at_corner()");
+
+            const pmr::vector<space_t> & placed = validator.get_placed();
+            pmr::vector<point_t> corners(spaceErased.get_allocator());
+            point_t origin = {0, 0, 0};
+
+            corners.push_back(origin);
+            for (size_t p = 0; p < placed.size(); p++)
+            {
+                space_t s = placed[p];
+                point_t right = {s.max_x(), s.min_y(), s.min_z()};
+                point_t front = {s.min_x(), s.max_y(), s.min_z()};
+                point_t top = {s.min_x(), s.min_y(), s.max_z()};
+
+                corners.push_back(right);
+                corners.push_back(front);
+                corners.push_back(top);
+            }
+            stable_sort(corners.begin(), corners.end(), height_map_t::is_better_position);
+
+            for (size_t c = 0; c < corners.size(); c++)
+            {
+                failed_skus_t failed;
+
+                for (pmr::list<item_t>::iterator it = itemsToPlace.begin(); (it != itemsToPlace.end()); ++it)
+                {
+                    if (failed.contains(it->get_sku()))
+                    {
+                        continue;
+                    }
+
+                    for (int r = 0; r < (((allowRotation) && it->can_rotate()) ? (2) : (1)); r++)
+                    {
+                        space_t placeSpace = ((r == 1) ? (it->get_rotated_size()) : (it->get_size())) + corners[c];
+
+                        if (is_valid_space(placeSpace) && validator.is_valid(placeSpace))
+                        {
+                            it->set_posInBox(placeSpace);
+                            it->set_rotated(r == 1);
+                            undoLog.validator_add(&validator, placeSpace);
+                            infof(BOX_TAG, "item_%d: [(%d, %d, %d)(%d, %d, %d)]", number,
+                                  placeSpace.min_x(), placeSpace.min_y(), placeSpace.min_z(),
+                                  placeSpace.max_x(), placeSpace.max_y(), placeSpace.max_z());
+                            update_spaceInUse(placeSpace);
+                            undoLog.place_item(&itemsToPlace, &placedItems, it);
+
+                            traceln(BOX_TAG, "place_at_corner() - END");
+                            return (true);
+                        }
+                    }
+
+                    failed.add(it->get_sku());
+                }
+            }
+
+            traceln(BOX_TAG, "place_at_corner() - END");
+            return (false);
+
+        }   /* place_at_corner() */
+
         /******************************************************************************/
         /*!
          * @brief  Coloca todos los elementos de itemsToPlace dentro de la caja y
          *         actualiza la lista placedItems. También establece targetPlace
-         *         de todos los elementos.
+         *         de todos los elementos. Si algún elemento no cabe, se queda
+         *         en itemsToPlace (ver get_num_items_to_place()).
          * @param  void
          * @return void
          */
@@ -552,51 +987,127 @@ class box_t
         {
             traceln(BOX_TAG, "place_items_in_box()");
 
+            placement_strategy_t::sort_items(&itemsToPlace, itemOrder);
+
+            if ((strategy != NULL) || (engine != ENGINE_SPACE_LIST))
+            {
+                if (strategy != NULL)
+                {
+                    run_strategy(strategy);
+                }
+                else if (engine == ENGINE_HEIGHT_MAP)
+                {
+                    place_items_in_height_map();
+                }
+                else if (engine == ENGINE_EXTREME_POINTS)
+                {
+                    extreme_points_strategy_t placer(epScore);
+                    run_strategy(&placer);
+                }
+                else if (engine == ENGINE_GUILLOTINE)
+                {
+                    guillotine_strategy_t placer;
+                    run_strategy(&placer);
+                }
+                else if (engine == ENGINE_MAXRECTS)
+                {
+                    maxrects_strategy_t placer;
+                    run_strategy(&placer);
+                }
+                else // (engine == ENGINE_LAYERS)
+                {
+                    layer_strategy_t placer;
+                    run_strategy(&placer);
+                }
+
+                traceln(BOX_TAG, "place_items_in_box() - END");
+                return;
+            }
+
             point_t newOriginPoint;
             space_t newPlaceSpace;
             int i = 0;
             bool exitFor = false;
-            string info;
+            bool stuck = false;
+            bool valid, rotated;
+            failed_skus_t failed; // SKUs que no caben en newOriginPoint
 
-            // 1) Intenta colocar un elemento mientras itemsToPlace no está vacío.
-            while (!(itemsToPlace.empty()))
+            // 1) Intenta colocar un elemento mientras itemsToPlace no está vacío
+            //    y el estado de la caja siga cambiando.
+            while (!(itemsToPlace.empty()) && (stuck == false) && !(is_cancelled()))
             {  
                 // 2) Busca un nuevo punto de origen.
                 newOriginPoint = search_newOriginPoint();
 
                 // 3) Obtiene el primer elemento de la lista itemsToPlace.
                 exitFor = false;
-                list<item_t>::iterator it;
-                for (it = itemsToPlace.begin();
-                    ((it != itemsToPlace.end()) && (exitFor == false)); ++it)
+                failed.clear();
+                pmr::list<item_t>::iterator it = itemsToPlace.begin();
+                while ((it != itemsToPlace.end()) && (exitFor == false))
                 {
+                    // Si otra copia del mismo SKU no ha cabido, esta tampoco.
+                    if (failed.contains(it->get_sku()))
+                    {
+                        ++it;
+                        continue;
+                    }
+
                     newPlaceSpace = it->get_size() + newOriginPoint;
+                    valid = is_valid_space(newPlaceSpace) && validator.is_valid(newPlaceSpace);
+                    rotated = false;
+
+                    // 3.1) Si no encaja en su orientación original, se prueba
+                    //      girado 90º sobre z.
+                    if ((valid == false) && allowRotation && it->can_rotate())
+                    {
+                        newPlaceSpace = it->get_rotated_size() + newOriginPoint;
+                        valid = is_valid_space(newPlaceSpace) && validator.is_valid(newPlaceSpace);
+                        rotated = true;
+                    }
 
-                    // 3.1) Intenta colocar el elemento; si no encaja, intenta
+                    // 3.2) Intenta colocar el elemento; si no encaja, intenta
                     //      con el siguiente elemento de la lista itemsToPlace.  
-                    if (is_valid_space(newPlaceSpace))
+                    if (valid)
                     {
-                        // 3.1.1) Insertar elemento en la lista placedItems.
+                        // 3.2.1) Registrar la posición del elemento.
                         it->set_posInBox(newPlaceSpace);
-                        placedItems.push_back(*it);
-                        info = "item_" + to_string(i) + ": ";
-                        info += it->get_posInBox().space_to_str();
-                        infoln(BOX_TAG, info.c_str());
+                        it->set_rotated(rotated);
+                        undoLog.validator_add(&validator, newPlaceSpace);
+                        infof(BOX_TAG, "item_%d: [(%d, %d, %d)(%d, %d, %d)]", i,
+                              newPlaceSpace.min_x(), newPlaceSpace.min_y(), newPlaceSpace.min_z(),
+                              newPlaceSpace.max_x(), newPlaceSpace.max_y(), newPlaceSpace.max_z());
                         i++;
 
-                        // 3.1.2) Actualizar lista spaceInUse.
+                        // 3.2.2) Actualizar lista spaceInUse.
                         update_spaceInUse(it->get_posInBox());
 
-                        // 3.1.3) Borrar el elemento de la lista itemsToPlace. 
-                        itemsToPlace.erase(it);
+                        // 3.2.3) Pasar el elemento de itemsToPlace a placedItems.
+                        it = undoLog.place_item(&itemsToPlace, &placedItems, it);
 
-                        // 3.1.4) Salir del bucle for. 
+                        // 3.2.4) Salir del bucle. 
                         exitFor = true;
                     }
+                    else
+                    {
+                        failed.add(it->get_sku());
+                        ++it;
+                    }
+                }
+
+                // 4) Si ningún it encaja, pasar a los siguientes orígenes. El
+                //    validador puede rechazar el origen (el item se solaparía
+                //    con uno colocado o le faltaría apoyo) aunque spaceInUse lo
+                //    dé por libre; el relleno con vacío de 5) no siempre lo
+                //    cubre y la búsqueda terminaría con la caja casi vacía.
+                if ((exitFor == false) && place_at_corner(i))
+                {
+                    i++;
+                    exitFor = true;
                 }
 
                 #if 1
-                // 4) Si ningún it encaja, llenar el espacio con vacío.
+                // 5) Si tampoco encaja en ningún otro origen, llenar el espacio
+                //    con vacío.
                 if (exitFor == false)
                 {
                     point_t newEndPoint;
@@ -608,7 +1119,7 @@ class box_t
                     newEndPoint.y = this->size.max_y();
                     newEndPoint.z = newOriginPoint.z;
 
-                    for (list<space_t>::iterator it = spaceInUse.begin();
+                    for (pmr::list<space_t>::iterator it = spaceInUse.begin();
                          (it != spaceInUse.end()); ++it)
                     {
                         if ((it->min_x() > newOriginPoint.x) &&
@@ -631,8 +1142,19 @@ class box_t
                     }
 
                     // 2) Actualizar lista spaceInUse.
+                    pmr::list<space_t> before(spaceInUse, spaceInUse.get_allocator());
+
                     update_spaceInUse(space_t(newOriginPoint.x, newOriginPoint.y, newOriginPoint.z,
                                               newEndPoint.x, newEndPoint.y, newEndPoint.z));
+
+                    // 3) Si spaceInUse no ha cambiado, la siguiente iteración sería
+                    //    idéntica a esta: los items restantes no caben en la caja.
+                    stuck = (before.size() == spaceInUse.size());
+                    for (pmr::list<space_t>::iterator it1 = before.begin(), it2 = spaceInUse.begin();
+                        ((it1 != before.end()) && (stuck == true)); ++it1, ++it2)
+                    {
+                        stuck = !(*it1 != *it2);
+                    }
                 }
                 #endif
             }
@@ -643,91 +1165,388 @@ class box_t
 
         /******************************************************************************/
         /*!
-         * @brief  Este método calcula las poses de TCP para todos los elementos
-         *         para que puedan colocarse correctamente en el simulador RoboDK.
+         * @brief  Motor ENGINE_HEIGHT_MAP. En cada iteración coloca el primer item
+         *         de itemsToPlace que tenga una posición válida en el mapa de
+         *         alturas. Los items que no caben se quedan en itemsToPlace.
          * @param  void
          * @return void
          */
         void
-        calculate_TCP_poses(void)
+        place_items_in_height_map(void)
         {
-            traceln(BOX_TAG, "calculate_TCP_poses()");
+            traceln(BOX_TAG, "place_items_in_height_map()");
 
-            uint16_t x, y, z;
-            int16_t w; // r = -180, p = 0
-            uint8_t y_decimal;
+            point_t origin = {0, 0, 0}, rotatedOrigin;
+            space_t placeSpace;
+            bool placed = true, found, rotated;
+            failed_skus_t failed; // SKUs sin posición en el mapa actual
 
-            for (list<item_t>::iterator it = placedItems.begin();
-                (it != placedItems.end()); ++it)
+            // El mapa parte de los items que ya hubiera en la caja.
+            heightMap.reset(this->size);
+            for (size_t i = 0; i < validator.get_placed().size(); i++)
             {
-                x = (it->get_posInBox().min_x()) + (((it->get_posInBox().max_x()) - (it->get_posInBox().min_x())) / 2);
-                y = (it->get_posInBox().min_y()) + (((it->get_posInBox().max_y()) - (it->get_posInBox().min_y())) / 2);
-                z = (it->get_posInBox().max_z());
+                heightMap.place(validator.get_placed()[i]);
+            }
 
-                itemType_t it_type = it->get_type();
+            // 1) Repetir mientras se consiga colocar algún item.
+            while (placed && !(itemsToPlace.empty()) && !(is_cancelled()))
+            {
+                placed = false;
+                failed.clear();
 
-                if (((size.max_y()) - y) <= (y - (size.min_y())))
+                // 2) Buscar el primer item que quepa en el mapa de alturas.
+                pmr::list<item_t>::iterator it = itemsToPlace.begin();
+                while ((it != itemsToPlace.end()) && (placed == false))
                 {
-                    if ((it_type == RELOJ) || (it_type == PULSERA))
-                    {
-                        y = y - 72; // serían en verdad (-72.5)
-                        w = -90;
-                    }
-                    else if ((it_type == TELEFONO) || (it_type == FUNDA_TELEFONO) ||
-                             (it_type == EREADER)  || (it_type == FUNDA_EREADER))
+                    if (failed.contains(it->get_sku()))
                     {
-                        y = y - 35;
-                        w = -90;
+                        ++it;
+                        continue;
                     }
-                    else // ((it_type == TABLET) || (it_type == FUNDA_TABLET))
-                    {
-                        w = 0;
-                    }
-                }
-                else
-                {
-                    if ((it_type == RELOJ) || (it_type == PULSERA))
+
+                    found = heightMap.find_position(it->get_size(), &origin);
+                    rotated = false;
+
+                    // 2.1) Si está permitido, quedarse con la mejor de las dos
+                    //      orientaciones (a igualdad, la original).
+                    if (allowRotation && it->can_rotate() &&
+                        heightMap.find_position(it->get_rotated_size(), &rotatedOrigin) &&
+                        ((found == false) || height_map_t::is_better_position(rotatedOrigin, origin)))
                     {
-                        y = y + 72; // serían en verdad (72.5)
-                        w = 90;
+                        origin = rotatedOrigin;
+                        found = true;
+                        rotated = true;
                     }
-                    else if ((it_type == TELEFONO) || (it_type == FUNDA_TELEFONO) ||
-                             (it_type == EREADER)  || (it_type == FUNDA_EREADER))
+
+                    placeSpace = ((rotated) ? (it->get_rotated_size()) : (it->get_size())) + origin;
+
+                    if (found && validator.is_valid(placeSpace))
                     {
-                        y = y + 35;
-                        w = 90;
+                        // 2.2) Registrar la posición del item y actualizar el mapa.
+                        it->set_posInBox(placeSpace);
+                        it->set_rotated(rotated);
+                        undoLog.validator_add(&validator, placeSpace);
+                        heightMap.place(it->get_posInBox());
+
+                        // 2.3) Pasar el item de itemsToPlace a placedItems.
+                        it = undoLog.place_item(&itemsToPlace, &placedItems, it);
+                        placed = true;
                     }
-                    else // ((it_type == TABLET) || (it_type == FUNDA_TABLET))
+                    else
                     {
-                        w = 180;
+                        failed.add(it->get_sku());
+                        ++it;
                     }
                 }
-                
-                y_decimal = ((it->get_type() == RELOJ) || (it->get_type() == PULSERA)) ? (5) : (0);
+            }
+
+            traceln(BOX_TAG, "place_items_in_height_map() - END");
+
+        }   /* place_items_in_height_map() */
 
-                it->set_target_str(to_string(x) + ".0, " + to_string(y) + "." + to_string(y_decimal) + ", " + to_string(z) + ".0, -180.0, 0.0, " + to_string(w) + ".0");
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca un item concreto en una posición concreta, si es válida.
+         *         Pensado para búsquedas que prueban colocaciones y las deshacen
+         *         con checkpoint() y rollback().
+         * @param  index    Posición del item en itemsToPlace.
+         * @param  origin   Esquina mínima del item dentro de la caja.
+         * @param  rotated  Verdadero para colocarlo girado 90º sobre z.
+         * @return Verdadero si se ha colocado.
+         */
+        bool
+        place_item_at(size_t index, point_t origin, bool rotated)
+        {
+            traceln(BOX_TAG, "place_item_at()");
+
+            if (index >= itemsToPlace.size())
+            {
+                traceln(BOX_TAG, "place_item_at() - END");
+                return (false);
             }
 
-            traceln(BOX_TAG, "calculate_TCP_poses() - END");
+            pmr::list<item_t>::iterator it = std::next(itemsToPlace.begin(), index);
+            space_t placeSpace = ((rotated) ? (it->get_rotated_size()) : (it->get_size())) + origin;
 
-        }   /* calculate_TCP_poses() */
+            if ((rotated && !(it->can_rotate())) || !(validator.is_valid(placeSpace)))
+            {
+                traceln(BOX_TAG, "place_item_at() - END");
+                return (false);
+            }
+
+            it->set_posInBox(placeSpace);
+            it->set_rotated(rotated);
+            undoLog.validator_add(&validator, placeSpace);
+            update_spaceInUse(placeSpace);
+            undoLog.place_item(&itemsToPlace, &placedItems, it);
+
+            traceln(BOX_TAG, "place_item_at() - END");
+            return (true);
+
+        }   /* place_item_at() */
 
         /******************************************************************************/
         /*!
-         * @brief  Este método genera una orden en formato JSON para enviársela
-         *         al robot industrial del simulador RoboDK (vía MQTT).
+         * @brief  Marca un punto de control del estado de colocación (spaceInUse,
+         *         itemsToPlace, placedItems y validador). A partir de aquí cada
+         *         cambio se apunta en el registro de deshacer, así que tomar el
+         *         punto de control cuesta O(1). Se pueden anidar.
          * @param  void
+         * @return La marca, para rollback().
+         */
+        size_t
+        checkpoint(void)
+        {
+            return (undoLog.mark());
+
+        }   /* checkpoint() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve al estado de un punto de control deshaciendo solo los
+         *         cambios posteriores, en O(cambios): el registro deshace
+         *         también el índice espacial y las rejillas de vóxeles. La copia
+         *         spaceSoa (un array con un valor por espacio) se vuelve a copiar
+         *         la próxima vez que se use y el mapa de alturas lo construye
+         *         place_items_in_height_map() desde el validador. Se descarta
+         *         mqtt_order. La reordenación de itemOrder_t que hace
+         *         place_items_in_box() no se deshace.
+         * @param  mark  La marca devuelta por checkpoint().
          * @return void
          */
         void
-        generate_mqtt_order(void)
+        rollback(size_t mark)
         {
-            traceln(BOX_TAG, "generate_mqtt_order()");
+            traceln(BOX_TAG, "rollback()");
+
+            if (undoLog.undo_to(mark, &itemsToPlace, &placedItems, &spaceInUse, &validator,
+                                ((useSpaceIndex) ? (&spaceIndex) : (NULL))) == 0)
+            {
+                traceln(BOX_TAG, "rollback() - END");
+                return;
+            }
+
+            spaceSoaStale = true;
+            mqtt_order = "";
+
+            traceln(BOX_TAG, "rollback() - END");
+
+        }   /* rollback() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos cajas tienen el mismo estado de colocación: los
+         *         mismos espacios en uso (en el mismo orden, también en spaceSoa
+         *         y en el índice), los mismos items por colocar y colocados, y
+         *         las mismas rejillas y validador. Sirve para comprobar que
+         *         rollback() deja la caja como estaba.
+         * @param  other  La otra caja.
+         * @return Verdadero o falso.
+         */
+        bool
+        same_state(box_t & other)
+        {
+            traceln(BOX_TAG, "same_state()");
+
+            bool answer = ((type == other.type) && (spaceInUse.size() == other.spaceInUse.size()) &&
+                           (itemsToPlace.size() == other.itemsToPlace.size()) &&
+                           (placedItems.size() == other.placedItems.size()) &&
+                           (useSpaceIndex == other.useSpaceIndex));
+
+            for (pmr::list<space_t>::iterator a = spaceInUse.begin(), b = other.spaceInUse.begin();
+                (answer == true) && (a != spaceInUse.end()); ++a, ++b)
+            {
+                answer = !(*a != *b);
+            }
+
+            for (pmr::list<item_t>::iterator a = itemsToPlace.begin(), b = other.itemsToPlace.begin();
+                (answer == true) && (a != itemsToPlace.end()); ++a, ++b)
+            {
+                answer = (a->get_sku() == b->get_sku());
+            }
+
+            for (pmr::list<item_t>::iterator a = placedItems.begin(), b = other.placedItems.begin();
+                (answer == true) && (a != placedItems.end()); ++a, ++b)
+            {
+                answer = ((a->get_sku() == b->get_sku()) && !(a->get_posInBox() != b->get_posInBox()) &&
+                          (a->is_rotated() == b->is_rotated()));
+            }
+
+            if (answer == true)
+            {
+                refresh_spaceSoa();
+                other.refresh_spaceSoa();
+
+                answer = spaceSoa.same_spaces(other.spaceSoa) &&
+                         (!(useSpaceIndex) || spaceIndex.same_spaces(other.spaceIndex)) &&
+                         occupancy.equals(other.occupancy) && validator.equals(other.validator);
+            }
+
+            traceln(BOX_TAG, "same_state() - END");
+            return (answer);
+
+        }   /* same_state() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Da por buenos todos los cambios: vacía el registro de deshacer
+         *         (y libera los nodos borrados que guardaba) y deja de registrar.
+         * @param  void
+         * @return void
+         */
+        void
+        release_checkpoints(void)
+        {
+            undoLog.clear();
+
+        }   /* release_checkpoints() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Este método calcula la pose de TCP de un elemento colocado
+         *         para que pueda colocarse correctamente en el simulador RoboDK.
+         *         Si el item está girado 90º sobre z, el desplazamiento de la
+         *         ventosa pasa al eje x y el giro w se reduce en 90º. La pose no
+         *         se guarda en el item: se calcula al generar la orden.
+         * @param  it     El item colocado.
+         * @param  pose   Donde se guarda la pose (x, y, z, r, p, w) en décimas
+         *                de mm y de grado.
+         * @return void
+         */
+        void
+        compute_TCP_pose(pmr::list<item_t>::const_iterator it, int32_t pose[6])
+        {
+            traceln(BOX_TAG, "compute_TCP_pose()");
+
+            uint16_t x, y, z;
+            int16_t w; // r = -180, p = 0
+            uint8_t x_decimal, y_decimal;
+            space_t posInBox = it->get_posInBox();
+
+            x = (posInBox.min_x()) + (((posInBox.max_x()) - (posInBox.min_x())) / 2);
+            y = (posInBox.min_y()) + (((posInBox.max_y()) - (posInBox.min_y())) / 2);
+            z = (posInBox.max_z());
+
+            // El agarre de cada tipo de item está en SKU_CATALOG.
+            const sku_catalog_entry_t & sku = SKU_CATALOG[it->get_type()];
+
+            if (!(it->is_rotated()))
+            {
+                if (((size.max_y()) - y) <= (y - (size.min_y())))
+                {
+                    y = y - sku.gripOffset;
+                    w = sku.yawUpper;
+                }
+                else
+                {
+                    y = y + sku.gripOffset;
+                    w = sku.yawLower;
+                }
+
+                x_decimal = 0;
+                y_decimal = sku.gripDecimal;
+            }
+            else
+            {
+                // Girado: el eje y del item queda a lo largo del eje x de la caja
+                // y la ventosa gira 90º menos.
+                if (((size.max_x()) - x) <= (x - (size.min_x())))
+                {
+                    x = x - sku.gripOffset;
+                    w = sku.yawUpper - 90;
+                }
+                else
+                {
+                    x = x + sku.gripOffset;
+                    w = sku.yawLower - 90;
+                }
+
+                w = (w <= -180) ? (w + 360) : (w);
+                x_decimal = sku.gripDecimal;
+                y_decimal = 0;
+            }
+
+            // Todos los valores en décimas (punto fijo con un decimal).
+            pose[0] = (x * 10) + x_decimal;
+            pose[1] = (y * 10) + y_decimal;
+            pose[2] = z * 10;
+            pose[3] = -1800;
+            pose[4] = 0;
+            pose[5] = w * 10;
+
+            traceln(BOX_TAG, "compute_TCP_pose() - END");
+
+        }   /* compute_TCP_pose() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe la pose de TCP de un elemento colocado (ver
+         *         compute_TCP_pose()) como texto.
+         * @param  out  Donde se escribe la pose ("x, y, z, r, p, w").
+         * @param  it   El item colocado.
+         * @return void
+         */
+        void
+        write_TCP_pose(order_writer_t * out, pmr::list<item_t>::const_iterator it)
+        {
+            int32_t pose[6];
+
+            compute_TCP_pose(it, pose);
+
+            for (int k = 0; k < 6; k++)
+            {
+                if (k > 0)
+                {
+                    out->put(", ", 2);
+                }
+                out->put_fixed1(pose[k]);
+            }
+
+        }   /* write_TCP_pose() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la pose de TCP de un elemento colocado (ver
+         *         write_TCP_pose()).
+         * @param  it  El item colocado.
+         * @return La pose ("x, y, z, r, p, w").
+         */
+        string
+        calculate_TCP_pose(pmr::list<item_t>::const_iterator it)
+        {
+            char pose[64];
+            order_writer_t out(pose, sizeof(pose));
+
+            write_TCP_pose(&out, it);
+            return (string(pose, std::min(out.get_written(), sizeof(pose))));
+
+        }   /* calculate_TCP_pose() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe la orden en formato JSON para el robot industrial del
+         *         simulador RoboDK (la que lee fill_box() de functions.py). No
+         *         reserva memoria por item. Si algún item no ha cabido, la orden
+         *         lleva también "num_no_colocados" para que quien la recibe sepa
+         *         que el pedido está incompleto.
+         * @param  out         Donde se escribe.
+         * @param  singleLine  Si es verdadero, la orden se escribe en una sola
+         *                     línea (formato JSON Lines), si no, indentada.
+         * @return void
+         */
+        void
+        write_mqtt_order(order_writer_t * out, bool singleLine = false)
+        {
+            traceln(BOX_TAG, "write_mqtt_order()");
 
-            calculate_TCP_poses();
             int total_items = placedItems.size(), i = 0;
 
-            string box_type;
+            const char * nl    = (singleLine) ? ("")   : ("\n");
+            const char * ind1  = (singleLine) ? ("")   : ("  ");
+            const char * ind2  = (singleLine) ? ("")   : ("    ");
+            const char * comma = (singleLine) ? (", ") : (",\n");
+
+            const char * box_type;
             if (type == BOX_S)
             {
                 box_type = "S";
@@ -741,11 +1560,17 @@ class box_t
                 box_type = "L";
             }
 
-            mqtt_order = "{\n";
-            mqtt_order += "  \"tipo_caja\": \""      + box_type               + "\",\n";
-            mqtt_order += "  \"num_dispositivos\": " + to_string(total_items) +   ",\n";          
-            
-            for (list<item_t>::iterator it = placedItems.begin();
+            out->put("{"); out->put(nl);
+            out->put(ind1); out->put("\"tipo_caja\": \""); out->put(box_type); out->put("\""); out->put(comma);
+            out->put(ind1); out->put("\"num_dispositivos\": "); out->put_int(total_items);
+            if (!(itemsToPlace.empty()))
+            {
+                out->put(comma);
+                out->put(ind1); out->put("\"num_no_colocados\": "); out->put_int(itemsToPlace.size());
+            }
+            out->put((total_items > 0) ? (comma) : (nl));
+
+            for (pmr::list<item_t>::iterator it = placedItems.begin();
                 (it != placedItems.end()); ++it)
             {
                 i++;
@@ -755,15 +1580,128 @@ class box_t
                       "posicion_place": "120.0, 75.0, 120.0, -180.0, 0.0, 180.0"
                     }
                 */
-                mqtt_order += "  \"item_" + to_string(i) + "\": {\n";
-                mqtt_order += "    \"dispositivo\": \""    + (it->get_item_id())    + "\"," + "\n";
-                mqtt_order += "    \"posicion_place\": \"" + (it->get_target_str()) + "\""  + "\n";
-                mqtt_order += "  }";
-                
-                mqtt_order += (i != total_items) ? (",\n") : ("\n");
+                const string & id = it->get_item_id();
+
+                out->put(ind1); out->put("\"item_"); out->put_int(i); out->put("\": {"); out->put(nl);
+                out->put(ind2); out->put("\"dispositivo\": \""); out->put(id.data(), id.size()); out->put("\""); out->put(comma);
+                out->put(ind2); out->put("\"posicion_place\": \""); write_TCP_pose(out, it); out->put("\""); out->put(nl);
+                out->put(ind1); out->put("}");
+
+                out->put((i != total_items) ? (comma) : (nl));
             }
 
-            mqtt_order += "}";
+            out->put("}");
+
+            traceln(BOX_TAG, "write_mqtt_order() - END");
+
+        }   /* write_mqtt_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe la orden en MessagePack: el mismo contenido que
+         *         write_mqtt_order() pero con las poses en arrays numéricos y
+         *         cada identificador escrito una sola vez. Es un mapa con:
+         *
+         *           "tipo_caja":        "S", "M" o "L"
+         *           "num_dispositivos": número de items
+         *           "num_no_colocados": items que no han cabido (solo si hay)
+         *           "items":            array 16 de arrays [sku, x, y, z, r, p, w]
+         *           "dispositivos":     array con los identificadores distintos
+         *
+         *         donde sku (uint 16) es la posición del identificador en
+         *         "dispositivos" y la pose son 6 float 32. Cada item ocupa
+         *         siempre 34 bytes, así que se pueden leer en posiciones fijas.
+         *         La tabla de identificadores se guarda en la pila (y, si no
+         *         cabe, en el memory_resource de la caja).
+         * @param  out  Donde se escribe.
+         * @return void
+         */
+        void
+        write_msgpack_order(order_writer_t * out)
+        {
+            traceln(BOX_TAG, "write_msgpack_order()");
+
+            const char * box_type = (type == BOX_S) ? ("S") : ((type == BOX_M) ? ("M") : ("L"));
+            uint16_t buffer[64];
+            pmr::monotonic_buffer_resource local(buffer, sizeof(buffer), placedItems.get_allocator().resource());
+            pmr::vector<uint16_t> skus(&local); // identificadores distintos, por orden de aparición
+            int32_t pose[6];
+
+            out->put_msgpack_map((itemsToPlace.empty()) ? (4) : (5));
+            out->put_msgpack_str("tipo_caja", 9);
+            out->put_msgpack_str(box_type, 1);
+            out->put_msgpack_str("num_dispositivos", 16);
+            out->put_msgpack_uint(placedItems.size());
+            if (!(itemsToPlace.empty()))
+            {
+                out->put_msgpack_str("num_no_colocados", 16);
+                out->put_msgpack_uint(itemsToPlace.size());
+            }
+
+            out->put_msgpack_str("items", 5);
+            out->put_msgpack_array(placedItems.size(), true);
+
+            for (pmr::list<item_t>::iterator it = placedItems.begin();
+                (it != placedItems.end()); ++it)
+            {
+                size_t index = find(skus.begin(), skus.end(), it->get_sku()) - skus.begin();
+
+                if (index == skus.size())
+                {
+                    skus.push_back(it->get_sku());
+                }
+
+                compute_TCP_pose(it, pose);
+
+                out->put_msgpack_array(7);
+                out->put_msgpack_uint16(index);
+                for (int k = 0; k < 6; k++)
+                {
+                    out->put_msgpack_fixed1(pose[k]);
+                }
+            }
+
+            out->put_msgpack_str("dispositivos", 12);
+            out->put_msgpack_array(skus.size());
+
+            for (size_t i = 0; i < skus.size(); i++)
+            {
+                const string & id = sku_registry_t::instance().get_id(skus[i]);
+                out->put_msgpack_str(id.data(), id.size());
+            }
+
+            traceln(BOX_TAG, "write_msgpack_order() - END");
+
+        }   /* write_msgpack_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Este método genera una orden para enviársela al robot
+         *         industrial del simulador RoboDK (vía MQTT) y la guarda en
+         *         mqtt_order (ver write_mqtt_order() y write_msgpack_order()).
+         * @param  singleLine  Si es verdadero, la orden JSON se escribe en una
+         *                     sola línea (formato JSON Lines), si no, indentada.
+         * @param  format      ORDER_FORMAT_JSON (por defecto) u
+         *                     ORDER_FORMAT_MSGPACK (binaria).
+         * @return void
+         */
+        void
+        generate_mqtt_order(bool singleLine = false, orderFormat_t format = ORDER_FORMAT_JSON)
+        {
+            traceln(BOX_TAG, "generate_mqtt_order()");
+
+            mqtt_order.clear();
+
+            order_writer_t out(&mqtt_order);
+            if (format == ORDER_FORMAT_MSGPACK)
+            {
+                write_msgpack_order(&out);
+            }
+            else
+            {
+                write_mqtt_order(&out, singleLine);
+            }
+            out.flush();
 
             traceln(BOX_TAG, "generate_mqtt_order() - END");
 
@@ -778,9 +1716,135 @@ class box_t
         string
         get_mqtt_order(void)
         {
-            return mqtt_order;
+            return (string(mqtt_order.data(), mqtt_order.size()));
 
         }   /* gst_mqtt_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el atributo type de box_t.
+         * @param  void
+         * @return El tipo de caja.
+         */
+        boxType_t
+        get_type(void)
+        {
+            return type;
+
+        }   /* get_type() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el atributo size de box_t.
+         * @param  void
+         * @return El tamaño interior de la caja.
+         */
+        space_t
+        get_size(void)
+        {
+            return size;
+
+        }   /* get_size() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el tamaño interior de un tipo de caja.
+         * @param  type  El tipo de caja.
+         * @return El tamaño interior (con origen en 0, 0, 0).
+         */
+        static space_t
+        size_of(boxType_t type)
+        {
+            space_t boxSize;
+
+            switch (type)
+            {
+                case BOX_S:
+                    boxSize.set_space(0, 0, 0, 240, 300, 240);
+                    break;
+
+                case BOX_M:
+                    boxSize.set_space(0, 0, 0, 320, 300, 240);
+                    break;
+
+                case BOX_L:
+                    boxSize.set_space(0, 0, 0, 480, 300, 240);
+                    break;
+
+                default:
+                    break;
+            }
+
+            return (boxSize);
+
+        }   /* size_of() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la lista de items que quedan por colocar.
+         * @param  void
+         * @return Referencia a itemsToPlace.
+         */
+        const pmr::list<item_t> &
+        get_items_to_place(void)
+        {
+            return itemsToPlace;
+
+        }   /* get_items_to_place() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la lista de items colocados en la caja.
+         * @param  void
+         * @return Referencia a placedItems.
+         */
+        const pmr::list<item_t> &
+        get_placed_items(void)
+        {
+            return placedItems;
+
+        }   /* get_placed_items() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de items colocados en la caja.
+         * @param  void
+         * @return Tamaño de la lista placedItems.
+         */
+        size_t
+        get_num_placed_items(void)
+        {
+            return placedItems.size();
+
+        }   /* get_num_placed_items() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de items que quedan por colocar.
+         * @param  void
+         * @return Tamaño de la lista itemsToPlace.
+         */
+        size_t
+        get_num_items_to_place(void)
+        {
+            return itemsToPlace.size();
+
+        }   /* get_num_items_to_place() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la fracción del volumen de la caja ocupada por los
+         *         items colocados.
+         * @param  void
+         * @return Un valor entre 0 y 1.
+         */
+        double
+        get_fill_ratio(void)
+        {
+            return ((double)validator.get_placed_volume() /
+                    ((double)size.max_x() * size.max_y() * size.max_z()));
+
+        }   /* get_fill_ratio() */
 };
 
 #endif /* BOX_T_H */
@@ -21,6 +21,17 @@
 #ifndef DEFINES_T
 #define DEFINES_T
 
+#include <stdint.h>
+
+// Uso por defecto del índice espacial en box_t::is_valid_space() (1 = activo).
+#define USE_SPACE_INDEX 1
+
+// Uso por defecto de la rejilla de vóxeles como filtro rápido de is_valid_space().
+#define USE_OCCUPANCY_GRID 1
+
+// Permitir por defecto girar los items 90º sobre el eje z al colocarlos.
+#define ALLOW_ROTATION 1
+
 typedef enum 
 {
     PULSERA,
@@ -34,6 +45,42 @@ typedef enum
 
 } itemType_t;
 
+#define NUM_ITEM_TYPES 8
+
+// Catálogo de los tipos de item, indexado por itemType_t: dimensiones (mm) y
+// agarre de la ventosa. El TCP se desplaza gripOffset.gripDecimal mm desde el
+// centro del item hacia el centro de la caja, a lo largo del eje y del item, y
+// gira yawUpper o yawLower grados según el item esté en la mitad superior o
+// inferior de la caja (si el item está girado 90º sobre z, 90º menos).
+typedef struct
+{
+    itemType_t type;
+    uint16_t x, y, z;
+    uint8_t gripOffset;
+    uint8_t gripDecimal;
+    int16_t yawUpper;
+    int16_t yawLower;
+
+} sku_catalog_entry_t;
+
+static constexpr sku_catalog_entry_t SKU_CATALOG[NUM_ITEM_TYPES] =
+{
+    {PULSERA,         80,  75, 30, 72, 5, -90,  90},
+    {RELOJ,           80,  75, 60, 72, 5, -90,  90},
+    {FUNDA_TELEFONO,  80, 150, 20, 35, 0, -90,  90},
+    {TELEFONO,        80, 150, 60, 35, 0, -90,  90},
+    {FUNDA_EREADER,  120, 150, 20, 35, 0, -90,  90},
+    {EREADER,        120, 150, 40, 35, 0, -90,  90},
+    {FUNDA_TABLET,   240, 150, 20,  0, 0,   0, 180},
+    {TABLET,         240, 150, 40,  0, 0,   0, 180}
+};
+
+static_assert((SKU_CATALOG[PULSERA].type == PULSERA) && (SKU_CATALOG[RELOJ].type == RELOJ) &&
+              (SKU_CATALOG[FUNDA_TELEFONO].type == FUNDA_TELEFONO) && (SKU_CATALOG[TELEFONO].type == TELEFONO) &&
+              (SKU_CATALOG[FUNDA_EREADER].type == FUNDA_EREADER) && (SKU_CATALOG[EREADER].type == EREADER) &&
+              (SKU_CATALOG[FUNDA_TABLET].type == FUNDA_TABLET) && (SKU_CATALOG[TABLET].type == TABLET),
+              "SKU_CATALOG tiene que seguir el orden de itemType_t");
+
 typedef enum 
 {
     BOX_S,
@@ -42,6 +89,42 @@ typedef enum
 
 } boxType_t;
 
+typedef enum
+{
+    ENGINE_SPACE_LIST,     // fusión de espacios en uso (spaceInUse)
+    ENGINE_HEIGHT_MAP,     // mapa de alturas del suelo de la caja
+    ENGINE_EXTREME_POINTS, // puntos extremos (extreme_points_strategy_t)
+    ENGINE_GUILLOTINE,     // cortes de guillotina (guillotine_strategy_t)
+    ENGINE_MAXRECTS,       // rectángulos maximales por capas (maxrects_strategy_t)
+    ENGINE_LAYERS          // capas de items de la misma altura (layer_strategy_t)
+
+} packingEngine_t;
+
+typedef enum
+{
+    ORDER_INPUT,          // el orden del pedido
+    ORDER_VOLUME_DESC,    // de mayor a menor volumen
+    ORDER_FOOTPRINT_DESC, // de mayor a menor huella (x * y), luego altura
+    ORDER_HEIGHT_DESC     // de mayor a menor altura, luego huella
+
+} itemOrder_t;
+
+typedef enum
+{
+    EP_SCORE_ZXY,   // menor z, luego menor x y luego menor y (por defecto)
+    EP_SCORE_ZYX,   // menor z, luego menor y y luego menor x
+    EP_SCORE_XZY,   // menor x, luego menor z y luego menor y (por paredes)
+    EP_SCORE_SUM    // menor x + y + z (más cerca de la esquina), luego menor z
+
+} epScore_t;
+
+typedef enum
+{
+    ORDER_FORMAT_JSON,    // JSON (el formato de fill_box() de functions.py)
+    ORDER_FORMAT_MSGPACK  // MessagePack con las poses en arrays numéricos
+
+} orderFormat_t;
+
 typedef struct
 {
     uint16_t x, y, z;
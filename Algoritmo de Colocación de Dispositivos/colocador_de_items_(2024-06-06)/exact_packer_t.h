@@ -0,0 +1,684 @@
+/**
+ * @file     exact_packer_t.h
+ *
+ * @brief    Búsqueda exacta (ramificación y poda) para pedidos pequeños.
+ *
+ * Con hasta EXACT_MAX_ITEMS items se recorren todas las colocaciones que se
+ * pueden construir poniendo los items de uno en uno, en cualquier orden, en
+ * los puntos extremos de los ya colocados (extreme_points_strategy_t::
+ * points_of()) y en sus dos orientaciones: en cada nodo se prueba como
+ * siguiente item una copia de cada SKU que quede, así que también se llega a
+ * las colocaciones en las que un item grande se apoya sobre otros más
+ * pequeños. Cada posición pasa por placement_validator_t, con las mismas
+ * reglas que box_t. Cualquier nodo es además una solución en la que los
+ * items que faltan se quedan fuera. El objetivo es, por este orden: la caja
+ * más pequeña en la que cabe todo el pedido, y en ella la colocación más
+ * baja (la menor altura de la cara superior más alta); si no cabe en ninguna,
+ * el mayor volumen colocado en la caja más grande y, a igualdad, la menor
+ * altura.
+ *
+ * Podas:
+ *   - Cotas de cada caja: box_selector_t::may_fit() y, por clases de altura,
+ *     que en una columna de altura T no caben más de k items de altura mayor
+ *     que T / (k + 1): la huella de esos items no puede pasar de k veces el
+ *     suelo. De ahí sale también la menor altura posible; si se alcanza, la
+ *     búsqueda termina.
+ *   - Cota de volumen: lo colocado más el volumen de los items por decidir
+ *     tiene que poder mejorar la mejor solución.
+ *   - Simetría: las copias de un mismo SKU se colocan en posiciones
+ *     crecientes (menor z, luego x y luego y), y un mismo conjunto de
+ *     posiciones al que se llega en otro orden no se vuelve a recorrer (se
+ *     guarda una huella de 64 bits de cada conjunto visitado).
+ *
+ * "Óptima" quiere decir que no hay colocación mejor entre las que se pueden
+ * construir así; packing_checker_t puede aceptar otras que no salen de los
+ * puntos extremos.
+ *
+ * La búsqueda tiene un límite de tiempo y de nodos. Si se agota, el pedido se
+ * coloca con el motor heurístico (con box_selector_t si se busca la caja) y
+ * se devuelve la mejor de las dos colocaciones.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la búsqueda exacta
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef EXACT_PACKER_T_H
+#define EXACT_PACKER_T_H
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <memory_resource>
+#include <unordered_set>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "box_selector_t.h"
+#include "placement_validator_t.h"
+#include "extreme_points_strategy_t.h"
+#include "height_map_t.h"
+
+using namespace std;
+
+// static const char * EXACT_TAG = __FILE__;
+static const char * EXACT_TAG = "exact_packer_t.h";
+
+// Máximo de items de un pedido para la búsqueda exacta.
+#define EXACT_MAX_ITEMS 12
+
+// Límite de tiempo por defecto de la búsqueda exacta (ms).
+#define EXACT_TIME_LIMIT_MS 50
+
+// Cada cuántos nodos se mira el reloj.
+#define EXACT_CLOCK_INTERVAL 64
+
+typedef struct
+{
+    boxType_t boxType;       // caja del pedido (se ignora si autoBox)
+    bool autoBox;            // buscar también la caja más pequeña
+    packingEngine_t engine;  // motor heurístico de reserva
+    unsigned timeLimitMs;    // 0 = sin límite de tiempo
+    size_t maxNodes;         // 0 = sin límite
+
+} exact_options_t;
+
+typedef struct
+{
+    size_t nodes;    // nodos explorados
+    bool optimal;    // la búsqueda ha terminado: no hay colocación mejor
+                     // entre las que recorre
+    bool fallback;   // la colocación devuelta es la del motor heurístico
+
+} exact_report_t;
+
+class exact_packer_t
+{
+    private:
+
+        // Un paso de una solución: el SKU (índice en groups) y su posición.
+        typedef struct
+        {
+            size_t group;
+            space_t position;
+            bool rotated;
+
+        } step_t;
+
+        // Las copias de un SKU del pedido.
+        typedef struct
+        {
+            item_t item;
+            uint64_t volume;
+            size_t count;     // copias en el pedido
+            size_t used;      // copias colocadas en la rama actual
+            size_t lastStep;  // paso de la última copia colocada (si used > 0)
+
+        } group_t;
+
+        // Calidad de una colocación (ver is_better()).
+        typedef struct
+        {
+            bool complete;      // cabe todo el pedido
+            uint64_t boxVolume;
+            uint64_t volume;    // volumen colocado
+            uint16_t top;       // altura de la cara superior más alta
+
+        } rank_t;
+
+        // ATRIBUTOS.
+        exact_options_t options;
+        vector<item_t> items;            // de mayor a menor volumen
+        vector<group_t> groups;          // SKUs de items, en el mismo orden
+        uint64_t totalVolume;
+        vector< vector<point_t> > points; // puntos extremos de cada nivel
+        placement_validator_t validator;
+        space_t boxSize;
+        bool placeAll;                   // no se puede dejar ningún item fuera
+        uint16_t heightBound;            // altura mínima posible (si placeAll)
+
+        vector<step_t> current;
+        uint64_t placedVolume;
+        uint64_t hash;                   // huella de los pasos de current
+        unordered_set<uint64_t> visited; // huellas de los nodos recorridos
+        uint16_t top;
+
+        vector<step_t> best;
+        bool found;
+        uint64_t bestVolume;
+        uint16_t bestTop;
+
+        size_t nodes;
+        bool expired;                    // tiempo o nodos agotados
+        bool finished;                   // se ha alcanzado la altura mínima
+        chrono::steady_clock::time_point deadline;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si la colocación a es mejor que la b.
+         */
+        static bool
+        is_better(const rank_t & a, const rank_t & b)
+        {
+            if (a.complete != b.complete)
+            {
+                return (a.complete);
+            }
+
+            if (a.complete && (a.boxVolume != b.boxVolume))
+            {
+                return (a.boxVolume < b.boxVolume);
+            }
+
+            if (a.volume != b.volume)
+            {
+                return (a.volume > b.volume);
+            }
+
+            return (a.top < b.top);
+
+        }   /* is_better() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calidad de una caja ya llena.
+         */
+        static rank_t
+        rank_of(box_t * box)
+        {
+            space_t size = box->get_size();
+            rank_t rank = {(box->get_num_items_to_place() == 0),
+                           (uint64_t)size.max_x() * size.max_y() * size.max_z(), 0, 0};
+
+            for (pmr::list<item_t>::const_iterator it = box->get_placed_items().begin();
+                (it != box->get_placed_items().end()); ++it)
+            {
+                space_t s = it->get_posInBox();
+
+                rank.volume += (uint64_t)(s.max_x() - s.min_x()) * (s.max_y() - s.min_y()) *
+                               (s.max_z() - s.min_z());
+                rank.top = std::max(rank.top, s.max_z());
+            }
+
+            return (rank);
+
+        }   /* rank_of() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Menor altura en la que pueden caber todos los items en una
+         *         caja, según las cotas de volumen y de clases de altura.
+         * @return La altura, o la de la caja más 1 si seguro que no caben.
+         */
+        uint16_t
+        height_lower_bound(space_t size)
+        {
+            uint64_t floor = (uint64_t)size.max_x() * size.max_y();
+            uint64_t volume = 0;
+            uint16_t tallest = 0;
+
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                space_t s = items[i].get_size();
+
+                volume += (uint64_t)s.max_x() * s.max_y() * s.max_z();
+                tallest = std::max(tallest, s.max_z());
+            }
+
+            for (uint32_t t = std::max((uint64_t)tallest, (volume + floor - 1) / floor); t <= size.max_z(); t++)
+            {
+                bool fits = true;
+
+                // En una columna de altura t caben como mucho k items más
+                // altos que t / (k + 1).
+                for (uint32_t k = 1; (fits == true) && ((t / (k + 1)) >= 1) && (k <= items.size()); k++)
+                {
+                    uint64_t footprint = 0;
+
+                    for (size_t i = 0; i < items.size(); i++)
+                    {
+                        space_t s = items[i].get_size();
+
+                        if (((uint32_t)s.max_z() * (k + 1)) > t)
+                        {
+                            footprint += (uint64_t)s.max_x() * s.max_y();
+                        }
+                    }
+
+                    fits = (footprint <= (k * floor));
+                }
+
+                if (fits)
+                {
+                    return ((uint16_t)t);
+                }
+            }
+
+            return (size.max_z() + 1);
+
+        }   /* height_lower_bound() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si se ha agotado el presupuesto de la búsqueda.
+         */
+        bool
+        out_of_budget(void)
+        {
+            if ((options.maxNodes > 0) && (nodes >= options.maxNodes))
+            {
+                return (true);
+            }
+
+            return ((options.timeLimitMs > 0) && ((nodes % EXACT_CLOCK_INTERVAL) == 0) &&
+                    (chrono::steady_clock::now() >= deadline));
+
+        }   /* out_of_budget() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Huella de un paso. La de un nodo es el XOR de las de sus
+         *         pasos, así que no depende del orden en que se han dado.
+         */
+        uint64_t
+        step_hash(size_t group, space_t position)
+        {
+            uint64_t key[2] = {((uint64_t)groups[group].item.get_sku() << 48) |
+                               ((uint64_t)position.min_x() << 32) |
+                               ((uint64_t)position.min_y() << 16) | position.min_z(),
+                               ((uint64_t)position.max_x() << 32) |
+                               ((uint64_t)position.max_y() << 16) | position.max_z()};
+            uint64_t h = 0;
+
+            // splitmix64 de cada palabra.
+            for (int k = 0; k < 2; k++)
+            {
+                h = (h ^ key[k]) + 0x9E3779B97F4A7C15ULL;
+                h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+                h = h ^ (h >> 31);
+            }
+
+            return (h);
+
+        }   /* step_hash() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Prueba como siguiente item una copia de cada SKU que quede
+         *         (y, recursivamente, los siguientes).
+         */
+        void
+        search(void)
+        {
+            // Un conjunto de posiciones al que ya se ha llegado en otro orden
+            // tiene los mismos puntos extremos y las mismas ramas.
+            if (!(visited.insert(hash).second))
+            {
+                return;
+            }
+
+            nodes++;
+            if (out_of_budget())
+            {
+                expired = true;
+                return;
+            }
+
+            size_t depth = current.size();
+
+            if (!(placeAll) || (depth == items.size()))
+            {
+                if (!(found) || (placedVolume > bestVolume) || ((placedVolume == bestVolume) && (top < bestTop)))
+                {
+                    best = current;
+                    found = true;
+                    bestVolume = placedVolume;
+                    bestTop = top;
+                    finished = placeAll && (top <= heightBound);
+                }
+            }
+
+            if (depth == items.size())
+            {
+                return;
+            }
+
+            // Cota de volumen: esta rama tiene que poder mejorar la mejor (lo
+            // colocado más lo que falta es todo el pedido).
+            uint64_t bound = totalVolume;
+            if (found && ((bound < bestVolume) || ((bound == bestVolume) && (top >= bestTop))))
+            {
+                return;
+            }
+
+            extreme_points_strategy_t::points_of(validator.get_placed(), boxSize, EP_SCORE_ZXY, &(points[depth]));
+
+            for (size_t g = 0; (g < groups.size()) && !(expired) && !(finished); g++)
+            {
+                group_t & group = groups[g];
+
+                if (group.used == group.count)
+                {
+                    continue;
+                }
+
+                int orientations = (ALLOW_ROTATION && group.item.can_rotate()) ? (2) : (1);
+
+                for (int r = 0; (r < orientations) && !(expired) && !(finished); r++)
+                {
+                    space_t itemSize = (r == 1) ? (group.item.get_rotated_size()) : (group.item.get_size());
+
+                    for (size_t p = 0; (p < points[depth].size()) && !(expired) && !(finished); p++)
+                    {
+                        point_t origin = points[depth][p];
+                        space_t candidate = itemSize + origin;
+
+                        // Las copias de un SKU van en posiciones crecientes.
+                        if (group.used > 0)
+                        {
+                            space_t previous = current[group.lastStep].position;
+                            point_t previousOrigin = {previous.min_x(), previous.min_y(), previous.min_z()};
+
+                            if (!(height_map_t::is_better_position(previousOrigin, origin)))
+                            {
+                                continue;
+                            }
+                        }
+
+                        if (!(validator.is_valid(candidate)))
+                        {
+                            continue;
+                        }
+
+                        uint16_t previousTop = top;
+                        size_t previousLast = group.lastStep;
+                        uint64_t stepHash = step_hash(g, candidate);
+                        step_t step = {g, candidate, (r == 1)};
+
+                        validator.add(candidate);
+                        current.push_back(step);
+                        group.used++;
+                        group.lastStep = depth;
+                        placedVolume += group.volume;
+                        hash ^= stepHash;
+                        top = std::max(top, candidate.max_z());
+
+                        search();
+
+                        top = previousTop;
+                        hash ^= stepHash;
+                        placedVolume -= group.volume;
+                        group.lastStep = previousLast;
+                        group.used--;
+                        current.pop_back();
+                        validator.remove_last();
+                    }
+                }
+            }
+
+        }   /* search() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca en un tipo de caja.
+         * @param  type      El tipo de caja.
+         * @param  placeAll  Solo valen las colocaciones de todo el pedido.
+         * @return Verdadero si se ha encontrado alguna colocación.
+         */
+        bool
+        search_box(boxType_t type, bool placeAll)
+        {
+            traceln(EXACT_TAG, "search_box()");
+
+            this->boxSize = box_t::size_of(type);
+            this->placeAll = placeAll;
+            this->heightBound = (placeAll) ? (height_lower_bound(boxSize)) : (0);
+
+            validator.reset(boxSize);
+            current.clear();
+            best.clear();
+            visited.clear();
+            placedVolume = 0;
+            hash = 0;
+            top = 0;
+            found = false;
+            bestVolume = 0;
+            bestTop = 0;
+            finished = false;
+
+            for (size_t g = 0; g < groups.size(); g++)
+            {
+                groups[g].used = 0;
+            }
+
+            if (!(placeAll) || (heightBound <= boxSize.max_z()))
+            {
+                search();
+            }
+
+            traceln(EXACT_TAG, "search_box() - END");
+            return (found);
+
+        }   /* search_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Construye la caja de la mejor solución: los items se colocan
+         *         con box_t::place_item_at(), en el orden de la búsqueda.
+         */
+        box_t *
+        build_box(boxType_t type)
+        {
+            pmr::list<item_t> ordered;
+            vector<size_t> used(groups.size(), 0);
+
+            for (size_t s = 0; s < best.size(); s++)
+            {
+                ordered.push_back(groups[best[s].group].item);
+                used[best[s].group]++;
+            }
+
+            for (size_t g = 0; g < groups.size(); g++)
+            {
+                for (size_t c = used[g]; c < groups[g].count; c++)
+                {
+                    ordered.push_back(groups[g].item);
+                }
+            }
+
+            box_t * box = new box_t(type, std::move(ordered));
+
+            for (size_t s = 0; s < best.size(); s++)
+            {
+                point_t origin = {best[s].position.min_x(), best[s].position.min_y(), best[s].position.min_z()};
+
+                box->place_item_at(0, origin, best[s].rotated);
+            }
+
+            return (box);
+
+        }   /* build_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca el pedido con el motor heurístico.
+         */
+        box_t *
+        heuristic_box(list<item_t> * itemsToPlace)
+        {
+            box_t * box = NULL;
+
+            if (!(options.autoBox) ||
+                !(box_selector_t::pack_in_smallest_box(itemsToPlace, options.engine, false, &box)))
+            {
+                box = new box_t((options.autoBox) ? (BOX_L) : (options.boxType), itemsToPlace);
+                box->set_engine(options.engine);
+                box->place_items_in_box();
+            }
+
+            return (box);
+
+        }   /* heuristic_box() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si la colocación de la caja a es mejor que la de la b,
+         *         con el mismo objetivo que la búsqueda.
+         */
+        static bool
+        is_better_box(box_t * a, box_t * b)
+        {
+            return (is_better(rank_of(a), rank_of(b)));
+
+        }   /* is_better_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase exact_packer_t.
+         * @param  options  Opciones de la búsqueda.
+         */
+        exact_packer_t(exact_options_t options)
+        {
+            traceln(EXACT_TAG, "exact_packer_t()");
+
+            this->options = options;
+            this->nodes = 0;
+            this->expired = false;
+            this->finished = false;
+            this->found = false;
+
+            traceln(EXACT_TAG, "exact_packer_t() - END");
+
+        }   /* exact_packer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca la mejor colocación del pedido.
+         * @param  itemsToPlace  Los items del pedido.
+         * @param  result        Devuelve la caja con la colocación (reservada
+         *                       con new, la libera quien llama).
+         * @param  report        Devuelve los detalles de la búsqueda (o NULL).
+         * @return Verdadero si la colocación es la mejor posible.
+         */
+        bool
+        solve(list<item_t> * itemsToPlace, box_t ** result, exact_report_t * report = NULL)
+        {
+            traceln(EXACT_TAG, "solve()");
+
+            const boxType_t types[NUM_BOX_TYPES] = {BOX_S, BOX_M, BOX_L};
+            boxType_t bestType = (options.autoBox) ? (BOX_L) : (options.boxType);
+            bool haveSolution = false, optimal = false, fallback = false;
+
+            nodes = 0;
+            expired = false;
+            deadline = chrono::steady_clock::now() + chrono::milliseconds(options.timeLimitMs);
+            *result = NULL;
+
+            if (itemsToPlace->size() <= EXACT_MAX_ITEMS)
+            {
+                // 1) Items de mayor a menor volumen, con las copias de un SKU
+                //    juntas: se agrupan por SKU y los grupos se prueban en ese orden.
+                items.assign(itemsToPlace->begin(), itemsToPlace->end());
+                stable_sort(items.begin(), items.end(), [](const item_t & a, const item_t & b)
+                {
+                    space_t sa = a.get_size(), sb = b.get_size();
+                    uint64_t va = (uint64_t)sa.max_x() * sa.max_y() * sa.max_z();
+                    uint64_t vb = (uint64_t)sb.max_x() * sb.max_y() * sb.max_z();
+
+                    return ((va != vb) ? (va > vb) : (a.get_sku() < b.get_sku()));
+                });
+
+                groups.clear();
+                points.resize(items.size());
+                totalVolume = 0;
+
+                for (size_t i = 0; i < items.size(); i++)
+                {
+                    space_t s = items[i].get_size();
+                    uint64_t volume = (uint64_t)s.max_x() * s.max_y() * s.max_z();
+
+                    if ((i == 0) || (items[i].get_sku() != items[i - 1].get_sku()))
+                    {
+                        group_t group = {items[i], volume, 0, 0, 0};
+                        groups.push_back(group);
+                    }
+
+                    groups.back().count++;
+                    totalVolume += volume;
+                }
+
+                // 2) Todo el pedido, de la caja más pequeña a la más grande. Una
+                //    caja sin solución solo está descartada si se ha recorrido
+                //    entera.
+                for (int t = 0; (t < NUM_BOX_TYPES) && !(haveSolution) && !(expired); t++)
+                {
+                    boxType_t type = (options.autoBox) ? (types[t]) : (options.boxType);
+
+                    if ((box_selector_t::may_fit(type, itemsToPlace)) && search_box(type, true))
+                    {
+                        bestType = type;
+                        haveSolution = true;
+                        optimal = !(expired);
+                    }
+
+                    if (!(options.autoBox))
+                    {
+                        break;
+                    }
+                }
+
+                // 3) Si no cabe en ninguna, el mayor volumen en la caja más grande.
+                if (!(haveSolution) && !(expired))
+                {
+                    haveSolution = search_box(bestType, false);
+                    optimal = haveSolution && !(expired);
+                }
+
+                if (haveSolution)
+                {
+                    *result = build_box(bestType);
+                }
+            }
+
+            // 4) Sin prueba de que sea la mejor: comparar con el motor heurístico.
+            if (!(optimal))
+            {
+                box_t * heuristic = heuristic_box(itemsToPlace);
+
+                if ((*result == NULL) || is_better_box(heuristic, *result))
+                {
+                    delete *result;
+                    *result = heuristic;
+                    fallback = true;
+                }
+                else
+                {
+                    delete heuristic;
+                }
+            }
+
+            if (report != NULL)
+            {
+                report->nodes = nodes;
+                report->optimal = optimal;
+                report->fallback = fallback;
+            }
+
+            traceln(EXACT_TAG, "solve() - END");
+            return (optimal);
+
+        }   /* solve() */
+};
+
+#endif /* EXACT_PACKER_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,59 @@
+/**
+ * @file     example_orders.h
+ *
+ * @brief    Los tres pedidos de ejemplo (cajas S, M y L) que coloca main.cpp
+ *           cuando se ejecuta sin argumentos y que benchmark.cpp mide como
+ *           escenarios fijos. Cada lista tiene los identificadores de los
+ *           items en el orden del pedido y termina en NULL.
+ *
+ * @version  0.7   (2026/10/18) Pedidos de ejemplo compartidos
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef EXAMPLE_ORDERS_H
+#define EXAMPLE_ORDERS_H
+
+#include <stddef.h>
+
+// Pedido de ejemplo para la caja S.
+static const char * const EJEMPLO_PEDIDO_S_ITEMS[] =
+{
+	"tablet_A_01", "tablet_A_01", "tablet_A_01", "ereader_B_02", "ereader_A_02", "ereader_B_funda",
+	"ereader_B_funda", "ereader_A_funda", "ereader_A_funda", "telefono_C_03", "telefono_A_02",
+	"telefono_F_02", "telefono_D_01", "telefono_D_01", "telefono_B_01", "reloj_B_01", "reloj_B_01",
+	"reloj_B_01", "reloj_B_02", "reloj_B_02", "reloj_B_01", "telefono_B_01", "telefono_B_01",
+	"telefono_D_funda", "telefono_D_funda", "telefono_B_funda", NULL
+};
+
+// Pedido de ejemplo para la caja M.
+static const char * const EJEMPLO_PEDIDO_M_ITEMS[] =
+{
+	"tablet_A_02", "tablet_A_02", "tablet_A_funda", "tablet_A_funda", "tablet_A_01", "tablet_A_01",
+	"tablet_B_funda", "tablet_B_funda", "tablet_B_02", "tablet_B_02", "tablet_B_funda",
+	"tablet_B_funda", "tablet_D_funda", "tablet_D_funda", "ereader_A_02", "ereader_A_01",
+	"ereader_B_01", "ereader_B_01", "telefono_F_02", "telefono_D_01", "telefono_D_01",
+	"telefono_B_01", "telefono_B_01", "telefono_B_01", "telefono_B_01", "telefono_D_01", NULL
+};
+
+// Pedido de ejemplo para la caja L.
+static const char * const EJEMPLO_PEDIDO_L_ITEMS[] =
+{
+	"tablet_A_02", "tablet_A_02", "tablet_A_02", "tablet_C_02", "tablet_C_02", "tablet_C_02",
+	"tablet_B_01", "tablet_B_01", "tablet_B_01", "tablet_A_01", "tablet_A_01", "tablet_D_01",
+	"tablet_A_funda", "tablet_A_funda", "tablet_B_funda", "tablet_B_funda", "tablet_A_funda",
+	"tablet_A_funda", "tablet_A_funda", "tablet_A_funda", "ereader_B_01", "ereader_B_01",
+	"ereader_B_01", "ereader_B_01", "telefono_B_01", "telefono_B_01", "telefono_B_01",
+	"telefono_B_01", "telefono_B_01", "telefono_B_01", "pulsera_B_01", "pulsera_B_01",
+	"pulsera_B_01", "pulsera_B_01", "pulsera_B_01", "pulsera_B_01", "pulsera_B_01",
+	"pulsera_B_01", "pulsera_B_01", "pulsera_B_01", "pulsera_B_01", "pulsera_B_01",
+	"telefono_B_funda", "telefono_B_funda", "telefono_B_funda", "telefono_B_funda",
+	"telefono_B_funda", "telefono_B_funda", NULL
+};
+
+#endif /* EXAMPLE_ORDERS_H */
+
+/*** end of file ***/
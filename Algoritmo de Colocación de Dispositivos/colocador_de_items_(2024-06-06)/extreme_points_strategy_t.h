@@ -0,0 +1,371 @@
+/**
+ * @file     extreme_points_strategy_t.h
+ *
+ * @brief    Estrategia de colocación por puntos extremos (Extreme Points).
+ *
+ * Se mantiene una lista de puntos candidatos, que empieza con la esquina
+ * (0, 0, 0) de la caja. Al colocar un item, sus tres esquinas "positivas" se
+ * añaden como puntos nuevos, tal cual y proyectadas hacia abajo y hacia las
+ * paredes hasta tocar otro item o la caja, y se quitan los puntos que han
+ * quedado dentro del item.
+ *
+ * La lista se mantiene ordenada según un epScore_t (por defecto, menor z,
+ * luego menor x y luego menor y): cada item se prueba en sus orientaciones
+ * recorriendo los puntos de mejor a peor, y la primera posición válida es ya
+ * la mejor de esa orientación. Los puntos en los que el item se saldría de la
+ * caja se descartan sin pasar por el validador. get_attempts() cuenta las
+ * posiciones que se han validado.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de puntos extremos
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef EXTREME_POINTS_STRATEGY_T_H
+#define EXTREME_POINTS_STRATEGY_T_H
+
+#include <algorithm>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "height_map_t.h"
+#include "placement_strategy_t.h"
+
+using namespace std;
+
+// static const char * EXTREME_POINTS_TAG = __FILE__;
+static const char * EXTREME_POINTS_TAG = "extreme_points_strategy_t.h";
+
+class extreme_points_strategy_t : public placement_strategy_t
+{
+    private:
+
+        // ATRIBUTOS.
+        vector<point_t> points; // ordenados de mejor a peor según score
+        epScore_t score;
+        size_t attempts;        // posiciones pasadas al validador
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si un punto está dentro (o en la cara mínima) de un item.
+         */
+        static bool
+        is_inside(point_t p, space_t s)
+        {
+            return ((p.x >= s.min_x()) && (p.x < s.max_x()) &&
+                    (p.y >= s.min_y()) && (p.y < s.max_y()) &&
+                    (p.z >= s.min_z()) && (p.z < s.max_z()));
+
+        }   /* is_inside() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Proyecta un punto en el sentido negativo de un eje (0 = x,
+         *         1 = y, 2 = z) hasta la cara del primer item que encuentra o
+         *         hasta la pared de la caja.
+         */
+        static point_t
+        project(point_t p, int axis, const pmr::vector<space_t> & placed)
+        {
+            point_t q = p;
+            uint16_t limit = 0;
+
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                space_t s = placed[i];
+
+                if ((axis == 0) && (s.max_x() <= p.x) && (s.max_x() > limit) &&
+                    (p.y >= s.min_y()) && (p.y < s.max_y()) && (p.z >= s.min_z()) && (p.z < s.max_z()))
+                {
+                    limit = s.max_x();
+                }
+                else if ((axis == 1) && (s.max_y() <= p.y) && (s.max_y() > limit) &&
+                         (p.x >= s.min_x()) && (p.x < s.max_x()) && (p.z >= s.min_z()) && (p.z < s.max_z()))
+                {
+                    limit = s.max_y();
+                }
+                else if ((axis == 2) && (s.max_z() <= p.z) && (s.max_z() > limit) &&
+                         (p.x >= s.min_x()) && (p.x < s.max_x()) && (p.y >= s.min_y()) && (p.y < s.max_y()))
+                {
+                    limit = s.max_z();
+                }
+            }
+
+            if (axis == 0)      { q.x = limit; }
+            else if (axis == 1) { q.y = limit; }
+            else                { q.z = limit; }
+
+            return (q);
+
+        }   /* project() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el punto a es mejor que el b según la puntuación.
+         *         Es un orden total: dos puntos distintos nunca empatan.
+         */
+        static bool
+        is_better(point_t a, point_t b, epScore_t score)
+        {
+            if (score == EP_SCORE_ZYX)
+            {
+                return ((a.z != b.z) ? (a.z < b.z) : ((a.y != b.y) ? (a.y < b.y) : (a.x < b.x)));
+            }
+            else if (score == EP_SCORE_XZY)
+            {
+                return ((a.x != b.x) ? (a.x < b.x) : ((a.z != b.z) ? (a.z < b.z) : (a.y < b.y)));
+            }
+            else if (score == EP_SCORE_SUM)
+            {
+                uint32_t sa = (uint32_t)a.x + a.y + a.z;
+                uint32_t sb = (uint32_t)b.x + b.y + b.z;
+
+                if (sa != sb)
+                {
+                    return (sa < sb);
+                }
+            }
+
+            // EP_SCORE_ZXY, y desempate de EP_SCORE_SUM.
+            return (height_map_t::is_better_position(a, b));
+
+        }   /* is_better() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade un punto en su sitio si está dentro de la caja y no
+         *         está repetido.
+         */
+        void
+        add_point(point_t p, space_t boxSize)
+        {
+            if ((p.x >= boxSize.max_x()) || (p.y >= boxSize.max_y()) || (p.z >= boxSize.max_z()))
+            {
+                return;
+            }
+
+            epScore_t order = score;
+            vector<point_t>::iterator it = lower_bound(points.begin(), points.end(), p,
+                                                       [order](point_t a, point_t b)
+                                                       {
+                                                           return (is_better(a, b, order));
+                                                       });
+
+            if ((it != points.end()) && (it->x == p.x) && (it->y == p.y) && (it->z == p.z))
+            {
+                return;
+            }
+
+            points.insert(it, p);
+
+        }   /* add_point() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Actualiza los puntos tras colocar un item: quita los que han
+         *         quedado dentro del item y añade los de sus esquinas.
+         * @param  placedSpace  El item colocado.
+         * @param  placed       Todos los items colocados (para las proyecciones).
+         * @param  boxSize      El tamaño interior de la caja.
+         */
+        void
+        update_points(space_t placedSpace, const pmr::vector<space_t> & placed, space_t boxSize)
+        {
+            point_t corners[3];
+
+            // remove_if() conserva el orden de los puntos que quedan.
+            points.erase(remove_if(points.begin(), points.end(),
+                                   [placedSpace](point_t p) { return (is_inside(p, placedSpace)); }),
+                         points.end());
+
+            corners[0].x = placedSpace.max_x(); corners[0].y = placedSpace.min_y(); corners[0].z = placedSpace.min_z();
+            corners[1].x = placedSpace.min_x(); corners[1].y = placedSpace.max_y(); corners[1].z = placedSpace.min_z();
+            corners[2].x = placedSpace.min_x(); corners[2].y = placedSpace.min_y(); corners[2].z = placedSpace.max_z();
+
+            for (int c = 0; c < 3; c++)
+            {
+                add_point(corners[c], boxSize);
+
+                // Proyecciones en los dos ejes distintos del que define la esquina.
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    if (axis != c)
+                    {
+                        add_point(project(corners[c], axis, placed), boxSize);
+                    }
+                }
+            }
+
+        }   /* update_points() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase extreme_points_strategy_t.
+         * @param  score  El orden en que se prueban los puntos.
+         */
+        extreme_points_strategy_t(epScore_t score = EP_SCORE_ZXY)
+        {
+            this->score = score;
+            this->attempts = 0;
+
+        }   /* extreme_points_strategy_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de la estrategia.
+         * @param  void
+         * @return El nombre.
+         */
+        const char *
+        get_name(void)
+        {
+            return "extreme-points";
+
+        }   /* get_name() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de posiciones validadas en place().
+         * @param  void
+         * @return Número de posiciones.
+         */
+        size_t
+        get_attempts(void)
+        {
+            return attempts;
+
+        }   /* get_attempts() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula los puntos extremos de un conjunto de items colocados,
+         *         como los tendría place() después de colocarlos en ese orden
+         *         (para búsquedas que no pasan por place()).
+         * @param  placed   Los items colocados.
+         * @param  boxSize  El tamaño interior de la caja.
+         * @param  score    El orden de los puntos.
+         * @param  points   Devuelve los puntos, de mejor a peor.
+         * @return void
+         */
+        static void
+        points_of(const pmr::vector<space_t> & placed, space_t boxSize, epScore_t score,
+                  vector<point_t> * points)
+        {
+            extreme_points_strategy_t strategy(score);
+            point_t origin = {0, 0, 0};
+
+            strategy.points.swap(*points);
+            strategy.points.clear();
+            strategy.points.push_back(origin);
+
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                strategy.update_points(placed[i], placed, boxSize);
+            }
+
+            points->swap(strategy.points);
+
+        }   /* points_of() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca cada item, en el orden de itemsToPlace, en la mejor
+         *         posición válida de entre todos los puntos extremos.
+         * @param  job  El trabajo de colocación.
+         * @return void
+         */
+        void
+        place(placement_job_t * job)
+        {
+            traceln(EXTREME_POINTS_TAG, "place()");
+
+            point_t origin;
+            origin.x = 0;
+            origin.y = 0;
+            origin.z = 0;
+
+            points.clear();
+            points.push_back(origin);
+            attempts = 0;
+
+            // Los items ya colocados (si los hay) también generan puntos.
+            for (size_t i = 0; i < job->validator->get_placed().size(); i++)
+            {
+                update_points(job->validator->get_placed()[i], job->validator->get_placed(), job->boxSize);
+            }
+
+            failed_skus_t failed;
+            pmr::list<item_t>::iterator it = job->itemsToPlace->begin();
+            while ((it != job->itemsToPlace->end()) && !(job->isCancelled()))
+            {
+                // Mientras no se coloque nada, las copias de un SKU que no ha
+                // cabido tampoco caben.
+                if (failed.contains(it->get_sku()))
+                {
+                    ++it;
+                    continue;
+                }
+
+                point_t best = origin;
+                space_t bestSpace;
+                bool found = false, bestRotated = false;
+
+                for (int r = 0; r < num_orientations(job, it); r++)
+                {
+                    space_t itemSize = oriented_size(it, (r == 1));
+
+                    // Los puntos van de mejor a peor: el primero válido es el
+                    // mejor de esta orientación, y ninguno detrás de best
+                    // puede mejorar la otra.
+                    for (size_t i = 0; (i < points.size()) &&
+                         ((found == false) || is_better(points[i], best, score)); i++)
+                    {
+                        space_t candidate = itemSize + points[i];
+
+                        if ((candidate.max_x() > job->boxSize.max_x()) ||
+                            (candidate.max_y() > job->boxSize.max_y()) ||
+                            (candidate.max_z() > job->boxSize.max_z()))
+                        {
+                            continue;
+                        }
+
+                        attempts++;
+                        if (job->validator->is_valid(candidate))
+                        {
+                            best = points[i];
+                            bestSpace = candidate;
+                            bestRotated = (r == 1);
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (found)
+                {
+                    it = commit(job, it, bestSpace, bestRotated);
+                    update_points(bestSpace, job->validator->get_placed(), job->boxSize);
+                    failed.clear();
+                }
+                else
+                {
+                    failed.add(it->get_sku());
+                    ++it;
+                }
+            }
+
+            traceln(EXTREME_POINTS_TAG, "place() - END");
+
+        }   /* place() */
+};
+
+#endif /* EXTREME_POINTS_STRATEGY_T_H */
+
+/*** end of file ***/
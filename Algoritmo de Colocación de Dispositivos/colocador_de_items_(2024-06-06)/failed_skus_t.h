@@ -0,0 +1,112 @@
+/**
+ * @file     failed_skus_t.h
+ *
+ * @brief    SKUs que no han encontrado posición desde el último cambio de la
+ *           caja.
+ *
+ * Dos items con el mismo SKU tienen el mismo tamaño y las mismas reglas de
+ * giro, así que, mientras no se coloque nada, si una copia no cabe en una
+ * posición (o en ninguna), las demás copias tampoco. Los motores apuntan aquí
+ * cada SKU que falla y se saltan sus copias hasta el siguiente cambio: cada
+ * grupo (SKU, copias) se prueba una sola vez por posición, en lugar de una vez
+ * por copia.
+ *
+ * Un pedido tiene pocos SKUs distintos; se guardan en un array fijo, sin
+ * reservas de memoria. Si se llena, los SKUs que no caben simplemente no se
+ * apuntan (sus copias se vuelven a probar, como sin esta clase).
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la agrupación por SKU
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef FAILED_SKUS_T_H
+#define FAILED_SKUS_T_H
+
+#include <cstddef>
+#include <cstdint>
+#include "defines.h"
+
+using namespace std;
+
+// Máximo de SKUs distintos que se apuntan a la vez.
+#define FAILED_SKUS_CAPACITY 32
+
+class failed_skus_t
+{
+    private:
+
+        // ATRIBUTOS.
+        uint16_t skus[FAILED_SKUS_CAPACITY];
+        size_t count;
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase failed_skus_t.
+         * @param  void
+         */
+        failed_skus_t(void)
+        {
+            this->count = 0;
+
+        }   /* failed_skus_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Olvida todos los SKUs (la caja ha cambiado).
+         * @param  void
+         * @return void
+         */
+        void
+        clear(void)
+        {
+            count = 0;
+
+        }   /* clear() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Apunta que una copia del SKU no ha encontrado posición.
+         * @param  sku  El índice del SKU (item_t::get_sku()).
+         * @return void
+         */
+        void
+        add(uint16_t sku)
+        {
+            if (count < FAILED_SKUS_CAPACITY)
+            {
+                skus[count++] = sku;
+            }
+
+        }   /* add() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si ya ha fallado alguna copia del SKU.
+         * @param  sku  El índice del SKU (item_t::get_sku()).
+         * @return Verdadero si se puede saltar el item.
+         */
+        bool
+        contains(uint16_t sku) const
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (skus[i] == sku)
+                {
+                    return (true);
+                }
+            }
+
+            return (false);
+
+        }   /* contains() */
+};
+
+#endif /* FAILED_SKUS_T_H */
+
+/*** end of file ***/
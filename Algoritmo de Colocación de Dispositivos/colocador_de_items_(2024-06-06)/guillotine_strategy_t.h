@@ -0,0 +1,191 @@
+/**
+ * @file     guillotine_strategy_t.h
+ *
+ * @brief    Estrategia de colocación por cortes de guillotina.
+ *
+ * El volumen libre se guarda como una lista de cajas disjuntas que empieza
+ * con la caja entera. Cada item se coloca en la esquina mínima de la caja
+ * libre que da la posición más baja (menor z, luego menor x y luego menor y)
+ * y esa caja se parte con tres cortes: lo que queda a la derecha del item
+ * (todo el fondo y toda la altura), lo que queda delante (solo el ancho del
+ * item) y lo que queda encima (solo la huella del item). Así el suelo de toda
+ * caja libre está siempre apoyado por completo.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de cortes de guillotina
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef GUILLOTINE_STRATEGY_T_H
+#define GUILLOTINE_STRATEGY_T_H
+
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "height_map_t.h"
+#include "placement_strategy_t.h"
+
+using namespace std;
+
+// static const char * GUILLOTINE_TAG = __FILE__;
+static const char * GUILLOTINE_TAG = "guillotine_strategy_t.h";
+
+class guillotine_strategy_t : public placement_strategy_t
+{
+    private:
+
+        // ATRIBUTOS.
+        vector<space_t> freeSpaces;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade una caja libre si no está vacía.
+         */
+        void
+        add_free(uint16_t x0, uint16_t y0, uint16_t z0, uint16_t x1, uint16_t y1, uint16_t z1)
+        {
+            if ((x0 < x1) && (y0 < y1) && (z0 < z1))
+            {
+                freeSpaces.push_back(space_t(x0, y0, z0, x1, y1, z1));
+            }
+
+        }   /* add_free() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Parte la caja libre index tras colocar un item en su esquina mínima.
+         */
+        void
+        split(size_t index, space_t placed)
+        {
+            space_t f = freeSpaces[index];
+
+            freeSpaces[index] = freeSpaces.back();
+            freeSpaces.pop_back();
+
+            // Derecha: todo el fondo y toda la altura de la caja libre.
+            add_free(placed.max_x(), f.min_y(), f.min_z(), f.max_x(), f.max_y(), f.max_z());
+
+            // Delante: solo el ancho del item.
+            add_free(f.min_x(), placed.max_y(), f.min_z(), placed.max_x(), f.max_y(), f.max_z());
+
+            // Encima: solo la huella del item (queda apoyada sobre él).
+            add_free(f.min_x(), f.min_y(), placed.max_z(), placed.max_x(), placed.max_y(), f.max_z());
+
+        }   /* split() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de la estrategia.
+         * @param  void
+         * @return El nombre.
+         */
+        const char *
+        get_name(void)
+        {
+            return "guillotine";
+
+        }   /* get_name() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca cada item, en el orden de itemsToPlace, en la caja libre
+         *         que da la posición más baja.
+         * @param  job  El trabajo de colocación.
+         * @return void
+         */
+        void
+        place(placement_job_t * job)
+        {
+            traceln(GUILLOTINE_TAG, "place()");
+
+            freeSpaces.clear();
+
+            // Si ya hay items colocados no se puede partir el volumen con
+            // cortes de guillotina: se deja todo en itemsToPlace.
+            if (job->validator->get_placed().empty())
+            {
+                freeSpaces.push_back(job->boxSize);
+            }
+
+            failed_skus_t failed;
+            pmr::list<item_t>::iterator it = job->itemsToPlace->begin();
+            while ((it != job->itemsToPlace->end()) && !(job->isCancelled()))
+            {
+                point_t best = {0, 0, 0};
+                space_t bestSpace;
+                size_t bestIndex = 0;
+                bool found = false, bestRotated = false;
+
+                // Mientras no se coloque nada, las copias de un SKU que no ha
+                // cabido tampoco caben.
+                if (failed.contains(it->get_sku()))
+                {
+                    ++it;
+                    continue;
+                }
+
+                for (int r = 0; r < num_orientations(job, it); r++)
+                {
+                    space_t itemSize = oriented_size(it, (r == 1));
+
+                    for (size_t i = 0; i < freeSpaces.size(); i++)
+                    {
+                        space_t f = freeSpaces[i];
+                        point_t corner;
+
+                        corner.x = f.min_x();
+                        corner.y = f.min_y();
+                        corner.z = f.min_z();
+
+                        if (((f.max_x() - f.min_x()) < itemSize.max_x()) ||
+                            ((f.max_y() - f.min_y()) < itemSize.max_y()) ||
+                            ((f.max_z() - f.min_z()) < itemSize.max_z()))
+                        {
+                            continue;
+                        }
+
+                        if ((found == false) || height_map_t::is_better_position(corner, best))
+                        {
+                            space_t candidate = itemSize + corner;
+
+                            if (job->validator->is_valid(candidate))
+                            {
+                                best = corner;
+                                bestSpace = candidate;
+                                bestIndex = i;
+                                bestRotated = (r == 1);
+                                found = true;
+                            }
+                        }
+                    }
+                }
+
+                if (found)
+                {
+                    it = commit(job, it, bestSpace, bestRotated);
+                    split(bestIndex, bestSpace);
+                    failed.clear();
+                }
+                else
+                {
+                    failed.add(it->get_sku());
+                    ++it;
+                }
+            }
+
+            traceln(GUILLOTINE_TAG, "place() - END");
+
+        }   /* place() */
+};
+
+#endif /* GUILLOTINE_STRATEGY_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,251 @@
+/**
+ * @file     height_map_t.h
+ *
+ * @brief    Mapa de alturas del suelo de la caja (motor de colocación alternativo).
+ *
+ * El suelo de la caja se divide en celdas de HEIGHT_MAP_CELL mm y en cada celda
+ * se guarda la altura (en celdas) del dispositivo más alto colocado encima. El
+ * apoyo, la colisión y el siguiente punto de origen se resuelven con operaciones
+ * sobre las celdas que ocupa cada dispositivo, sin fusionar listas de espacios.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del mapa de alturas
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef HEIGHT_MAP_T_H
+#define HEIGHT_MAP_T_H
+
+#include <string.h>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+
+using namespace std;
+
+// static const char * HEIGHT_MAP_TAG = __FILE__;
+static const char * HEIGHT_MAP_TAG = "height_map_t.h";
+
+// Resolución del mapa (mm). Todas las medidas de cajas y dispositivos son múltiplos.
+#define HEIGHT_MAP_CELL 5
+
+// Dimensiones máximas del suelo en celdas (caja L: 480 x 300 mm).
+#define HEIGHT_MAP_MAX_X (480 / HEIGHT_MAP_CELL)
+#define HEIGHT_MAP_MAX_Y (300 / HEIGHT_MAP_CELL)
+
+class height_map_t
+{
+    private:
+
+        // ATRIBUTOS.
+        uint8_t height[HEIGHT_MAP_MAX_Y][HEIGHT_MAP_MAX_X]; // en celdas
+        uint16_t cellsX, cellsY, cellsZ;
+        pmr::vector<uint16_t> candidatesX; // esquinas posibles (en celdas)
+        pmr::vector<uint16_t> candidatesY;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade un valor a una lista ordenada de candidatos si no existe.
+         */
+        static void
+        add_candidate(pmr::vector<uint16_t> * candidates, uint16_t value)
+        {
+            pmr::vector<uint16_t>::iterator it = lower_bound(candidates->begin(), candidates->end(), value);
+
+            if ((it == candidates->end()) || (*it != value))
+            {
+                candidates->insert(it, value);
+            }
+
+        }   /* add_candidate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Comprueba si el rectángulo [x, x + w) x [y, y + h) del mapa es
+         *         plano, es decir, todas sus celdas tienen la misma altura.
+         * @param  z  Devuelve la altura común de las celdas.
+         * @return Verdadero si el rectángulo es plano.
+         */
+        bool
+        is_flat(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t * z)
+        {
+            uint8_t level = height[y][x];
+
+            for (uint16_t j = y; j < (y + h); j++)
+            {
+                const uint8_t * row = height[j];
+
+                for (uint16_t i = x; i < (x + w); i++)
+                {
+                    if (row[i] != level)
+                    {
+                        return (false);
+                    }
+                }
+            }
+
+            *z = level;
+            return (true);
+
+        }   /* is_flat() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase height_map_t.
+         * @param  resource  De donde salen las listas de candidatos.
+         */
+        height_map_t(pmr::memory_resource * resource = pmr::get_default_resource()) :
+            candidatesX(resource), candidatesY(resource)
+        {
+            traceln(HEIGHT_MAP_TAG, "height_map_t()");
+            reset(space_t(0, 0, 0, 480, 300, 240));
+            traceln(HEIGHT_MAP_TAG, "height_map_t() - END");
+
+        }   /* height_map_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vacía el mapa y lo ajusta a las dimensiones de la caja.
+         * @param  boxSize  El tamaño interior de la caja.
+         * @return void
+         */
+        void
+        reset(space_t boxSize)
+        {
+            traceln(HEIGHT_MAP_TAG, "reset()");
+
+            cellsX = boxSize.max_x() / HEIGHT_MAP_CELL;
+            cellsY = boxSize.max_y() / HEIGHT_MAP_CELL;
+            cellsZ = boxSize.max_z() / HEIGHT_MAP_CELL;
+
+            memset(height, 0, sizeof(height));
+
+            candidatesX.assign(1, 0);
+            candidatesY.assign(1, 0);
+
+            traceln(HEIGHT_MAP_TAG, "reset() - END");
+
+        }   /* reset() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca la posición más baja (y después con menor x e y) en la que
+         *         el item cabe apoyado por completo sobre una superficie plana.
+         * @param  itemSize  El tamaño del item (con origen en 0, 0, 0).
+         * @param  origin    Devuelve el punto de origen encontrado (en mm).
+         * @return Verdadero si se ha encontrado una posición válida.
+         */
+        bool
+        find_position(space_t itemSize, point_t * origin)
+        {
+            traceln(HEIGHT_MAP_TAG, "find_position()");
+
+            uint16_t w = itemSize.max_x() / HEIGHT_MAP_CELL;
+            uint16_t h = itemSize.max_y() / HEIGHT_MAP_CELL;
+            uint16_t d = itemSize.max_z() / HEIGHT_MAP_CELL;
+            uint16_t bestZ = cellsZ + 1, z;
+            bool found = false;
+
+            for (size_t i = 0; i < candidatesX.size(); i++)
+            {
+                uint16_t x = candidatesX[i];
+
+                if ((x + w) > cellsX)
+                {
+                    break; // Los candidatos están ordenados.
+                }
+
+                for (size_t j = 0; j < candidatesY.size(); j++)
+                {
+                    uint16_t y = candidatesY[j];
+
+                    if ((y + h) > cellsY)
+                    {
+                        break;
+                    }
+
+                    // Solo interesa si mejora la altura encontrada hasta ahora.
+                    if ((height[y][x] < bestZ) && is_flat(x, y, w, h, &z) && ((z + d) <= cellsZ))
+                    {
+                        bestZ = z;
+                        origin->x = x * HEIGHT_MAP_CELL;
+                        origin->y = y * HEIGHT_MAP_CELL;
+                        origin->z = z * HEIGHT_MAP_CELL;
+                        found = true;
+                    }
+                }
+            }
+
+            traceln(HEIGHT_MAP_TAG, "find_position() - END");
+            return (found);
+
+        }   /* find_position() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Compara dos posiciones con el mismo criterio que find_position():
+         *         menor altura y, a igual altura, menor x y después menor y.
+         * @param  a  La primera posición.
+         * @param  b  La segunda posición.
+         * @return Verdadero si a es mejor que b.
+         */
+        static bool
+        is_better_position(point_t a, point_t b)
+        {
+            if (a.z != b.z)
+            {
+                return (a.z < b.z);
+            }
+
+            if (a.x != b.x)
+            {
+                return (a.x < b.x);
+            }
+
+            return (a.y < b.y);
+
+        }   /* is_better_position() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Marca en el mapa el volumen ocupado por un item ya colocado.
+         * @param  placed  La posición del item dentro de la caja.
+         * @return void
+         */
+        void
+        place(space_t placed)
+        {
+            traceln(HEIGHT_MAP_TAG, "place()");
+
+            uint16_t x0 = placed.min_x() / HEIGHT_MAP_CELL, x1 = placed.max_x() / HEIGHT_MAP_CELL;
+            uint16_t y0 = placed.min_y() / HEIGHT_MAP_CELL, y1 = placed.max_y() / HEIGHT_MAP_CELL;
+            uint8_t top = placed.max_z() / HEIGHT_MAP_CELL;
+
+            for (uint16_t j = y0; j < y1; j++)
+            {
+                for (uint16_t i = x0; i < x1; i++)
+                {
+                    height[j][i] = std::max(height[j][i], top);
+                }
+            }
+
+            // Las caras positivas del item son nuevas esquinas candidatas.
+            add_candidate(&candidatesX, x1);
+            add_candidate(&candidatesY, y1);
+
+            traceln(HEIGHT_MAP_TAG, "place() - END");
+
+        }   /* place() */
+};
+
+#endif /* HEIGHT_MAP_T_H */
+
+/*** end of file ***/
@@ -22,102 +22,280 @@
 #define ITEM_T_H
 
 #include <string>
+#include <string.h>
+#include <type_traits>
 #include "defines.h"
 #include "logger.h"
 #include "space_t.h"
+#include "sku_registry_t.h"
 
 using namespace std;
 
 // static const char * ITEM_TAG = __FILE__;
 static const char * ITEM_TAG = "item_t.h";
 
+// Palabras de los identificadores que determinan el tipo de item.
+#define SKU_WORD_PULSERA  0x01
+#define SKU_WORD_RELOJ    0x02
+#define SKU_WORD_TELEFONO 0x04
+#define SKU_WORD_EREADER  0x08
+#define SKU_WORD_TABLET   0x10
+#define SKU_WORD_FUNDA    0x20
+#define SKU_NUM_FAMILIES  5    // las cinco primeras (todas menos funda)
+
+typedef struct
+{
+    const char * word;
+    uint8_t length;
+    uint8_t bit;
+
+} sku_word_t;
+
+// Hash perfecto de las seis palabras: cada una cae en una casilla distinta.
+static constexpr uint8_t
+sku_word_hash(const char * word, size_t length)
+{
+    return ((uint8_t)(((uint8_t)word[0] + (uint8_t)word[length - 1] + (2 * length)) & 7));
+}
+
+static constexpr sku_word_t SKU_WORDS[8] =
+{
+    {"",         0, 0},
+    {"funda",    5, SKU_WORD_FUNDA},
+    {"",         0, 0},
+    {"telefono", 8, SKU_WORD_TELEFONO},
+    {"tablet",   6, SKU_WORD_TABLET},
+    {"ereader",  7, SKU_WORD_EREADER},
+    {"reloj",    5, SKU_WORD_RELOJ},
+    {"pulsera",  7, SKU_WORD_PULSERA}
+};
+
+static_assert((sku_word_hash("funda", 5) == 1) && (sku_word_hash("telefono", 8) == 3) &&
+              (sku_word_hash("tablet", 6) == 4) && (sku_word_hash("ereader", 7) == 5) &&
+              (sku_word_hash("reloj", 5) == 6) && (sku_word_hash("pulsera", 7) == 7),
+              "SKU_WORDS no coincide con sku_word_hash()");
+
+// Tipo de cada familia (en orden de prioridad) sin y con funda.
+static constexpr itemType_t SKU_FAMILY_TYPE[SKU_NUM_FAMILIES] = {PULSERA, RELOJ, TELEFONO, EREADER, TABLET};
+static constexpr itemType_t SKU_FAMILY_FUNDA[SKU_NUM_FAMILIES] = {PULSERA, RELOJ, FUNDA_TELEFONO,
+                                                                   FUNDA_EREADER, FUNDA_TABLET};
+
+// Resultado de sku_classify() para un identificador que no es ningún tipo.
+#define SKU_TYPE_NONE (-1)
+
+/******************************************************************************/
+/*!
+ * @brief  Indica si word aparece en id a partir de la posición from.
+ */
+static constexpr bool
+sku_match(const char * id, size_t length, size_t from, const char * word, size_t wordLength)
+{
+    if ((from + wordLength) > length)
+    {
+        return (false);
+    }
+
+    for (size_t c = 0; c < wordLength; c++)
+    {
+        if (id[from + c] != word[c])
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/******************************************************************************/
+/*!
+ * @brief  Indica si word es una subcadena de id.
+ */
+static constexpr bool
+sku_contains(const char * id, size_t length, const char * word, size_t wordLength)
+{
+    for (size_t from = 0; (from + wordLength) <= length; from++)
+    {
+        if (sku_match(id, length, from, word, wordLength))
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/******************************************************************************/
+/*!
+ * @brief  Tipo de item de un identificador, con las reglas de las subcadenas
+ *         del item_t original: gana la primera familia de SKU_FAMILY_TYPE que
+ *         aparezca en cualquier parte del identificador, y es una funda si
+ *         "funda" aparece en cualquier parte.
+ *
+ * Las palabras separadas por '_' se buscan primero con sku_word_hash(). El
+ * resultado solo depende de la familia de más prioridad y de "funda", así que
+ * después solo se buscan como subcadenas "funda" (si no ha salido) y las
+ * familias de más prioridad que la encontrada.
+ * @return El itemType_t, o SKU_TYPE_NONE.
+ */
+static constexpr int
+sku_classify(const char * id, size_t length)
+{
+    size_t first = 0;
+    uint8_t words = 0;
+    int family = 0;
+
+    // 1) Palabras enteras.
+    for (size_t i = 0; i <= length; i++)
+    {
+        if ((i < length) && (id[i] != '_'))
+        {
+            continue;
+        }
+
+        size_t wordLength = i - first;
+        if ((wordLength >= 5) && (wordLength <= 8))
+        {
+            const sku_word_t & candidate = SKU_WORDS[sku_word_hash(id + first, wordLength)];
+
+            if ((candidate.length == wordLength) && sku_match(id, length, first, candidate.word, wordLength))
+            {
+                words |= candidate.bit;
+            }
+        }
+        first = i + 1;
+    }
+
+    // 2) Subcadenas que todavía pueden cambiar el resultado.
+    if (!(words & SKU_WORD_FUNDA) && sku_contains(id, length, "funda", 5))
+    {
+        words |= SKU_WORD_FUNDA;
+    }
+
+    for (size_t w = 0; w < 8; w++)
+    {
+        uint8_t bit = SKU_WORDS[w].bit;
+
+        if ((bit != 0) && (bit < SKU_WORD_FUNDA) && !(words & bit) && ((words & (bit - 1)) == 0) &&
+            sku_contains(id, length, SKU_WORDS[w].word, SKU_WORDS[w].length))
+        {
+            words |= bit;
+        }
+    }
+
+    // 3) La familia de más prioridad.
+    for (family = 0; family < SKU_NUM_FAMILIES; family++)
+    {
+        if (words & (1 << family))
+        {
+            return ((words & SKU_WORD_FUNDA) ? (SKU_FAMILY_FUNDA[family]) : (SKU_FAMILY_TYPE[family]));
+        }
+    }
+
+    return (SKU_TYPE_NONE);
+}
+
+// El mismo tipo que el item_t original, también cuando la palabra de la
+// familia o "funda" no es una palabra entera.
+static_assert((sku_classify("tablet_A_01", 11) == TABLET) &&
+              (sku_classify("telefono_B_funda", 16) == FUNDA_TELEFONO) &&
+              (sku_classify("ereader_A_funda", 15) == FUNDA_EREADER) &&
+              (sku_classify("pulsera_B_01", 12) == PULSERA) &&
+              (sku_classify("reloj_funda", 11) == RELOJ) &&
+              (sku_classify("telefono_A_fundas", 17) == FUNDA_TELEFONO) &&
+              (sku_classify("smartpulsera_telefono", 21) == PULSERA) &&
+              (sku_classify("smartreloj_X", 12) == RELOJ) &&
+              (sku_classify("tablet_telefono", 15) == TELEFONO) &&
+              (sku_classify("ebook_tabletfunda", 17) == FUNDA_TABLET) &&
+              (sku_classify("portatil_01", 11) == SKU_TYPE_NONE),
+              "sku_classify() no coincide con las reglas de item_t");
+
+// Bits de item_t::flags.
+#define ITEM_FLAG_ROTATED 0x01 // girado 90º sobre z dentro de la caja
+#define ITEM_FLAG_UNKNOWN 0x02 // identificador sin tipo: tamaño nulo
+#define ITEM_FLAG_UNREGISTERED 0x04 // sin sitio en sku_registry_t: sin identificador
+
 class item_t
 {
     private:
 
-        // ATRIBUTOS.
-        string item_id;
-        itemType_t type;
-        space_t size;
-        space_t posInBox;
-        string target_str; // posición + orientación
+        // ATRIBUTOS. El identificador está en sku_registry_t y el tamaño en
+        // SKU_CATALOG; la pose para el robot se calcula al generar la orden.
+        uint16_t sku;   // índice en sku_registry_t
+        uint8_t type;   // itemType_t
+        uint8_t flags;  // ITEM_FLAG_*
+        point_t pos;    // esquina mínima dentro de la caja
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca en el catálogo el tipo de item de un identificador (ver
+         *         sku_classify()).
+         * @param  item_id  El identificador del item.
+         * @return La entrada de SKU_CATALOG, o NULL si no es ningún tipo.
+         */
+        static const sku_catalog_entry_t *
+        find_sku(const string & item_id)
+        {
+            int type = sku_classify(item_id.c_str(), item_id.size());
+
+            return ((type != SKU_TYPE_NONE) ? (&(SKU_CATALOG[type])) : (NULL));
+
+        }   /* find_sku() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Clasifica un identificador nuevo para sku_registry_t.
+         * @param  item_id  El identificador del item.
+         * @return El itemType_t, o SKU_INFO_UNKNOWN si no es ningún tipo.
+         */
+        static uint8_t
+        classify(const string & item_id)
+        {
+            const sku_catalog_entry_t * sku = find_sku(item_id);
+
+            return ((sku != NULL) ? ((uint8_t)(sku->type)) : ((uint8_t)SKU_INFO_UNKNOWN));
+
+        }   /* classify() */
 
     public:
         
         /******************************************************************************/
         /*!
-         * @brief  El constructor de la clase item_t.
+         * @brief  El constructor de la clase item_t. Solo la primera vez que
+         *         aparece un identificador se busca su tipo en el catálogo.
          * @param  item_id  Indica qué tipo/modelo/variante de item es.
          */
-        item_t(string item_id)
+        item_t(const string & item_id)
         {
             traceln(ITEM_TAG, "item_t()");
-            this->item_id = item_id;
 
-            if (item_id.find("pulsera") != string::npos) 
-            {
-                this->type = PULSERA;
-                this->size.set_space(0, 0, 0, 80, 75, 30);
-            }
-            else if (item_id.find("reloj") != string::npos)
-            {
-                this->type = RELOJ;
-                this->size.set_space(0, 0, 0, 80, 75, 60);
-            }
-            else if ((item_id.find("telefono") != string::npos) && (item_id.find("funda") != string::npos))
-            {
-                this->type = FUNDA_TELEFONO;
-                this->size.set_space(0, 0, 0, 80, 150, 20);
-            }
-            else if (item_id.find("telefono") != string::npos)
-            {
-                this->type = TELEFONO;
-                this->size.set_space(0, 0, 0, 80, 150, 60);
-            }
-            else if ((item_id.find("ereader") != string::npos) && (item_id.find("funda") != string::npos))
-            {
-                this->type = FUNDA_EREADER;
-                this->size.set_space(0, 0, 0, 120, 150, 20);
-            }
-            else if (item_id.find("ereader") != string::npos)
-            {
-                this->type = EREADER;
-                this->size.set_space(0, 0, 0, 120, 150, 40);
-            }
-            else if ((item_id.find("tablet") != string::npos) && (item_id.find("funda") != string::npos))
-            {
-                this->type = FUNDA_TABLET;
-                this->size.set_space(0, 0, 0, 240, 150, 20);
-            }
-            else if (item_id.find("tablet") != string::npos)
+            sku_registry_t & registry = sku_registry_t::instance();
+            this->sku = registry.intern(item_id, classify);
+
+            uint8_t info = (this->sku != SKU_REGISTRY_FULL) ? (registry.get_info(this->sku)) :
+                                                              ((uint8_t)SKU_INFO_UNKNOWN);
+
+            if (info != SKU_INFO_UNKNOWN)
             {
-                this->type = TABLET;
-                this->size.set_space(0, 0, 0, 240, 150, 40);
+                this->type = info;
+                this->flags = 0;
             }
             else
             {
-                ;
+                // Identificador desconocido (o registro lleno): tamaño nulo y
+                // agarre centrado.
+                this->type = TABLET;
+                this->flags = (this->sku != SKU_REGISTRY_FULL) ? (ITEM_FLAG_UNKNOWN) :
+                                                                 (ITEM_FLAG_UNKNOWN | ITEM_FLAG_UNREGISTERED);
             }
 
-            this->posInBox = this->size;
-            this->target_str = "";
+            this->pos.x = 0;
+            this->pos.y = 0;
+            this->pos.z = 0;
 
             traceln(ITEM_TAG, "item_t() - END");
         
         }   /* item_t() */
 
-        /******************************************************************************/
-        /*!
-         * @brief  El destructor de la clase item_t.
-         * @param  void
-         */
-        ~item_t(void)
-        {
-            traceln(ITEM_TAG, "~item_t()");
-            traceln(ITEM_TAG, "~item_t() - END");
-            
-        }   /* ~item_t() */
-
         /******************************************************************************/
         /*!
          * @brief  Devuelve el atributo de size item_t.
@@ -125,57 +303,112 @@ class item_t
          * @return size  El atributo privado que indica el tamaño del item.
          */
         space_t
-        get_size(void)
+        get_size(void) const
         {
             traceln(ITEM_TAG, "get_size()");
             traceln(ITEM_TAG, "get_size() - END");
-            return size;
+
+            if (flags & ITEM_FLAG_UNKNOWN)
+            {
+                return space_t();
+            }
+
+            const sku_catalog_entry_t & entry = SKU_CATALOG[type];
+            return space_t(0, 0, 0, entry.x, entry.y, entry.z);
         
         }   /* get_size() */
 
         /******************************************************************************/
         /*!
-         * @brief  Devuelve el atributo posInBox de item_t.
+         * @brief  Devuelve el tamaño del item girado 90º sobre el eje z, es
+         *         decir, con las dimensiones x e y intercambiadas.
+         * @param  void
+         * @return El tamaño del item girado.
+         */
+        space_t
+        get_rotated_size(void) const
+        {
+            space_t size = get_size();
+
+            return space_t(0, 0, 0, size.max_y(), size.max_x(), size.max_z());
+
+        }   /* get_rotated_size() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si merece la pena probar el item girado (si la huella
+         *         es cuadrada, girarlo no cambia nada).
+         * @param  void
+         * @return Verdadero o falso.
+         */
+        bool
+        can_rotate(void) const
+        {
+            return (!(flags & ITEM_FLAG_UNKNOWN) && (SKU_CATALOG[type].x != SKU_CATALOG[type].y));
+
+        }   /* can_rotate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Método para modificar el atributo privado rotated de item_t.
+         * @param  rotated  Verdadero si el item se coloca girado 90º sobre z.
+         * @return void
+         */
+        void
+        set_rotated(bool rotated)
+        {
+            this->flags = (rotated) ? (flags | ITEM_FLAG_ROTATED) : (flags & ~ITEM_FLAG_ROTATED);
+
+        }   /* set_rotated() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el atributo rotated de item_t.
+         * @param  void
+         * @return Verdadero si el item está girado 90º sobre z.
+         */
+        bool
+        is_rotated(void) const
+        {
+            return ((flags & ITEM_FLAG_ROTATED) != 0);
+
+        }   /* is_rotated() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el espacio que ocupa el item en la caja: su tamaño,
+         *         en su orientación, desplazado a su posición.
          * @param  void
          * @return El valor de la posición del item en la caja.
          */
         space_t
-        get_posInBox(void)
+        get_posInBox(void) const
         {
             traceln(ITEM_TAG, "get_posInBox()");
             traceln(ITEM_TAG, "get_posInBox() - END");
-            return posInBox;
+            return (((is_rotated()) ? (get_rotated_size()) : (get_size())) + pos);
         
         }   /* get_posInBox() */
 
         /******************************************************************************/
         /*!
-         * @brief  Método para modificar el atributo privado posInBox de item_t.
-         * @param  posInBox  La variable space_t que se guardará en posInBox.
+         * @brief  Método para modificar la posición del item en la caja. Solo se
+         *         guarda la esquina mínima: el tamaño es el del item en su
+         *         orientación (ver set_rotated()).
+         * @param  newPosInBox  El espacio que ocupa el item en la caja.
          * @return void
          */
         void
         set_posInBox(space_t newPosInBox)
         {
             traceln(ITEM_TAG, "set_posInBox()");
-            this->posInBox = newPosInBox;
+            this->pos.x = newPosInBox.min_x();
+            this->pos.y = newPosInBox.min_y();
+            this->pos.z = newPosInBox.min_z();
             traceln(ITEM_TAG, "set_posInBox() - END");
 
         }   /* set_posInBox() */
 
-        /******************************************************************************/
-        /*!
-         * @brief  Método para modificar el atributo privado target_str de item_t.
-         * @param  target_str  La pose de TCP calculada.
-         * @return void
-         */
-        void
-        set_target_str(string target_str)
-        {
-            this->target_str = target_str;
-        
-        }   /* set_target_str() */ 
-
         /******************************************************************************/
         /*!
          * @brief  Devuelve el atributo type de item_t.
@@ -183,39 +416,105 @@ class item_t
          * @return El tipo de item.
          */
         itemType_t
-        get_type(void)
+        get_type(void) const
         {
-            return type;
+            return ((itemType_t)type);
         
         }   /* get_type() */
 
         /******************************************************************************/
         /*!
-         * @brief  Devuelve el atributo target_str de item_t.
+         * @brief  Devuelve el índice del item en sku_registry_t (dos items con el
+         *         mismo identificador tienen el mismo índice).
          * @param  void
-         * @return El objetivo TCP.
+         * @return El índice.
          */
-        string
-        get_target_str(void)
+        uint16_t
+        get_sku(void) const
         {
-            return target_str;
-        
-        }   /* get_target_str() */
+            return sku;
+
+        }   /* get_sku() */
 
         /******************************************************************************/
         /*!
-         * @brief  Devuelve el atributo item_id de item_t.
+         * @brief  Devuelve el identificador del item (no se copia).
          * @param  void
          * @return El identificador del item.
          */
-        string
-        get_item_id(void)
+        const string &
+        get_item_id(void) const
         {
-            return item_id;
+            static const string none;
+
+            return ((flags & ITEM_FLAG_UNREGISTERED) ? (none) : (sku_registry_t::instance().get_id(sku)));
 
         }   /* get_item_id() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si un identificador externo se puede aceptar en un
+         *         pedido: solo letras, dígitos y '_' (así se escribe tal cual en
+         *         la orden JSON) y con tipo en el catálogo. No se registra en
+         *         sku_registry_t, así que un identificador rechazado no ocupa
+         *         ningún índice.
+         * @param  item_id  El identificador.
+         * @return Verdadero si se puede crear un item_t conocido con él.
+         */
+        static bool
+        is_valid_id(const string & item_id)
+        {
+            for (size_t i = 0; i < item_id.size(); i++)
+            {
+                char c = item_id[i];
+
+                if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+                      ((c >= '0') && (c <= '9')) || (c == '_')))
+                {
+                    return (false);
+                }
+            }
+
+            return (find_sku(item_id) != NULL);
+
+        }   /* is_valid_id() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el identificador del item tiene tipo en el
+         *         catálogo. Si no, el item tiene tamaño nulo y no se puede
+         *         enviar al robot.
+         * @param  void
+         * @return Verdadero si el tipo del item es conocido.
+         */
+        bool
+        is_known(void) const
+        {
+            return (!(flags & ITEM_FLAG_UNKNOWN));
+
+        }   /* is_known() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el identificador del item está en sku_registry_t. Si
+         *         no (el registro estaba lleno), el item no tiene identificador
+         *         ni tamaño y no se puede colocar ni enviar al robot.
+         * @param  void
+         * @return Verdadero si el item tiene identificador.
+         */
+        bool
+        is_registered(void) const
+        {
+            return (!(flags & ITEM_FLAG_UNREGISTERED));
+
+        }   /* is_registered() */
 };
 
+// Los items se copian entre listas y cajas: tienen que ser registros pequeños
+// que se copian byte a byte.
+static_assert((sizeof(item_t) <= 16) && is_trivially_copyable<item_t>::value,
+              "item_t tiene que ser un registro compacto");
+
 #endif /* ITEM_T_H */
 
 /*** end of file ***/
\ No newline at end of file
@@ -0,0 +1,203 @@
+/**
+ * @file     layer_strategy_t.h
+ *
+ * @brief    Estrategia de colocación por capas de items de la misma altura.
+ *
+ * En el catálogo de SKU_CATALOG muchos items comparten altura (20 mm las
+ * fundas, 40 mm las tablets y los e-readers, 60 mm los teléfonos y los
+ * relojes), así que la caja se puede llenar apilando capas en las que todos
+ * los items tienen la misma altura. Cada capa es un problema de colocación en
+ * 2D, que se resuelve con los rectángulos maximales de maxrects_strategy_t.
+ *
+ * Para cada capa se prueban todas las alturas de los items que quedan (sin
+ * colocar nada) y se elige la que cubre más superficie del suelo de la capa;
+ * a igualdad, la más alta. Los items de una capa solo se apoyan en las capas
+ * de debajo y no se solapan entre sí, así que las posiciones validadas en la
+ * prueba de la capa elegida se registran tal cual, sin volver a calcularlas.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de capas por altura
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef LAYER_STRATEGY_T_H
+#define LAYER_STRATEGY_T_H
+
+#include <algorithm>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "placement_strategy_t.h"
+#include "maxrects_strategy_t.h"
+
+using namespace std;
+
+// static const char * LAYER_TAG = __FILE__;
+static const char * LAYER_TAG = "layer_strategy_t.h";
+
+class layer_strategy_t : public maxrects_strategy_t
+{
+    private:
+
+        // Un item de una capa de prueba, con su posición ya validada.
+        typedef struct
+        {
+            pmr::list<item_t>::iterator item;
+            space_t position;
+            bool rotated;
+
+        } layer_item_t;
+
+        // ATRIBUTOS.
+        vector<layer_item_t> trial;     // la capa que se está probando
+        vector<layer_item_t> bestLayer; // la mejor capa probada
+
+        /******************************************************************************/
+        /*!
+         * @brief  Prueba una capa con los items de una altura, sin colocar nada.
+         * @return La superficie cubierta por los items de la capa (en trial).
+         */
+        uint32_t
+        fill_layer(placement_job_t * job, uint16_t base, uint16_t height)
+        {
+            rect_t floor = {0, 0, job->boxSize.max_x(), job->boxSize.max_y()};
+            uint32_t area = 0;
+            failed_skus_t failed;
+
+            freeRects.clear();
+            freeRects.push_back(floor);
+            trial.clear();
+
+            pmr::list<item_t>::iterator it = job->itemsToPlace->begin();
+            while ((it != job->itemsToPlace->end()) && !(freeRects.empty()) && !(job->isCancelled()))
+            {
+                layer_item_t entry;
+
+                entry.item = it;
+                entry.rotated = false;
+
+                if ((it->get_size().max_z() != height) || failed.contains(it->get_sku()))
+                {
+                    ++it;
+                    continue;
+                }
+
+                if (find_best_fit(job, it, base, &(entry.position), &(entry.rotated)))
+                {
+                    rect_t used = {entry.position.min_x(), entry.position.min_y(),
+                                   entry.position.max_x(), entry.position.max_y()};
+
+                    area += (uint32_t)(used.x1 - used.x0) * (used.y1 - used.y0);
+                    subtract(used);
+                    trial.push_back(entry);
+                    failed.clear();
+                }
+                else
+                {
+                    failed.add(it->get_sku());
+                }
+
+                ++it;
+            }
+
+            return (area);
+
+        }   /* fill_layer() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de la estrategia.
+         * @param  void
+         * @return El nombre.
+         */
+        const char *
+        get_name(void)
+        {
+            return "layers";
+
+        }   /* get_name() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Apila capas de items de la misma altura, eligiendo en cada
+         *         una la altura que más superficie cubre.
+         * @param  job  El trabajo de colocación.
+         * @return void
+         */
+        void
+        place(placement_job_t * job)
+        {
+            traceln(LAYER_TAG, "place()");
+
+            uint16_t base = 0;
+            vector<uint16_t> heights;
+
+            // La primera capa empieza encima de lo que ya hubiera en la caja.
+            for (size_t i = 0; i < job->validator->get_placed().size(); i++)
+            {
+                space_t s = job->validator->get_placed()[i];
+                base = std::max(base, s.max_z());
+            }
+
+            while (!(job->itemsToPlace->empty()) && !(job->isCancelled()))
+            {
+                uint16_t bestHeight = 0;
+                uint32_t bestArea = 0;
+
+                // 1) Alturas de los items que quedan y que caben encima de base.
+                heights.clear();
+                for (pmr::list<item_t>::iterator it = job->itemsToPlace->begin();
+                    (it != job->itemsToPlace->end()); ++it)
+                {
+                    uint16_t height = it->get_size().max_z();
+
+                    if (((base + height) <= job->boxSize.max_z()) &&
+                        (find(heights.begin(), heights.end(), height) == heights.end()))
+                    {
+                        heights.push_back(height);
+                    }
+                }
+
+                // 2) Probar una capa de cada altura.
+                for (size_t h = 0; h < heights.size(); h++)
+                {
+                    uint32_t area = fill_layer(job, base, heights[h]);
+
+                    if ((area > bestArea) || ((area == bestArea) && (area > 0) && (heights[h] > bestHeight)))
+                    {
+                        bestArea = area;
+                        bestHeight = heights[h];
+                        bestLayer.swap(trial);
+                    }
+                }
+
+                // Si no entra ningún item, en las capas de encima tampoco.
+                if (bestArea == 0)
+                {
+                    break;
+                }
+
+                // 3) Colocar la capa elegida (splice() no invalida los
+                //    iteradores) y empezar la siguiente encima.
+                for (size_t i = 0; i < bestLayer.size(); i++)
+                {
+                    commit(job, bestLayer[i].item, bestLayer[i].position, bestLayer[i].rotated);
+                }
+                base += bestHeight;
+            }
+
+            traceln(LAYER_TAG, "place() - END");
+
+        }   /* place() */
+};
+
+#endif /* LAYER_STRATEGY_T_H */
+
+/*** end of file ***/
@@ -33,16 +33,57 @@
 #define FATAL 1
 #define NONE  0
 
+#ifndef LOG_LEVEL
 #define LOG_LEVEL NONE // levels on logger: TRACE, DEBUG, INFO, WARN, ERROR, FATAL, NONE
+#endif
+
+// 1 = los mensajes se guardan en el búfer circular de trace_ring_t.h en lugar
+// de imprimirse al momento (se vuelcan con trace_ring_t::dump()).
+#ifndef LOG_TO_RING
+#define LOG_TO_RING 0
+#endif
+
+// Verdadero si el nivel está activo. Es una constante: con el nivel
+// desactivado, el compilador elimina el bloque que protege.
+#define LOG_ENABLED(level) ( LOG_LEVEL >= (level) )
 
 #ifdef LOG_LEVEL
 
-#define traceln(tag, message) if ( LOG_LEVEL >= TRACE ) { printf("[TRACE] "); printf("%s: %s\n", tag, message); }
-#define debugln(tag, message) if ( LOG_LEVEL >= DEBUG ) { printf("[DEBUG] "); printf("%s: %s\n", tag, message); }
-#define infoln(tag, message)  if ( LOG_LEVEL >= INFO  ) { printf("[INFO] " ); printf("%s: %s\n", tag, message); }
-#define warnln(tag, message)  if ( LOG_LEVEL >= WARN  ) { printf("[WARN] " ); printf("%s: %s\n", tag, message); }
-#define errorln(tag, message) if ( LOG_LEVEL >= ERROR ) { printf("[ERROR] "); printf("%s: %s\n", tag, message); }
-#define fatalln(tag, message) if ( LOG_LEVEL >= FATAL ) { printf("[FATAL] "); printf("%s: %s\n", tag, message); }
+#if LOG_TO_RING
+
+#include "trace_ring_t.h"
+
+// En el búfer solo se guarda el puntero al mensaje: tiene que ser un literal
+// ("" message no compila si no lo es).
+#define LOG_LINE(level, label, tag, message) \
+    do { if (LOG_ENABLED(level)) { trace_ring_t::instance().record(level, tag, "" message); } } while (0)
+#define LOG_FORMAT(level, label, tag, ...) \
+    do { if (LOG_ENABLED(level)) { trace_ring_t::instance().record(level, tag, __VA_ARGS__); } } while (0)
+
+#else
+
+#define LOG_LINE(level, label, tag, message) \
+    do { if (LOG_ENABLED(level)) { printf("[" label "] "); printf("%s: %s\n", tag, message); } } while (0)
+#define LOG_FORMAT(level, label, tag, ...) \
+    do { if (LOG_ENABLED(level)) { printf("[" label "] %s: ", tag); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+#endif
+
+#define traceln(tag, message) LOG_LINE(TRACE, "TRACE", tag, message)
+#define debugln(tag, message) LOG_LINE(DEBUG, "DEBUG", tag, message)
+#define infoln(tag, message)  LOG_LINE(INFO,  "INFO",  tag, message)
+#define warnln(tag, message)  LOG_LINE(WARN,  "WARN",  tag, message)
+#define errorln(tag, message) LOG_LINE(ERROR, "ERROR", tag, message)
+#define fatalln(tag, message) LOG_LINE(FATAL, "FATAL", tag, message)
+
+// Versiones con formato de printf. Los argumentos solo se evalúan si el nivel
+// está activo; con LOG_TO_RING tienen que ser enteros y se formatean al volcar.
+#define tracef(tag, ...) LOG_FORMAT(TRACE, "TRACE", tag, __VA_ARGS__)
+#define debugf(tag, ...) LOG_FORMAT(DEBUG, "DEBUG", tag, __VA_ARGS__)
+#define infof(tag, ...)  LOG_FORMAT(INFO,  "INFO",  tag, __VA_ARGS__)
+#define warnf(tag, ...)  LOG_FORMAT(WARN,  "WARN",  tag, __VA_ARGS__)
+#define errorf(tag, ...) LOG_FORMAT(ERROR, "ERROR", tag, __VA_ARGS__)
+#define fatalf(tag, ...) LOG_FORMAT(FATAL, "FATAL", tag, __VA_ARGS__)
 
 #else
 #define traceln(message)
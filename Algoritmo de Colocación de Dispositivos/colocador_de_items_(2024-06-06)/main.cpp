@@ -20,12 +20,27 @@
  * @section  PR2-GIIROB
  */
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <list>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include "defines.h"
 #include "logger.h"
 #include "item_t.h"
 #include "box_t.h"
+#include "batch_packer_t.h"
+#include "order_stream_t.h"
+#include "box_selector_t.h"
+#include "multi_box_packer_t.h"
+#include "order_optimizer_t.h"
+#include "exact_packer_t.h"
+#include "packing_cache_t.h"
+#include "order_generator_t.h"
+#include "example_orders.h"
+#include "soak_tester_t.h"
 
 #define EJEMPLO_PEDIDO_S 1
 #define EJEMPLO_PEDIDO_M 0
@@ -36,241 +51,509 @@ using namespace std;
 // static const char * TAG = __FILE__;
 static const char * TAG = "main.cpp";
 
-int main(void)
+// Nombres de los motores (en el orden de packingEngine_t), de las ordenaciones
+// (en el orden de itemOrder_t) y de las puntuaciones de los puntos extremos
+// (en el orden de epScore_t) para la línea de órdenes.
+#define NUM_ENGINES   6
+#define NUM_ORDERS    4
+#define NUM_EP_SCORES 4
+static const char * ENGINE_NAMES[NUM_ENGINES] = {"space-list", "height-map", "extreme-points",
+                                                 "guillotine", "maxrects", "layers"};
+static const char * ORDER_NAMES[NUM_ORDERS] = {"input", "volume", "footprint", "height"};
+static const char * EP_SCORE_NAMES[NUM_EP_SCORES] = {"zxy", "zyx", "xzy", "sum"};
+
+// Repeticiones de cada combinación en el modo --compare.
+#define COMPARE_REPETITIONS 50
+
+/******************************************************************************/
+/*!
+ * @brief  Informa por stderr de los aciertos de la caché y la guarda en su
+ *         fichero, si lo tiene.
+ * @param  cache  La caché (o NULL).
+ * @param  path   Fichero de la caché (o NULL).
+ * @return void
+ */
+static void report_cache(packing_cache_t * cache, const char * path)
 {
-	#if EJEMPLO_PEDIDO_S
-	item_t item_01("tablet_A_01");
-	item_t item_02("tablet_A_01");
-	item_t item_03("tablet_A_01");
-	item_t item_04("ereader_B_02");
-	item_t item_05("ereader_A_02");
-	item_t item_06("ereader_B_funda");
-	item_t item_07("ereader_B_funda");
-	item_t item_08("ereader_A_funda");
-	item_t item_09("ereader_A_funda");
-	item_t item_10("telefono_C_03");
-	item_t item_11("telefono_A_02");
-	item_t item_12("telefono_F_02");
-	item_t item_13("telefono_D_01");
-	item_t item_14("telefono_D_01");
-	item_t item_15("telefono_B_01");
-	item_t item_16("reloj_B_01");
-	item_t item_17("reloj_B_01");
-	item_t item_18("reloj_B_01");
-	item_t item_19("reloj_B_02");
-	item_t item_20("reloj_B_02");
-	item_t item_21("reloj_B_01");
-	item_t item_22("telefono_B_01");
-	item_t item_23("telefono_B_01");
-	item_t item_24("telefono_D_funda");
-	item_t item_25("telefono_D_funda");
-	item_t item_26("telefono_B_funda");
+	if (cache == NULL)
+	{
+		return;
+	}
+
+	fprintf(stderr, "cache: %zu aciertos, %zu fallos, %zu expulsiones, %zu entradas\n",
+	        cache->get_hits(), cache->get_misses(), cache->get_evictions(), cache->get_size());
+
+	if ((path != NULL) && !(cache->save(path)))
+	{
+		fprintf(stderr, "No se puede escribir %s\n", path);
+	}
+
+}	/* report_cache() */
+
+/******************************************************************************/
+/*!
+ * @brief  Genera la orden de una caja y la escribe en la salida estándar (la
+ *         JSON seguida de un salto de línea, la binaria tal cual).
+ * @param  box     La caja.
+ * @param  format  Formato de la orden.
+ * @return void
+ */
+static void print_order(box_t * box, orderFormat_t format)
+{
+	box->generate_mqtt_order(false, format);
+
+	if (format == ORDER_FORMAT_MSGPACK)
+	{
+		string order = box->get_mqtt_order();
+		cout.write(order.data(), order.size());
+		cout.flush();
+		return;
+	}
+
+	cout << (box->get_mqtt_order());
+	cout << endl;
+
+}	/* print_order() */
+
+/******************************************************************************/
+/*!
+ * @brief  Uso: colocador [--engine MOTOR] [--order ORDEN] [--compare] [--batch N]
+ *                        [--threads T] [--input FICHERO|-] [--auto-box] [--multi-box]
+ *                        [--optimize MS] [--seed S] [--evaluations N]
+ *                        [--cache N] [--cache-file FICHERO] [--format FORMATO]
+ *                        [--soak N] [--arena] [--ep-score PUNTUACION] [--exact MS]
+ *         --engine   Motor de colocación de box_t: space-list (por defecto),
+ *                    height-map, extreme-points, guillotine, maxrects o layers.
+ *         --order    Orden en que se colocan los items del pedido de ejemplo:
+ *                    input (por defecto), volume, footprint o height.
+ *         --ep-score Orden en que el motor extreme-points prueba los puntos:
+ *                    zxy (menor z, luego x y luego y; por defecto), zyx, xzy
+ *                    o sum (menor x + y + z).
+ *         --compare  Coloca el pedido de ejemplo con cada motor y cada orden e
+ *                    informa del tiempo por pedido y del llenado de la caja.
+ *         --auto-box Coloca el pedido de ejemplo en la caja más pequeña en la
+ *                    que quepa (pruebas de S, M y L en paralelo).
+ *         --multi-box Reparte el pedido en tantas cajas como haga falta y
+ *                    escribe una orden por caja (con --input, un array JSON
+ *                    por pedido).
+ *         --batch    Coloca N copias del pedido de ejemplo en paralelo e
+ *                    informa de los pedidos por segundo.
+ *         --optimize Busca durante MS milisegundos el mejor orden de los items
+ *                    del pedido de ejemplo (con --auto-box, también la caja).
+ *         --exact    Busca la mejor colocación del pedido de ejemplo (hasta
+ *                    EXACT_MAX_ITEMS items, con --auto-box también la caja)
+ *                    durante MS milisegundos como mucho; si no termina, usa
+ *                    --engine (ver exact_packer_t).
+ *         --seed     Semilla del optimizador (por defecto 1).
+ *         --evaluations Máximo de evaluaciones por hilo del optimizador (con
+ *                    --optimize 0 el resultado es reproducible).
+ *         --threads  Hilos de los modos --batch, --input y --optimize (por
+ *                    defecto, uno por núcleo).
+ *         --input    Lee pedidos (JSON Lines o CSV, uno por línea) del fichero
+ *                    o de la entrada estándar (-) y escribe una orden JSON por
+ *                    línea en la salida estándar.
+ *         --cache    Guarda hasta N resultados en una caché LRU: en los modos
+ *                    --batch e --input, los pedidos repetidos (los mismos
+ *                    dispositivos, en cualquier orden) no se vuelven a colocar.
+ *         --cache-file Carga la caché del fichero al empezar y la guarda en él
+ *                    al terminar (implica --cache).
+ *         --format   Formato de las órdenes: json (por defecto) o msgpack
+ *                    (binaria, ver box_t::write_msgpack_order()). Vale para
+ *                    todos los modos que generan órdenes, también --batch,
+ *                    --multi-box e --input (ver order_stream_t).
+ *         --soak     Genera N pedidos sintéticos (con --seed) y coloca cada uno
+ *                    con la referencia y con --engine y --order, comprueba las
+ *                    dos colocaciones y las compara (ver soak_tester_t). Sale
+ *                    con 1 si algún pedido falla.
+ *         --arena    En el modo --batch, cada pedido se coloca sobre una arena
+ *                    que se vacía al terminarlo (ver order_arena_t) y se
+ *                    informa de las reservas y los bytes por pedido.
+ */
+int main(int argc, char * argv[])
+{
+	packingEngine_t engine = ENGINE_SPACE_LIST;
+	itemOrder_t itemOrder = ORDER_INPUT;
+	epScore_t epScore = EP_SCORE_ZXY;
+	bool compare = false;
+	size_t batchSize = 0;
+	size_t soakOrders = 0;
+	unsigned numThreads = 0;
+	const char * inputPath = NULL;
+	bool autoBox = false;
+	bool multiBox = false;
+	bool optimize = false;
+	bool exact = false;
+	bool useArena = false;
+	size_t cacheCapacity = 0;
+	const char * cachePath = NULL;
+	orderFormat_t orderFormat = ORDER_FORMAT_JSON;
+	optimizer_options_t optimizerOptions = {BOX_L, false, ENGINE_SPACE_LIST, OPTIMIZER_TIME_LIMIT_MS,
+	                                        0, 0, 1, NULL};
+	exact_options_t exactOptions = {BOX_L, false, ENGINE_SPACE_LIST, EXACT_TIME_LIMIT_MS, 0};
+
+#if LOG_TO_RING
+	// Las trazas se vuelcan por stderr al terminar (o si el programa muere).
+	trace_ring_t::install_post_mortem();
+#endif
+
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if ((strcmp(argv[arg], "--engine") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			for (int e = 0; e < NUM_ENGINES; e++)
+			{
+				if (strcmp(argv[arg], ENGINE_NAMES[e]) == 0)
+				{
+					engine = (packingEngine_t)e;
+				}
+			}
+		}
+		else if ((strcmp(argv[arg], "--order") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			for (int o = 0; o < NUM_ORDERS; o++)
+			{
+				if (strcmp(argv[arg], ORDER_NAMES[o]) == 0)
+				{
+					itemOrder = (itemOrder_t)o;
+				}
+			}
+		}
+		else if ((strcmp(argv[arg], "--ep-score") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			for (int p = 0; p < NUM_EP_SCORES; p++)
+			{
+				if (strcmp(argv[arg], EP_SCORE_NAMES[p]) == 0)
+				{
+					epScore = (epScore_t)p;
+				}
+			}
+		}
+		else if (strcmp(argv[arg], "--compare") == 0)
+		{
+			compare = true;
+		}
+		else if ((strcmp(argv[arg], "--batch") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			batchSize = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--soak") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			soakOrders = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--threads") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			numThreads = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--input") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			inputPath = argv[arg];
+		}
+		else if (strcmp(argv[arg], "--auto-box") == 0)
+		{
+			autoBox = true;
+		}
+		else if (strcmp(argv[arg], "--multi-box") == 0)
+		{
+			multiBox = true;
+		}
+		else if (strcmp(argv[arg], "--arena") == 0)
+		{
+			useArena = true;
+		}
+		else if ((strcmp(argv[arg], "--optimize") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			optimize = true;
+			optimizerOptions.timeLimitMs = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--exact") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			exact = true;
+			exactOptions.timeLimitMs = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--seed") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			optimizerOptions.seed = strtoull(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--evaluations") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			optimizerOptions.maxEvaluations = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--cache") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			cacheCapacity = strtoul(argv[arg], NULL, 10);
+		}
+		else if ((strcmp(argv[arg], "--cache-file") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			cachePath = argv[arg];
+		}
+		else if ((strcmp(argv[arg], "--format") == 0) && ((arg + 1) < argc))
+		{
+			arg++;
+			orderFormat = (strcmp(argv[arg], "msgpack") == 0) ? (ORDER_FORMAT_MSGPACK) : (ORDER_FORMAT_JSON);
+		}
+	}
 
+	if (soakOrders > 0)
+	{
+		order_generator_t generator(optimizerOptions.seed);
+		soak_tester_t tester(numThreads, engine, itemOrder, epScore);
+		soak_stats_t stats;
+
+		bool passed = tester.run(generator, soakOrders, &stats);
+
+		printf("soak: %zu pedidos (%zu items), semilla %llu, motor %s, orden %s, %.0f pedidos/s\n",
+		       stats.orders, stats.items, (unsigned long long)generator.get_seed(),
+		       ENGINE_NAMES[engine], ORDER_NAMES[itemOrder], stats.orders / stats.seconds);
+		printf("  inválidos: referencia %zu, candidato %zu; items perdidos %zu; posiciones distintas %zu; rollback %zu; exacta %zu\n",
+		       stats.invalidReference, stats.invalidCandidate, stats.lostItems, stats.mismatches,
+		       stats.rollbackMismatches, stats.exactMismatches);
+		printf("  candidato frente a referencia: %zu con menos items, %zu con más; llenado medio %.4f / %.4f\n",
+		       stats.candidateFewer, stats.candidateMore, stats.candidateFill / stats.orders,
+		       stats.referenceFill / stats.orders);
+
+		for (size_t i = 0; i < stats.failures.size(); i++)
+		{
+			fprintf(stderr, "%s\n", stats.failures[i].c_str());
+		}
+
+		printf("%s\n", (passed) ? ("OK") : ("FALLO"));
+		return ((passed) ? (0) : (1));
+	}
+
+	// La caché solo se usa si se pide (cache == NULL en otro caso).
+	packing_cache_t cacheStorage((cacheCapacity > 0) ? (cacheCapacity) : (PACKING_CACHE_CAPACITY));
+	packing_cache_t * cache = NULL;
+
+	if ((cacheCapacity > 0) || (cachePath != NULL))
+	{
+		cache = &cacheStorage;
+
+		if (cachePath != NULL)
+		{
+			fprintf(stderr, "%zu resultados cargados de %s\n", cache->load(cachePath), cachePath);
+		}
+	}
+
+	if (inputPath != NULL)
+	{
+		order_stream_t stream(numThreads, engine);
+
+		stream.set_multi_box(multiBox);
+		stream.set_cache(cache);
+		stream.set_format(orderFormat);
+
+		if (strcmp(inputPath, "-") == 0)
+		{
+			stream.run(cin, cout);
+		}
+		else
+		{
+			ifstream input(inputPath);
+
+			if (!(input.is_open()))
+			{
+				fprintf(stderr, "No se puede abrir %s\n", inputPath);
+				return 1;
+			}
+
+			stream.run(input, cout);
+		}
+
+		report_cache(cache, cachePath);
+		return 0;
+	}
+
+	#if EJEMPLO_PEDIDO_S
+	const char * const * ejemplo = EJEMPLO_PEDIDO_S_ITEMS;
 	boxType_t caja_ejemplo = BOX_S;
-	
-	#elif EJEMPLO_PEDIDO_M
-	item_t item_01("tablet_A_02");
-	item_t item_02("tablet_A_02");
-	item_t item_03("tablet_A_funda");
-	item_t item_04("tablet_A_funda");
-	item_t item_05("tablet_A_01");
-	item_t item_06("tablet_A_01");
-	item_t item_07("tablet_B_funda");
-	item_t item_08("tablet_B_funda");
-	item_t item_09("tablet_B_02");
-	item_t item_10("tablet_B_02");
-	item_t item_11("tablet_B_funda");
-	item_t item_12("tablet_B_funda");
-	item_t item_13("tablet_D_funda");
-	item_t item_14("tablet_D_funda");
-	item_t item_15("ereader_A_02");
-	item_t item_16("ereader_A_01");
-	item_t item_17("ereader_B_01");
-	item_t item_18("ereader_B_01");
-	item_t item_19("telefono_F_02");
-	item_t item_20("telefono_D_01");
-	item_t item_21("telefono_D_01");
-	item_t item_22("telefono_B_01");
-	item_t item_23("telefono_B_01");
-	item_t item_24("telefono_B_01");
-	item_t item_25("telefono_B_01");
-	item_t item_26("telefono_D_01");
 
+	#elif EJEMPLO_PEDIDO_M
+	const char * const * ejemplo = EJEMPLO_PEDIDO_M_ITEMS;
 	boxType_t caja_ejemplo = BOX_M;
 
 	#elif EJEMPLO_PEDIDO_L
-	item_t item_01("tablet_A_02");
-	item_t item_02("tablet_A_02");
-	item_t item_03("tablet_A_02");
-	item_t item_04("tablet_C_02");
-	item_t item_05("tablet_C_02");
-	item_t item_06("tablet_C_02");
-	item_t item_07("tablet_B_01");
-	item_t item_08("tablet_B_01");
-	item_t item_09("tablet_B_01");
-	item_t item_10("tablet_A_01");
-	item_t item_11("tablet_A_01");
-	item_t item_12("tablet_D_01");
-	item_t item_13("tablet_A_funda");
-	item_t item_14("tablet_A_funda");
-	item_t item_15("tablet_B_funda");
-	item_t item_16("tablet_B_funda");
-	item_t item_17("tablet_A_funda");
-	item_t item_18("tablet_A_funda");
-	item_t item_19("tablet_A_funda");
-	item_t item_20("tablet_A_funda");
-	item_t item_21("ereader_B_01");
-	item_t item_22("ereader_B_01");
-	item_t item_23("ereader_B_01");
-	item_t item_24("ereader_B_01");
-	item_t item_25("telefono_B_01");
-	item_t item_26("telefono_B_01");
-	item_t item_27("telefono_B_01");
-	item_t item_28("telefono_B_01");
-	item_t item_29("telefono_B_01");
-	item_t item_30("telefono_B_01");
-	item_t item_31("pulsera_B_01");
-	item_t item_32("pulsera_B_01");
-	item_t item_33("pulsera_B_01");
-	item_t item_34("pulsera_B_01");
-	item_t item_35("pulsera_B_01");
-	item_t item_36("pulsera_B_01");
-	item_t item_37("pulsera_B_01");
-	item_t item_38("pulsera_B_01");
-	item_t item_39("pulsera_B_01");
-	item_t item_40("pulsera_B_01");
-	item_t item_41("pulsera_B_01");
-	item_t item_42("pulsera_B_01");
-	item_t item_43("telefono_B_funda");
-	item_t item_44("telefono_B_funda");
-	item_t item_45("telefono_B_funda");
-	item_t item_46("telefono_B_funda");
-	item_t item_47("telefono_B_funda");
-	item_t item_48("telefono_B_funda");
-
+	const char * const * ejemplo = EJEMPLO_PEDIDO_L_ITEMS;
 	boxType_t caja_ejemplo = BOX_L;
 
 	#endif
 
 	list<item_t> itemsToPlaceInOrder;
+	for (size_t i = 0; ejemplo[i] != NULL; i++)
+	{
+		itemsToPlaceInOrder.push_back(item_t(ejemplo[i]));
+	}
 
-	#if EJEMPLO_PEDIDO_S
-	itemsToPlaceInOrder.push_back(item_01);
-	itemsToPlaceInOrder.push_back(item_02);
-	itemsToPlaceInOrder.push_back(item_03);
-	itemsToPlaceInOrder.push_back(item_04);
-	itemsToPlaceInOrder.push_back(item_05);
-	itemsToPlaceInOrder.push_back(item_06);
-	itemsToPlaceInOrder.push_back(item_07);
-	itemsToPlaceInOrder.push_back(item_08);
-	itemsToPlaceInOrder.push_back(item_09);
-	itemsToPlaceInOrder.push_back(item_10);
-	itemsToPlaceInOrder.push_back(item_11);
-	itemsToPlaceInOrder.push_back(item_12);
-	itemsToPlaceInOrder.push_back(item_13);
-	itemsToPlaceInOrder.push_back(item_14);
-	itemsToPlaceInOrder.push_back(item_15);
-	itemsToPlaceInOrder.push_back(item_16);
-	itemsToPlaceInOrder.push_back(item_17);
-	itemsToPlaceInOrder.push_back(item_18);
-	itemsToPlaceInOrder.push_back(item_19);
-	itemsToPlaceInOrder.push_back(item_20);
-	itemsToPlaceInOrder.push_back(item_21);
-	itemsToPlaceInOrder.push_back(item_22);
-	itemsToPlaceInOrder.push_back(item_23);
-	itemsToPlaceInOrder.push_back(item_24);
-	itemsToPlaceInOrder.push_back(item_25);
-	itemsToPlaceInOrder.push_back(item_26);
+	if (compare)
+	{
+		printf("%-15s %-10s %10s %8s %12s\n", "motor", "orden", "colocados", "llenado", "us/pedido");
 
-	#elif EJEMPLO_PEDIDO_M
-	itemsToPlaceInOrder.push_back(item_01);
-	itemsToPlaceInOrder.push_back(item_02);
-	itemsToPlaceInOrder.push_back(item_03);
-	itemsToPlaceInOrder.push_back(item_04);
-	itemsToPlaceInOrder.push_back(item_05);
-	itemsToPlaceInOrder.push_back(item_06);
-	itemsToPlaceInOrder.push_back(item_07);
-	itemsToPlaceInOrder.push_back(item_08);
-	itemsToPlaceInOrder.push_back(item_09);
-	itemsToPlaceInOrder.push_back(item_10);
-	itemsToPlaceInOrder.push_back(item_11);
-	itemsToPlaceInOrder.push_back(item_12);
-	itemsToPlaceInOrder.push_back(item_13);
-	itemsToPlaceInOrder.push_back(item_14);
-	itemsToPlaceInOrder.push_back(item_15);
-	itemsToPlaceInOrder.push_back(item_16);
-	itemsToPlaceInOrder.push_back(item_17);
-	itemsToPlaceInOrder.push_back(item_18);
-	itemsToPlaceInOrder.push_back(item_19);
-	itemsToPlaceInOrder.push_back(item_20);
-	itemsToPlaceInOrder.push_back(item_21);
-	itemsToPlaceInOrder.push_back(item_22);
-	itemsToPlaceInOrder.push_back(item_23);
-	itemsToPlaceInOrder.push_back(item_24);
-	itemsToPlaceInOrder.push_back(item_25);
-	itemsToPlaceInOrder.push_back(item_26);
+		for (int e = 0; e < NUM_ENGINES; e++)
+		{
+			for (int o = 0; o < NUM_ORDERS; o++)
+			{
+				size_t placed = 0;
+				double fill = 0.0;
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
 
-	#elif EJEMPLO_PEDIDO_L
-	itemsToPlaceInOrder.push_back(item_01);
-	itemsToPlaceInOrder.push_back(item_02);
-	itemsToPlaceInOrder.push_back(item_03);
-	itemsToPlaceInOrder.push_back(item_04);
-	itemsToPlaceInOrder.push_back(item_05);
-	itemsToPlaceInOrder.push_back(item_06);
-	itemsToPlaceInOrder.push_back(item_07);
-	itemsToPlaceInOrder.push_back(item_08);
-	itemsToPlaceInOrder.push_back(item_09);
-	itemsToPlaceInOrder.push_back(item_10);
-	itemsToPlaceInOrder.push_back(item_11);
-	itemsToPlaceInOrder.push_back(item_12);
-	itemsToPlaceInOrder.push_back(item_13);
-	itemsToPlaceInOrder.push_back(item_14);
-	itemsToPlaceInOrder.push_back(item_15);
-	itemsToPlaceInOrder.push_back(item_16);
-	itemsToPlaceInOrder.push_back(item_17);
-	itemsToPlaceInOrder.push_back(item_18);
-	itemsToPlaceInOrder.push_back(item_19);
-	itemsToPlaceInOrder.push_back(item_20);
-	itemsToPlaceInOrder.push_back(item_21);
-	itemsToPlaceInOrder.push_back(item_22);
-	itemsToPlaceInOrder.push_back(item_23);
-	itemsToPlaceInOrder.push_back(item_24);
-	itemsToPlaceInOrder.push_back(item_25);
-	itemsToPlaceInOrder.push_back(item_26);
-	itemsToPlaceInOrder.push_back(item_27);
-	itemsToPlaceInOrder.push_back(item_28);
-	itemsToPlaceInOrder.push_back(item_29);
-	itemsToPlaceInOrder.push_back(item_30);
-	itemsToPlaceInOrder.push_back(item_31);
-	itemsToPlaceInOrder.push_back(item_32);
-	itemsToPlaceInOrder.push_back(item_33);
-	itemsToPlaceInOrder.push_back(item_34);
-	itemsToPlaceInOrder.push_back(item_35);
-	itemsToPlaceInOrder.push_back(item_36);
-	itemsToPlaceInOrder.push_back(item_37);
-	itemsToPlaceInOrder.push_back(item_38);
-	itemsToPlaceInOrder.push_back(item_39);
-	itemsToPlaceInOrder.push_back(item_40);
-	itemsToPlaceInOrder.push_back(item_41);
-	itemsToPlaceInOrder.push_back(item_42);
-	itemsToPlaceInOrder.push_back(item_43);
-	itemsToPlaceInOrder.push_back(item_44);
-	itemsToPlaceInOrder.push_back(item_45);
-	itemsToPlaceInOrder.push_back(item_46);
-	itemsToPlaceInOrder.push_back(item_47);
-	itemsToPlaceInOrder.push_back(item_48);
+				for (int rep = 0; rep < COMPARE_REPETITIONS; rep++)
+				{
+					box_t box(caja_ejemplo, &itemsToPlaceInOrder);
 
-	#endif
+					box.set_engine((packingEngine_t)e);
+					box.set_item_order((itemOrder_t)o);
+					box.set_ep_score(epScore);
+					box.place_items_in_box();
+					box.generate_mqtt_order();
+
+					placed = box.get_num_placed_items();
+					fill = box.get_fill_ratio();
+				}
+
+				double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+				printf("%-15s %-10s %6zu/%-3zu %7.1f%% %12.1f\n", ENGINE_NAMES[e], ORDER_NAMES[o],
+				       placed, itemsToPlaceInOrder.size(), 100.0 * fill, us / COMPARE_REPETITIONS);
+			}
+		}
+
+		return 0;
+	}
+
+	if (batchSize > 0)
+	{
+		order_t order = {caja_ejemplo, itemsToPlaceInOrder, autoBox};
+		vector<order_t> orders(batchSize, order);
+		vector<order_result_t> results;
+		batch_packer_t packer(numThreads, engine);
+
+		packer.set_cache(cache);
+		packer.set_format(orderFormat);
+		packer.set_use_arena(useArena);
+		packer.pack(&orders, &results);
+
+		printf("%zu pedidos en %.3f s con %zu hilos (%.1f pedidos/s)\n", results.size(),
+		       packer.get_seconds(), packer.get_num_threads(), packer.get_orders_per_second());
+
+		if (useArena)
+		{
+			printf("arena: %.1f reservas/pedido, %.0f bytes/pedido\n",
+			       packer.get_arena_allocations_per_order(), packer.get_arena_bytes_per_order());
+		}
+
+		report_cache(cache, cachePath);
+		return 0;
+	}
+
+	if (multiBox)
+	{
+		vector<string> orders;
+		size_t unplaceable = multi_box_packer_t::pack_to_mqtt_orders(&itemsToPlaceInOrder, engine,
+		                                                             MULTI_BOX_TIME_LIMIT_MS, false, &orders,
+		                                                             orderFormat);
+
+		for (size_t i = 0; i < orders.size(); i++)
+		{
+			cout.write(orders[i].data(), orders[i].size());
+			if (orderFormat == ORDER_FORMAT_JSON)
+			{
+				cout << endl;
+			}
+		}
+		cout.flush();
+
+		if (unplaceable > 0)
+		{
+			fprintf(stderr, "%zu dispositivos no caben en ninguna caja\n", unplaceable);
+		}
+
+		return 0;
+	}
+
+	if (optimize)
+	{
+		box_t * best = NULL;
+
+		optimizerOptions.boxType = caja_ejemplo;
+		optimizerOptions.autoBox = autoBox;
+		optimizerOptions.engine = engine;
+		optimizerOptions.numThreads = numThreads;
+
+		order_optimizer_t optimizer(optimizerOptions);
+		size_t evaluations = optimizer.optimize(&itemsToPlaceInOrder, &best);
+
+		print_order(best, orderFormat);
+
+		fprintf(stderr, "%zu evaluaciones, %zu/%zu dispositivos colocados, llenado %.1f%%\n",
+		        evaluations, best->get_num_placed_items(), itemsToPlaceInOrder.size(),
+		        100.0 * best->get_fill_ratio());
+
+		delete best;
+		return 0;
+	}
+
+	if (exact)
+	{
+		box_t * best = NULL;
+		exact_report_t report;
+
+		exactOptions.boxType = caja_ejemplo;
+		exactOptions.autoBox = autoBox;
+		exactOptions.engine = engine;
+
+		exact_packer_t packer(exactOptions);
+		packer.solve(&itemsToPlaceInOrder, &best, &report);
+
+		print_order(best, orderFormat);
+
+		fprintf(stderr, "%zu nodos, %s%s, %zu/%zu dispositivos colocados, llenado %.1f%%\n",
+		        report.nodes, (report.optimal) ? ("óptima") : ("sin prueba de óptimo"),
+		        (report.fallback) ? (" (motor heurístico)") : (""), best->get_num_placed_items(),
+		        itemsToPlaceInOrder.size(), 100.0 * best->get_fill_ratio());
+
+		delete best;
+		return 0;
+	}
+
+	if (autoBox)
+	{
+		box_t * smallest = NULL;
+
+		if (!(box_selector_t::pack_in_smallest_box(&itemsToPlaceInOrder, engine, true, &smallest)))
+		{
+			fprintf(stderr, "El pedido no cabe en ninguna caja\n");
+			return 1;
+		}
+
+		print_order(smallest, orderFormat);
+
+		delete smallest;
+		return 0;
+	}
 
 	box_t box_01(caja_ejemplo, &itemsToPlaceInOrder);
 
-	box_01.place_items_in_box();
+	box_01.set_engine(engine);
 
-	box_01.generate_mqtt_order();
+	box_01.set_item_order(itemOrder);
 
-	cout << (box_01.get_mqtt_order());
+	box_01.set_ep_score(epScore);
 
-	cout << endl;
+	box_01.place_items_in_box();
+
+	print_order(&box_01, orderFormat);
 
 	return 0;
 
@@ -0,0 +1,268 @@
+/**
+ * @file     maxrects_strategy_t.h
+ *
+ * @brief    Estrategia de colocación por capas con rectángulos maximales
+ *           (Maximal Rectangles).
+ *
+ * La caja se llena por capas. La altura de cada capa la fija el primer item
+ * que se coloca en ella y en la capa solo entran items que no la superan.
+ * Dentro de la capa el suelo libre se guarda como el conjunto de rectángulos
+ * maximales (que pueden solaparse entre sí) y cada item va a la esquina del
+ * rectángulo que mejor se ajusta por el lado corto (Best Short Side Fit).
+ * Cuando en una capa no entra nada más, la siguiente empieza encima.
+ * layer_strategy_t reutiliza el conjunto de rectángulos y el ajuste.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de rectángulos maximales
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef MAXRECTS_STRATEGY_T_H
+#define MAXRECTS_STRATEGY_T_H
+
+#include <algorithm>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "placement_strategy_t.h"
+
+using namespace std;
+
+// static const char * MAXRECTS_TAG = __FILE__;
+static const char * MAXRECTS_TAG = "maxrects_strategy_t.h";
+
+class maxrects_strategy_t : public placement_strategy_t
+{
+    protected:
+
+        // Rectángulo del suelo de la capa [x0, x1) x [y0, y1).
+        typedef struct
+        {
+            uint16_t x0, y0, x1, y1;
+
+        } rect_t;
+
+        // ATRIBUTOS.
+        vector<rect_t> freeRects;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el rectángulo a está contenido en b.
+         */
+        static bool
+        is_contained(const rect_t & a, const rect_t & b)
+        {
+            return ((a.x0 >= b.x0) && (a.y0 >= b.y0) && (a.x1 <= b.x1) && (a.y1 <= b.y1));
+
+        }   /* is_contained() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Quita un rectángulo ocupado del conjunto libre: cada rectángulo
+         *         libre que lo corta se sustituye por las (hasta cuatro) partes
+         *         maximales que quedan fuera, y después se eliminan los que han
+         *         quedado contenidos en otro.
+         */
+        void
+        subtract(rect_t used)
+        {
+            vector<rect_t> next;
+
+            for (size_t i = 0; i < freeRects.size(); i++)
+            {
+                rect_t f = freeRects[i];
+
+                if ((used.x0 >= f.x1) || (used.x1 <= f.x0) || (used.y0 >= f.y1) || (used.y1 <= f.y0))
+                {
+                    next.push_back(f);
+                    continue;
+                }
+
+                if (used.x0 > f.x0) { rect_t r = f; r.x1 = used.x0; next.push_back(r); }
+                if (used.x1 < f.x1) { rect_t r = f; r.x0 = used.x1; next.push_back(r); }
+                if (used.y0 > f.y0) { rect_t r = f; r.y1 = used.y0; next.push_back(r); }
+                if (used.y1 < f.y1) { rect_t r = f; r.y0 = used.y1; next.push_back(r); }
+            }
+
+            freeRects.clear();
+            for (size_t i = 0; i < next.size(); i++)
+            {
+                bool redundant = false;
+
+                for (size_t j = 0; (j < next.size()) && (redundant == false); j++)
+                {
+                    // De dos rectángulos iguales se queda el primero.
+                    redundant = (i != j) && is_contained(next[i], next[j]) &&
+                                (!(is_contained(next[j], next[i])) || (j < i));
+                }
+
+                if (redundant == false)
+                {
+                    freeRects.push_back(next[i]);
+                }
+            }
+
+        }   /* subtract() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca el rectángulo libre con mejor ajuste por el lado corto
+         *         para un item, en sus orientaciones, a la altura base. Solo
+         *         se valida la posición de los rectángulos que mejoran el
+         *         ajuste encontrado.
+         * @param  job          El trabajo de colocación.
+         * @param  it           El item.
+         * @param  base         La altura del suelo de la capa.
+         * @param  bestSpace    Devuelve la posición del item.
+         * @param  bestRotated  Devuelve si el item va girado 90º sobre z.
+         * @return Verdadero si el item cabe en algún rectángulo libre.
+         */
+        bool
+        find_best_fit(placement_job_t * job, pmr::list<item_t>::iterator it, uint16_t base,
+                      space_t * bestSpace, bool * bestRotated)
+        {
+            int bestShort = 0, bestLong = 0;
+            bool found = false;
+
+            for (int r = 0; r < num_orientations(job, it); r++)
+            {
+                space_t itemSize = oriented_size(it, (r == 1));
+
+                for (size_t i = 0; i < freeRects.size(); i++)
+                {
+                    int leftX = (int)(freeRects[i].x1 - freeRects[i].x0) - itemSize.max_x();
+                    int leftY = (int)(freeRects[i].y1 - freeRects[i].y0) - itemSize.max_y();
+                    int shortSide = std::min(leftX, leftY);
+                    int longSide = std::max(leftX, leftY);
+
+                    if ((leftX < 0) || (leftY < 0) ||
+                        (found && ((shortSide > bestShort) ||
+                                   ((shortSide == bestShort) && (longSide >= bestLong)))))
+                    {
+                        continue;
+                    }
+
+                    point_t corner;
+                    corner.x = freeRects[i].x0;
+                    corner.y = freeRects[i].y0;
+                    corner.z = base;
+
+                    space_t candidate = itemSize + corner;
+
+                    if (job->validator->is_valid(candidate))
+                    {
+                        *bestSpace = candidate;
+                        *bestRotated = (r == 1);
+                        bestShort = shortSide;
+                        bestLong = longSide;
+                        found = true;
+                    }
+                }
+            }
+
+            return (found);
+
+        }   /* find_best_fit() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de la estrategia.
+         * @param  void
+         * @return El nombre.
+         */
+        const char *
+        get_name(void)
+        {
+            return "maxrects";
+
+        }   /* get_name() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca los items capa a capa. En cada capa se recorre
+         *         itemsToPlace en orden y cada item que quepa va al rectángulo
+         *         libre con mejor ajuste.
+         * @param  job  El trabajo de colocación.
+         * @return void
+         */
+        void
+        place(placement_job_t * job)
+        {
+            traceln(MAXRECTS_TAG, "place()");
+
+            uint16_t base = 0;
+            failed_skus_t failed;
+
+            // La primera capa empieza encima de lo que ya hubiera en la caja.
+            for (size_t i = 0; i < job->validator->get_placed().size(); i++)
+            {
+                space_t s = job->validator->get_placed()[i];
+                base = std::max(base, s.max_z());
+            }
+
+            while (!(job->itemsToPlace->empty()) && (base < job->boxSize.max_z()) && !(job->isCancelled()))
+            {
+                rect_t floor = {0, 0, job->boxSize.max_x(), job->boxSize.max_y()};
+                uint16_t layerHeight = 0;
+
+                freeRects.clear();
+                freeRects.push_back(floor);
+                failed.clear();
+
+                pmr::list<item_t>::iterator it = job->itemsToPlace->begin();
+                while ((it != job->itemsToPlace->end()) && !(job->isCancelled()))
+                {
+                    uint16_t height = it->get_size().max_z();
+                    space_t bestSpace;
+                    bool bestRotated = false;
+
+                    // La altura de la capa la fija el primer item; las copias de
+                    // un SKU que no ha cabido desde la última colocación,
+                    // tampoco caben.
+                    if (((layerHeight == 0) && ((base + height) > job->boxSize.max_z())) ||
+                        ((layerHeight != 0) && (height > layerHeight)) || failed.contains(it->get_sku()))
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    if (find_best_fit(job, it, base, &bestSpace, &bestRotated))
+                    {
+                        rect_t used = {bestSpace.min_x(), bestSpace.min_y(), bestSpace.max_x(), bestSpace.max_y()};
+
+                        layerHeight = (layerHeight == 0) ? (height) : (layerHeight);
+                        it = commit(job, it, bestSpace, bestRotated);
+                        subtract(used);
+                        failed.clear();
+                    }
+                    else
+                    {
+                        failed.add(it->get_sku());
+                        ++it;
+                    }
+                }
+
+                // Si en la capa no ha entrado nada, en las siguientes tampoco.
+                if (layerHeight == 0)
+                {
+                    break;
+                }
+
+                base += layerHeight;
+            }
+
+            traceln(MAXRECTS_TAG, "place() - END");
+
+        }   /* place() */
+};
+
+#endif /* MAXRECTS_STRATEGY_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,185 @@
+/**
+ * @file     multi_box_packer_t.h
+ *
+ * @brief    Reparto de un pedido en varias cajas cuando no cabe en una sola.
+ *
+ * Mientras queden items se intenta meter todo lo que falta en la caja más
+ * pequeña posible. Si no cabe en ninguna, se llena una caja L, se vuelve a
+ * probar si lo que ha entrado en ella cabría en una caja más pequeña y el resto
+ * pasa a la siguiente caja. Así solo la última caja puede quedar a medias y se
+ * elige siempre la caja de menor volumen que sirve.
+ *
+ * Todo el proceso tiene un límite de tiempo. Si se supera, lo que queda se
+ * coloca sin buscar la caja más pequeña y con el motor ENGINE_HEIGHT_MAP, cuyo
+ * coste está acotado, para que un pedido patológico no bloquee al planificador.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del reparto en varias cajas
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef MULTI_BOX_PACKER_T_H
+#define MULTI_BOX_PACKER_T_H
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "box_selector_t.h"
+
+using namespace std;
+
+// static const char * MULTI_BOX_TAG = __FILE__;
+static const char * MULTI_BOX_TAG = "multi_box_packer_t.h";
+
+// Límite de tiempo por defecto para repartir un pedido (ms).
+#define MULTI_BOX_TIME_LIMIT_MS 50
+
+class multi_box_packer_t
+{
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Reparte los items en tantas cajas como haga falta.
+         * @param  items        Los items del pedido.
+         * @param  engine       Motor de colocación.
+         * @param  timeLimitMs  Límite de tiempo total (ms).
+         * @param  boxes        Devuelve las cajas llenas (reservadas con new, las
+         *                      libera quien llama), en el orden en que se llenan.
+         * @param  unplaceable  Devuelve los items que no caben en ninguna caja
+         *                      (por ejemplo, más grandes que una caja L).
+         * @return Verdadero si se han colocado todos los items.
+         */
+        static bool
+        pack(list<item_t> * items, packingEngine_t engine, unsigned timeLimitMs,
+             vector<box_t *> * boxes, list<item_t> * unplaceable)
+        {
+            traceln(MULTI_BOX_TAG, "pack()");
+
+            chrono::steady_clock::time_point deadline =
+                chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs);
+            list<item_t> remaining = *items;
+            bool expired = false;
+
+            boxes->clear();
+            unplaceable->clear();
+
+            while (!(remaining.empty()))
+            {
+                box_t * box = NULL;
+
+                expired = expired || (chrono::steady_clock::now() >= deadline);
+
+                // 1) Si todo lo que queda cabe en una caja, elegir la más pequeña.
+                if ((expired == false) &&
+                    box_selector_t::pack_in_smallest_box(&remaining, engine, false, &box, &deadline))
+                {
+                    boxes->push_back(box);
+                    remaining.clear();
+                    continue;
+                }
+
+                // 2) Si no, llenar una caja L con lo que quepa.
+                box = new box_t(BOX_L, &remaining);
+                box->set_engine((expired) ? (ENGINE_HEIGHT_MAP) : (engine));
+                if (expired == false)
+                {
+                    box->set_deadline(deadline);
+                }
+                box->place_items_in_box();
+
+                if ((expired == false) && box->is_cancelled())
+                {
+                    // Se ha agotado el tiempo a mitad de la caja: repetirla
+                    // con el motor de coste acotado.
+                    expired = true;
+                    delete box;
+                    box = new box_t(BOX_L, &remaining);
+                    box->set_engine(ENGINE_HEIGHT_MAP);
+                    box->place_items_in_box();
+                }
+
+                // 3) Si no ha entrado nada, los items restantes no caben en ninguna caja.
+                if (box->get_num_placed_items() == 0)
+                {
+                    *unplaceable = remaining;
+                    delete box;
+                    break;
+                }
+
+                remaining.assign(box->get_items_to_place().begin(), box->get_items_to_place().end());
+
+                // 4) Lo que ha entrado en la caja L puede que quepa en una más pequeña.
+                list<item_t> placed(box->get_placed_items().begin(), box->get_placed_items().end());
+                box_t * smaller = NULL;
+
+                if ((expired == false) &&
+                    box_selector_t::pack_in_smallest_box(&placed, engine, false, &smaller, &deadline))
+                {
+                    if (smaller->get_type() != BOX_L)
+                    {
+                        delete box;
+                        box = smaller;
+                    }
+                    else
+                    {
+                        delete smaller;
+                    }
+                }
+
+                boxes->push_back(box);
+            }
+
+            traceln(MULTI_BOX_TAG, "pack() - END");
+            return (unplaceable->empty());
+
+        }   /* pack() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Reparte los items y genera una orden por caja.
+         * @param  items        Los items del pedido.
+         * @param  engine       Motor de colocación.
+         * @param  timeLimitMs  Límite de tiempo total (ms).
+         * @param  singleLine   Generar cada orden JSON en una sola línea.
+         * @param  orders       Devuelve una orden por caja.
+         * @param  format       Formato de las órdenes.
+         * @return Número de items que no caben en ninguna caja.
+         */
+        static size_t
+        pack_to_mqtt_orders(list<item_t> * items, packingEngine_t engine, unsigned timeLimitMs,
+                            bool singleLine, vector<string> * orders,
+                            orderFormat_t format = ORDER_FORMAT_JSON)
+        {
+            traceln(MULTI_BOX_TAG, "pack_to_mqtt_orders()");
+
+            vector<box_t *> boxes;
+            list<item_t> unplaceable;
+
+            pack(items, engine, timeLimitMs, &boxes, &unplaceable);
+
+            orders->clear();
+            for (size_t i = 0; i < boxes.size(); i++)
+            {
+                boxes[i]->generate_mqtt_order(singleLine, format);
+                orders->push_back(boxes[i]->get_mqtt_order());
+                delete boxes[i];
+            }
+
+            traceln(MULTI_BOX_TAG, "pack_to_mqtt_orders() - END");
+            return (unplaceable.size());
+
+        }   /* pack_to_mqtt_orders() */
+};
+
+#endif /* MULTI_BOX_PACKER_T_H */
+
+/*** end of file ***/
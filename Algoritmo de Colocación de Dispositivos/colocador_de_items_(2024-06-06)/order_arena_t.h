@@ -0,0 +1,189 @@
+/**
+ * @file     order_arena_t.h
+ *
+ * @brief    Memoria por pedido para box_t (std::pmr::memory_resource).
+ *
+ * Una box_t construida con una order_arena_t saca de ella todos sus nodos
+ * (spaceInUse, itemsToPlace, placedItems, el registro de deshacer), los arrays
+ * auxiliares y la orden generada. La arena reparte memoria de forma
+ * monótona: liberar no hace nada, y al terminar el pedido end_order() la
+ * vacía entera en O(1). Los primeros ORDER_ARENA_BYTES están en un bloque
+ * propio que se reutiliza en cada pedido; solo si un pedido necesita más se
+ * piden bloques nuevos al sistema (y se devuelven en end_order()).
+ *
+ * La arena cuenta las reservas y los bytes de cada pedido. No es segura entre
+ * hilos: se usa una por hilo, y la caja tiene que destruirse antes de llamar a
+ * end_order().
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la arena por pedido
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef ORDER_ARENA_T_H
+#define ORDER_ARENA_T_H
+
+#include <memory>
+#include <memory_resource>
+#include "defines.h"
+#include "logger.h"
+
+using namespace std;
+
+// static const char * ARENA_TAG = __FILE__;
+static const char * ARENA_TAG = "order_arena_t.h";
+
+// Tamaño del bloque propio de la arena (suficiente para un pedido de la caja L).
+#define ORDER_ARENA_BYTES (256 * 1024)
+
+class order_arena_t : public pmr::memory_resource
+{
+    private:
+
+        // ATRIBUTOS.
+        unique_ptr<char[]> block;
+        pmr::monotonic_buffer_resource arena;
+        size_t allocations;       // del pedido actual
+        size_t bytes;
+        size_t totalAllocations;  // de los pedidos terminados
+        size_t totalBytes;
+        size_t orders;
+        size_t peakBytes;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Reserva memoria de la arena y la cuenta.
+         */
+        void *
+        do_allocate(size_t size, size_t alignment) override
+        {
+            allocations++;
+            bytes += size;
+            return (arena.allocate(size, alignment));
+
+        }   /* do_allocate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  No hace nada: la memoria se recupera entera en end_order().
+         */
+        void
+        do_deallocate(void *, size_t, size_t) override
+        {
+
+        }   /* do_deallocate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Dos arenas solo son iguales si son la misma.
+         */
+        bool
+        do_is_equal(const pmr::memory_resource & other) const noexcept override
+        {
+            return (this == &other);
+
+        }   /* do_is_equal() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase order_arena_t.
+         * @param  void
+         */
+        order_arena_t(void) : block(new char[ORDER_ARENA_BYTES]),
+                              arena(block.get(), ORDER_ARENA_BYTES, pmr::new_delete_resource())
+        {
+            traceln(ARENA_TAG, "order_arena_t()");
+
+            this->allocations = 0;
+            this->bytes = 0;
+            this->totalAllocations = 0;
+            this->totalBytes = 0;
+            this->orders = 0;
+            this->peakBytes = 0;
+
+            traceln(ARENA_TAG, "order_arena_t() - END");
+
+        }   /* order_arena_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Da por terminado el pedido: suma sus contadores a los totales
+         *         y vacía la arena. Nada de lo reservado puede seguir en uso.
+         * @param  void
+         * @return void
+         */
+        void
+        end_order(void)
+        {
+            totalAllocations += allocations;
+            totalBytes += bytes;
+            peakBytes = std::max(peakBytes, bytes);
+            orders++;
+
+            allocations = 0;
+            bytes = 0;
+            arena.release();
+
+        }   /* end_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de pedidos terminados.
+         * @param  void
+         * @return Número de pedidos.
+         */
+        size_t
+        get_orders(void)
+        {
+            return orders;
+
+        }   /* get_orders() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve las reservas de los pedidos terminados.
+         * @param  void
+         * @return Número de reservas.
+         */
+        size_t
+        get_total_allocations(void)
+        {
+            return totalAllocations;
+
+        }   /* get_total_allocations() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve los bytes reservados por los pedidos terminados.
+         * @param  void
+         * @return Número de bytes.
+         */
+        size_t
+        get_total_bytes(void)
+        {
+            return totalBytes;
+
+        }   /* get_total_bytes() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve los bytes del pedido que más ha reservado.
+         * @param  void
+         * @return Número de bytes.
+         */
+        size_t
+        get_peak_bytes(void)
+        {
+            return peakBytes;
+
+        }   /* get_peak_bytes() */
+};
+
+#endif /* ORDER_ARENA_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,172 @@
+/**
+ * @file     order_generator_t.h
+ *
+ * @brief    Generador de pedidos sintéticos a partir del catálogo de SKU.
+ *
+ * Los identificadores siguen el formato de los pedidos reales que entiende
+ * item_t ("<familia>_<modelo>_<variante>" o "<familia>_<modelo>_funda"), con
+ * las familias de SKU_FAMILY_TYPE. Cada pedido elige una caja (S, M o L) y
+ * añade items hasta llegar a un volumen objetivo entre GENERATOR_FILL_MIN y
+ * GENERATOR_FILL_MAX del de la caja, así que hay pedidos que caben holgados,
+ * justos y que no caben. El pedido número index solo depende de la semilla y
+ * de index: se pueden generar en cualquier orden y desde varios hilos.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del generador de pedidos
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef ORDER_GENERATOR_T_H
+#define ORDER_GENERATOR_T_H
+
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+
+using namespace std;
+
+// static const char * GENERATOR_TAG = __FILE__;
+static const char * GENERATOR_TAG = "order_generator_t.h";
+
+// Modelos (A, B, ...) y variantes (01, 02, ...) de cada familia.
+#define GENERATOR_MODELS   6
+#define GENERATOR_VARIANTS 3
+
+// Volumen objetivo de los items de un pedido, en fracción de la caja.
+#define GENERATOR_FILL_MIN 0.20
+#define GENERATOR_FILL_MAX 1.10
+
+// Frecuencia relativa de cada tipo de item (en el orden de itemType_t) y de
+// cada caja (en el orden de boxType_t).
+static const double GENERATOR_TYPE_WEIGHTS[NUM_ITEM_TYPES] = {10, 12, 15, 30, 5, 8, 8, 12};
+static const double GENERATOR_BOX_WEIGHTS[3] = {40, 35, 25};
+
+class order_generator_t
+{
+    private:
+
+        // ATRIBUTOS.
+        uint64_t seed;
+        vector<string> ids[NUM_ITEM_TYPES]; // identificadores de cada tipo
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la palabra del identificador de un tipo de item.
+         */
+        static const char *
+        family_of(itemType_t type)
+        {
+            switch (type)
+            {
+                case PULSERA:        return ("pulsera");
+                case RELOJ:          return ("reloj");
+                case FUNDA_TELEFONO:
+                case TELEFONO:       return ("telefono");
+                case FUNDA_EREADER:
+                case EREADER:        return ("ereader");
+                default:             return ("tablet");
+            }
+
+        }   /* family_of() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase order_generator_t. Prepara los
+         *         identificadores de todos los SKU que puede generar.
+         * @param  seed  La semilla.
+         */
+        order_generator_t(uint64_t seed)
+        {
+            traceln(GENERATOR_TAG, "order_generator_t()");
+
+            this->seed = seed;
+
+            for (int t = 0; t < NUM_ITEM_TYPES; t++)
+            {
+                itemType_t type = (itemType_t)t;
+                bool funda = (type == FUNDA_TELEFONO) || (type == FUNDA_EREADER) || (type == FUNDA_TABLET);
+
+                for (int m = 0; m < GENERATOR_MODELS; m++)
+                {
+                    string prefix = string(family_of(type)) + "_" + (char)('A' + m) + "_";
+
+                    if (funda)
+                    {
+                        ids[t].push_back(prefix + "funda");
+                        continue;
+                    }
+
+                    for (int v = 1; v <= GENERATOR_VARIANTS; v++)
+                    {
+                        ids[t].push_back(prefix + "0" + (char)('0' + v));
+                    }
+                }
+            }
+
+            traceln(GENERATOR_TAG, "order_generator_t() - END");
+
+        }   /* order_generator_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Genera el pedido número index.
+         * @param  index    Número del pedido.
+         * @param  items    Donde se dejan los items (se vacía antes).
+         * @param  boxType  Donde se deja la caja del pedido.
+         * @return void
+         */
+        void
+        generate(uint64_t index, list<item_t> * items, boxType_t * boxType) const
+        {
+            // Cada pedido tiene su propio generador: no depende de los anteriores.
+            mt19937_64 rng(seed ^ (index * 0x9E3779B97F4A7C15ULL));
+            discrete_distribution<int> pickBox(GENERATOR_BOX_WEIGHTS, GENERATOR_BOX_WEIGHTS + 3);
+            discrete_distribution<int> pickType(GENERATOR_TYPE_WEIGHTS, GENERATOR_TYPE_WEIGHTS + NUM_ITEM_TYPES);
+            uniform_real_distribution<double> pickFill(GENERATOR_FILL_MIN, GENERATOR_FILL_MAX);
+
+            *boxType = (boxType_t)pickBox(rng);
+
+            space_t boxSize = box_t::size_of(*boxType);
+            double target = pickFill(rng) * boxSize.max_x() * boxSize.max_y() * boxSize.max_z();
+            double volume = 0.0;
+
+            items->clear();
+
+            while ((items->empty()) || (volume < target))
+            {
+                int type = pickType(rng);
+                const sku_catalog_entry_t & entry = SKU_CATALOG[type];
+
+                items->push_back(item_t(ids[type][uniform_int_distribution<size_t>(0, ids[type].size() - 1)(rng)]));
+                volume += (double)entry.x * entry.y * entry.z;
+            }
+
+        }   /* generate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la semilla del generador.
+         * @param  void
+         * @return La semilla.
+         */
+        uint64_t
+        get_seed(void)
+        {
+            return seed;
+
+        }   /* get_seed() */
+};
+
+#endif /* ORDER_GENERATOR_T_H */
+
+/*** end of file ***/
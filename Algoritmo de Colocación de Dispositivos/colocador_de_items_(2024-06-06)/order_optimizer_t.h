@@ -0,0 +1,481 @@
+/**
+ * @file     order_optimizer_t.h
+ *
+ * @brief    Optimizador "anytime" del orden de colocación de los items.
+ *
+ * El resultado de cualquier motor depende mucho del orden de los items. Cada
+ * hilo ejecuta un recocido simulado (simulated annealing) sobre permutaciones
+ * del pedido: en cada paso intercambia o mueve un item, coloca el pedido en
+ * ese orden y acepta el cambio si mejora o, con una probabilidad que baja con
+ * la temperatura, aunque empeore. Al agotarse el tiempo (o el número máximo de
+ * evaluaciones) se devuelve la mejor colocación encontrada por todos los hilos.
+ *
+ * La puntuación es la fracción del volumen del pedido que se ha colocado y, si
+ * cabe todo, 1 más lo que se ahorra respecto a una caja L. Así cualquier orden
+ * que lo coloque todo gana a uno que no, y entre ellos gana la caja menor.
+ *
+ * Cada hilo usa su propio generador con semilla (seed + índice del hilo) y el
+ * ganador se elige por puntuación y, a igualdad, por el índice del hilo. Con
+ * la misma semilla, número de hilos y número de evaluaciones el resultado es
+ * siempre el mismo; con un límite de tiempo, lo es mientras cada hilo llegue a
+ * hacer las mismas evaluaciones.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del optimizador de orden
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef ORDER_OPTIMIZER_T_H
+#define ORDER_OPTIMIZER_T_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "box_selector_t.h"
+#include "placement_strategy_t.h"
+
+using namespace std;
+
+// static const char * OPTIMIZER_TAG = __FILE__;
+static const char * OPTIMIZER_TAG = "order_optimizer_t.h";
+
+// Límite de tiempo por defecto del optimizador (ms).
+#define OPTIMIZER_TIME_LIMIT_MS 20
+
+// Parámetros del recocido simulado (la puntuación va de 0 a 2).
+#define OPTIMIZER_INITIAL_TEMPERATURE 0.05
+#define OPTIMIZER_MIN_TEMPERATURE     0.0005
+#define OPTIMIZER_COOLING             0.97
+
+typedef struct
+{
+    boxType_t boxType;   // caja del pedido (se ignora si autoBox)
+    bool autoBox;        // buscar también la caja más pequeña
+    packingEngine_t engine;
+    unsigned timeLimitMs;      // 0 = sin límite de tiempo
+    size_t maxEvaluations;     // por hilo, 0 = sin límite
+    unsigned numThreads;       // 0 = uno por núcleo
+    uint64_t seed;
+    const atomic<bool> * cancelFlag; // cancelación externa (opcional)
+
+} optimizer_options_t;
+
+class order_optimizer_t
+{
+    private:
+
+        // Estado de la búsqueda de un hilo.
+        typedef struct
+        {
+            vector<size_t> best;  // mejor permutación encontrada
+            double bestScore;
+            size_t evaluations;
+
+        } chain_result_t;
+
+        // ATRIBUTOS.
+        optimizer_options_t options;
+        vector<item_t> items;
+        uint64_t itemsVolume;
+        double perfectScore; // todo colocado en la menor caja posible
+        chrono::steady_clock::time_point deadline;
+        atomic<bool> stop; // fin del tiempo o cancelación externa
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si hay que terminar la búsqueda.
+         */
+        bool
+        must_stop(void)
+        {
+            if (!(stop.load(memory_order_relaxed)))
+            {
+                if (((options.cancelFlag != NULL) && options.cancelFlag->load(memory_order_relaxed)) ||
+                    ((options.timeLimitMs > 0) && (chrono::steady_clock::now() >= deadline)))
+                {
+                    stop = true;
+                }
+            }
+
+            return (stop.load(memory_order_relaxed));
+
+        }   /* must_stop() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca los items en el orden de la permutación.
+         * @param  order        La permutación de índices de items.
+         * @param  cancellable  Si es verdadero, la evaluación se interrumpe al
+         *                      terminar la búsqueda.
+         * @param  result       Devuelve la caja llena (reservada con new) o NULL.
+         * @return La puntuación (negativa si la evaluación se ha cancelado).
+         */
+        double
+        evaluate(const vector<size_t> & order, bool cancellable, box_t ** result)
+        {
+            list<item_t> ordered; // en modo autoBox, se copia a cada caja
+            const boxType_t types[NUM_BOX_TYPES] = {BOX_S, BOX_M, BOX_L};
+            double score = -1.0;
+            box_t * box = NULL;
+
+            for (size_t i = 0; (i < order.size()) && (options.autoBox); i++)
+            {
+                ordered.push_back(items[order[i]]);
+            }
+
+            for (int t = 0; t < NUM_BOX_TYPES; t++)
+            {
+                boxType_t type = (options.autoBox) ? (types[t]) : (options.boxType);
+
+                // En modo autoBox la última caja se usa aunque no quepa todo.
+                if (options.autoBox && (type != BOX_L) && !(box_selector_t::may_fit(type, &ordered)))
+                {
+                    continue;
+                }
+
+                delete box;
+                if (options.autoBox)
+                {
+                    box = new box_t(type, &ordered);
+                }
+                else
+                {
+                    // Una sola caja: se queda con los nodos de la lista.
+                    pmr::list<item_t> own;
+
+                    for (size_t i = 0; i < order.size(); i++)
+                    {
+                        own.push_back(items[order[i]]);
+                    }
+                    box = new box_t(type, std::move(own));
+                }
+                box->set_engine(options.engine);
+                if (cancellable)
+                {
+                    box->set_cancel_flag(&stop);
+                    if (options.timeLimitMs > 0)
+                    {
+                        box->set_deadline(deadline);
+                    }
+                }
+                box->place_items_in_box();
+
+                if (box->is_cancelled())
+                {
+                    delete box;
+                    box = NULL;
+                    score = -1.0;
+                    break;
+                }
+
+                score = score_of(box);
+
+                if ((box->get_num_items_to_place() == 0) || !(options.autoBox))
+                {
+                    break;
+                }
+            }
+
+            if (result != NULL)
+            {
+                *result = box;
+            }
+            else
+            {
+                delete box;
+            }
+
+            return (score);
+
+        }   /* evaluate() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Puntuación de una caja llena.
+         */
+        double
+        score_of(box_t * box)
+        {
+            if (box->get_num_items_to_place() == 0)
+            {
+                return (full_score(box->get_type()));
+            }
+
+            space_t s = box->get_size();
+            double boxVolume = (double)s.max_x() * s.max_y() * s.max_z();
+
+            return ((box->get_fill_ratio() * boxVolume) / itemsVolume);
+
+        }   /* score_of() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Puntuación de colocar todo el pedido en un tipo de caja.
+         */
+        static double
+        full_score(boxType_t type)
+        {
+            space_t s = box_t::size_of(type);
+            space_t l = box_t::size_of(BOX_L);
+
+            return (2.0 - (((double)s.max_x() * s.max_y() * s.max_z()) /
+                           ((double)l.max_x() * l.max_y() * l.max_z())));
+
+        }   /* full_score() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos permutaciones tienen los mismos SKUs en las
+         *         mismas posiciones (y, por tanto, la misma colocación).
+         */
+        bool
+        same_skus(const vector<size_t> & a, const vector<size_t> & b)
+        {
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                if (items[a[i]].get_sku() != items[b[i]].get_sku())
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+
+        }   /* same_skus() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Recocido simulado de un hilo.
+         * @param  index   Índice del hilo (fija la semilla y el orden inicial).
+         * @param  result  Devuelve la mejor permutación del hilo.
+         * @return void
+         */
+        void
+        run_chain(unsigned index, chain_result_t * result)
+        {
+            traceln(OPTIMIZER_TAG, "run_chain()");
+
+            mt19937_64 rng(options.seed + index);
+            uniform_real_distribution<double> uniform(0.0, 1.0);
+            vector<size_t> current(items.size());
+            double currentScore, temperature = OPTIMIZER_INITIAL_TEMPERATURE;
+            bool severalSkus = false; // si no, todas las permutaciones son iguales
+
+            for (size_t i = 0; i < current.size(); i++)
+            {
+                current[i] = i;
+                severalSkus = severalSkus || (items[i].get_sku() != items[0].get_sku());
+            }
+
+            // 1) Orden inicial: el del pedido, las ordenaciones de
+            //    placement_strategy_t o una permutación aleatoria.
+            if ((index > 0) && (index <= 3))
+            {
+                initial_order((itemOrder_t)index, &current);
+            }
+            else if (index > 3)
+            {
+                shuffle(current.begin(), current.end(), rng);
+            }
+
+            currentScore = evaluate(current, true, NULL);
+            result->best = current;
+            result->bestScore = currentScore;
+            result->evaluations = 1;
+
+            // 2) Vecinos: intercambiar dos items o mover uno a otra posición.
+            //    Los que solo cambian de sitio copias de un mismo SKU dan la
+            //    misma colocación y no se evalúan.
+            while (severalSkus && (result->bestScore < perfectScore) && !(must_stop()) &&
+                   ((options.maxEvaluations == 0) || (result->evaluations < options.maxEvaluations)))
+            {
+                vector<size_t> candidate = current;
+                size_t a = rng() % candidate.size();
+                size_t b = rng() % candidate.size();
+
+                if (rng() & 1)
+                {
+                    swap(candidate[a], candidate[b]);
+                }
+                else
+                {
+                    size_t moved = candidate[a];
+                    candidate.erase(candidate.begin() + a);
+                    candidate.insert(candidate.begin() + b, moved);
+                }
+
+                if (same_skus(candidate, current))
+                {
+                    continue;
+                }
+
+                double score = evaluate(candidate, true, NULL);
+                double draw = uniform(rng);
+
+                if (score < 0.0)
+                {
+                    break; // evaluación cancelada
+                }
+
+                result->evaluations++;
+
+                if ((score >= currentScore) || (draw < exp((score - currentScore) / temperature)))
+                {
+                    current = candidate;
+                    currentScore = score;
+                }
+
+                if (score > result->bestScore)
+                {
+                    result->best = candidate;
+                    result->bestScore = score;
+                }
+
+                // 3) Enfriar y, al llegar al mínimo, recalentar desde el mejor.
+                temperature *= OPTIMIZER_COOLING;
+                if (temperature < OPTIMIZER_MIN_TEMPERATURE)
+                {
+                    temperature = OPTIMIZER_INITIAL_TEMPERATURE;
+                    current = result->best;
+                    currentScore = result->bestScore;
+                }
+            }
+
+            traceln(OPTIMIZER_TAG, "run_chain() - END");
+
+        }   /* run_chain() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Ordena la permutación con una de las reglas de itemOrder_t
+         *         (de forma estable, igual que placement_strategy_t::sort_items()).
+         */
+        void
+        initial_order(itemOrder_t order, vector<size_t> * permutation)
+        {
+            vector<uint64_t> keys(items.size());
+
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                keys[i] = placement_strategy_t::sort_key(&items[i], order);
+            }
+
+            stable_sort(permutation->begin(), permutation->end(),
+                        [&keys](size_t a, size_t b) { return (keys[a] > keys[b]); });
+
+        }   /* initial_order() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase order_optimizer_t.
+         * @param  options  Opciones de la búsqueda.
+         */
+        order_optimizer_t(optimizer_options_t options)
+        {
+            traceln(OPTIMIZER_TAG, "order_optimizer_t()");
+
+            this->options = options;
+            this->itemsVolume = 0;
+            this->stop = false;
+
+            if (this->options.numThreads == 0)
+            {
+                this->options.numThreads = thread::hardware_concurrency();
+                this->options.numThreads = (this->options.numThreads == 0) ? (1) : (this->options.numThreads);
+            }
+
+            traceln(OPTIMIZER_TAG, "order_optimizer_t() - END");
+
+        }   /* order_optimizer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca el mejor orden de colocación de los items.
+         * @param  itemsToPlace  Los items del pedido.
+         * @param  result        Devuelve la caja con la mejor colocación
+         *                       (reservada con new, la libera quien llama).
+         * @return Número total de evaluaciones realizadas.
+         */
+        size_t
+        optimize(list<item_t> * itemsToPlace, box_t ** result)
+        {
+            traceln(OPTIMIZER_TAG, "optimize()");
+
+            vector<chain_result_t> chains(options.numThreads);
+            vector<thread> workers;
+            size_t evaluations = 0, winner = 0;
+
+            items.assign(itemsToPlace->begin(), itemsToPlace->end());
+            itemsVolume = 0;
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                space_t s = items[i].get_size();
+                itemsVolume += (uint64_t)s.max_x() * s.max_y() * s.max_z();
+            }
+            itemsVolume = (itemsVolume == 0) ? (1) : (itemsVolume);
+
+            // Ningún orden puede mejorar "todo colocado en la menor caja que
+            // supera la cota de box_selector_t::may_fit()".
+            perfectScore = full_score(options.boxType);
+            if (options.autoBox)
+            {
+                const boxType_t types[NUM_BOX_TYPES] = {BOX_S, BOX_M, BOX_L};
+                perfectScore = full_score(BOX_L);
+
+                for (int t = (NUM_BOX_TYPES - 1); t >= 0; t--)
+                {
+                    if (box_selector_t::may_fit(types[t], itemsToPlace))
+                    {
+                        perfectScore = full_score(types[t]);
+                    }
+                }
+            }
+
+            deadline = chrono::steady_clock::now() + chrono::milliseconds(options.timeLimitMs);
+            stop = false;
+
+            // 1) Una cadena de recocido por hilo.
+            for (unsigned i = 0; i < options.numThreads; i++)
+            {
+                workers.push_back(thread(&order_optimizer_t::run_chain, this, i, &chains[i]));
+            }
+
+            for (unsigned i = 0; i < options.numThreads; i++)
+            {
+                workers[i].join();
+                evaluations += chains[i].evaluations;
+
+                // 2) Gana la mejor puntuación; a igualdad, el hilo de menor índice.
+                if (chains[i].bestScore > chains[winner].bestScore)
+                {
+                    winner = i;
+                }
+            }
+
+            // 3) Repetir la mejor colocación (sin cancelación) para devolverla.
+            evaluate(chains[winner].best, false, result);
+
+            traceln(OPTIMIZER_TAG, "optimize() - END");
+            return (evaluations);
+
+        }   /* optimize() */
+};
+
+#endif /* ORDER_OPTIMIZER_T_H */
+
+/*** end of file ***/
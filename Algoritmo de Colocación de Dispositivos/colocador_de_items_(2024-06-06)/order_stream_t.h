@@ -0,0 +1,638 @@
+/**
+ * @file     order_stream_t.h
+ *
+ * @brief    Lectura de pedidos en flujo (JSON Lines o CSV) y escritura de las
+ *           órdenes para el robot industrial, una por línea.
+ *
+ * Cada línea de entrada es un pedido en uno de estos dos formatos:
+ *
+ *   {"tipo_caja": "S", "dispositivos": ["tablet_A_01", "reloj_B_01"]}
+ *   S,tablet_A_01,reloj_B_01
+ *
+ * Con "auto" como tipo de caja se usa la caja más pequeña en la que cabe. Los
+ * identificadores tienen que ser de items del catálogo y solo pueden tener
+ * letras, dígitos y '_' (ver item_t::is_valid_id()); si no, la línea da un
+ * error. Un identificador rechazado no se registra en sku_registry_t. Si en
+ * una caja no caben todos los items, su orden lleva "num_no_colocados".
+ *
+ * Con set_format(ORDER_FORMAT_MSGPACK), cada pedido se escribe como un
+ * objeto MessagePack (la orden, el array de órdenes con varias cajas o el
+ * mapa {"error", "linea"}) sin separadores: los objetos se leen uno detrás de
+ * otro.
+ *
+ * La lectura, la colocación y la escritura trabajan en paralelo: el hilo que
+ * llama a run() lee y analiza las líneas, los hilos de un work_stealing_pool_t
+ * colocan los pedidos y generan su orden JSON, y un hilo escritor las vuelca en
+ * el orden de entrada en cuanto están listas. Como mucho hay STREAM_WINDOW
+ * pedidos por hilo en vuelo, así que la memoria no depende del tamaño de la
+ * entrada. Con una packing_cache_t, los pedidos repetidos (los mismos
+ * dispositivos, en cualquier orden) salen de la caché sin volver a colocarse.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la lectura en flujo
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef ORDER_STREAM_T_H
+#define ORDER_STREAM_T_H
+
+#include <condition_variable>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "batch_packer_t.h"
+#include "multi_box_packer_t.h"
+#include "order_writer_t.h"
+#include "packing_cache_t.h"
+#include "work_stealing_pool_t.h"
+
+using namespace std;
+
+// static const char * STREAM_TAG = __FILE__;
+static const char * STREAM_TAG = "order_stream_t.h";
+
+// Pedidos en vuelo por cada hilo de colocación.
+#define STREAM_WINDOW 64
+
+class order_stream_t
+{
+    private:
+
+        // ATRIBUTOS.
+        work_stealing_pool_t pool;
+        packingEngine_t engine;
+        bool multiBox;            // repartir cada pedido en varias cajas
+        packing_cache_t * cache;  // caché de resultados (opcional)
+        orderFormat_t format;     // formato de las órdenes
+        size_t window;
+        vector<string> slots;     // orden generada de cada pedido en vuelo
+        vector<char> ready;       // slots[i] está listo para escribirse
+        size_t nextToWrite;
+        size_t totalOrders;
+        bool inputDone;
+        mutex lock;
+        condition_variable slotReady;
+        condition_variable slotFree;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Salta los espacios en blanco de line a partir de pos.
+         */
+        static void
+        skip_spaces(const string & line, size_t * pos)
+        {
+            while ((*pos < line.size()) && ((line[*pos] == ' ') || (line[*pos] == '\t') ||
+                                             (line[*pos] == '\r') || (line[*pos] == '\n')))
+            {
+                (*pos)++;
+            }
+
+        }   /* skip_spaces() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Lee una cadena JSON ("...") de line a partir de pos.
+         * @return Verdadero si se ha leído correctamente.
+         */
+        static bool
+        read_json_string(const string & line, size_t * pos, string * value)
+        {
+            skip_spaces(line, pos);
+
+            if ((*pos >= line.size()) || (line[*pos] != '"'))
+            {
+                return (false);
+            }
+
+            value->clear();
+            for ((*pos)++; *pos < line.size(); (*pos)++)
+            {
+                if (line[*pos] == '"')
+                {
+                    (*pos)++;
+                    return (true);
+                }
+
+                if ((line[*pos] == '\\') && ((*pos + 1) < line.size()))
+                {
+                    (*pos)++;
+                }
+
+                value->push_back(line[*pos]);
+            }
+
+            return (false);
+
+        }   /* read_json_string() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Convierte "S", "M" o "L" en el boxType_t correspondiente, o
+         *         "auto" en un pedido con selección automática de caja.
+         * @return Verdadero si el texto es un tipo de caja válido.
+         */
+        static bool
+        parse_box_type(const string & text, order_t * order)
+        {
+            boxType_t * boxType = &(order->boxType);
+            bool answer = true;
+
+            order->autoBox = false;
+
+            if ((text == "auto") || (text == "AUTO"))
+            {
+                order->autoBox = true;
+                *boxType = BOX_L;
+            }
+            else if ((text == "S") || (text == "s"))
+            {
+                *boxType = BOX_S;
+            }
+            else if ((text == "M") || (text == "m"))
+            {
+                *boxType = BOX_M;
+            }
+            else if ((text == "L") || (text == "l"))
+            {
+                *boxType = BOX_L;
+            }
+            else
+            {
+                answer = false;
+            }
+
+            return (answer);
+
+        }   /* parse_box_type() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Analiza un pedido en formato JSON (una línea).
+         */
+        static bool
+        parse_json_order(const string & line, order_t * order)
+        {
+            string value;
+            size_t pos;
+            bool hasBox = false, hasItems = false;
+
+            // 1) "tipo_caja": "S" | "M" | "L"
+            pos = line.find("\"tipo_caja\"");
+            if (pos != string::npos)
+            {
+                pos = line.find(':', pos);
+                hasBox = (pos != string::npos) && read_json_string(line, &(++pos), &value) &&
+                         parse_box_type(value, order);
+            }
+
+            // 2) "dispositivos": ["id", "id", ...]
+            pos = line.find("\"dispositivos\"");
+            if (pos != string::npos)
+            {
+                pos = line.find('[', pos);
+                hasItems = (pos != string::npos);
+
+                if (hasItems)
+                {
+                    pos++;
+                    skip_spaces(line, &pos);
+
+                    while (hasItems && (pos < line.size()) && (line[pos] != ']'))
+                    {
+                        hasItems = read_json_string(line, &pos, &value) && item_t::is_valid_id(value);
+                        if (hasItems)
+                        {
+                            order->items.push_back(item_t(value));
+                            hasItems = order->items.back().is_registered() && order->items.back().is_known();
+                        }
+
+                        skip_spaces(line, &pos);
+                        if ((pos < line.size()) && (line[pos] == ','))
+                        {
+                            pos++;
+                        }
+                        skip_spaces(line, &pos);
+                    }
+
+                    hasItems = hasItems && (pos < line.size());
+                }
+            }
+
+            return (hasBox && hasItems);
+
+        }   /* parse_json_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Analiza un pedido en formato CSV: tipo de caja y después los
+         *         identificadores de los items separados por comas.
+         */
+        static bool
+        parse_csv_order(const string & line, order_t * order)
+        {
+            size_t first = 0, last;
+            bool hasBox = false;
+
+            while (first <= line.size())
+            {
+                last = line.find(',', first);
+                last = (last == string::npos) ? (line.size()) : (last);
+
+                // Recortar espacios a ambos lados del campo.
+                size_t a = first, b = last;
+                while ((a < b) && ((line[a] == ' ') || (line[a] == '\t'))) { a++; }
+                while ((b > a) && ((line[b - 1] == ' ') || (line[b - 1] == '\t') ||
+                                   (line[b - 1] == '\r'))) { b--; }
+
+                if (hasBox == false)
+                {
+                    hasBox = parse_box_type(line.substr(a, b - a), order);
+                    if (hasBox == false)
+                    {
+                        return (false);
+                    }
+                }
+                else if (b > a)
+                {
+                    string id = line.substr(a, b - a);
+
+                    if (!(item_t::is_valid_id(id)))
+                    {
+                        return (false);
+                    }
+
+                    order->items.push_back(item_t(id));
+                    if (!(order->items.back().is_registered()) || !(order->items.back().is_known()))
+                    {
+                        return (false);
+                    }
+                }
+
+                first = last + 1;
+            }
+
+            return (hasBox);
+
+        }   /* parse_csv_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Hilo escritor: vuelca las órdenes en el orden de entrada.
+         * @param  out  Flujo de salida.
+         * @return void
+         */
+        void
+        writer_loop(ostream * out)
+        {
+            traceln(STREAM_TAG, "writer_loop()");
+
+            unique_lock<mutex> guard(lock);
+
+            while (true)
+            {
+                size_t slot = nextToWrite % window;
+
+                if (ready[slot])
+                {
+                    string line;
+                    line.swap(slots[slot]);
+                    ready[slot] = false;
+                    nextToWrite++;
+                    slotFree.notify_one();
+
+                    guard.unlock();
+                    out->write(line.data(), line.size());
+                    if (format == ORDER_FORMAT_JSON)
+                    {
+                        (*out) << '\n';
+                    }
+                    guard.lock();
+                }
+                else if (inputDone && (nextToWrite == totalOrders))
+                {
+                    break;
+                }
+                else
+                {
+                    // Nada listo: vaciar lo escrito antes de esperar.
+                    guard.unlock();
+                    out->flush();
+                    guard.lock();
+
+                    slotReady.wait(guard, [this]()
+                    {
+                        return (ready[nextToWrite % window] || (inputDone && (nextToWrite == totalOrders)));
+                    });
+                }
+            }
+
+            out->flush();
+
+            traceln(STREAM_TAG, "writer_loop() - END");
+
+        }   /* writer_loop() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda el resultado de un pedido y avisa al escritor.
+         */
+        void
+        publish(size_t sequence, string * text)
+        {
+            lock_guard<mutex> guard(lock);
+
+            slots[sequence % window].swap(*text);
+            ready[sequence % window] = true;
+            slotReady.notify_one();
+
+        }   /* publish() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Genera la respuesta a una línea que no es un pedido válido.
+         */
+        static void
+        error_order(const char * message, size_t lineNumber, orderFormat_t format, string * text)
+        {
+            if (format == ORDER_FORMAT_MSGPACK)
+            {
+                order_writer_t out(text);
+
+                out.put_msgpack_map(2);
+                out.put_msgpack_str("error", 5);
+                out.put_msgpack_str(message, strlen(message));
+                out.put_msgpack_str("linea", 5);
+                out.put_msgpack_uint(lineNumber);
+                out.flush();
+            }
+            else
+            {
+                *text = string("{\"error\": \"") + message + "\", \"linea\": " + to_string(lineNumber) + "}";
+            }
+
+        }   /* error_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Reparte un pedido en varias cajas y devuelve sus órdenes como un
+         *         array JSON en una sola línea (o un array MessagePack).
+         */
+        static void
+        pack_multi_box(order_t * order, packingEngine_t engine, orderFormat_t format, string * text,
+                       packing_cache_t * cache)
+        {
+            vector<string> orders;
+            cached_packing_t cached;
+            string key;
+
+            if (cache != NULL)
+            {
+                key = packing_cache_t::make_key(&(order->items), order->boxType, false, true,
+                                                engine, true, format);
+
+                if (cache->lookup(key, &cached))
+                {
+                    *text = cached.mqtt_order;
+                    return;
+                }
+            }
+
+            size_t unplaceable = multi_box_packer_t::pack_to_mqtt_orders(&(order->items), engine,
+                                                                         MULTI_BOX_TIME_LIMIT_MS, true,
+                                                                         &orders, format);
+
+            text->clear();
+            if (format == ORDER_FORMAT_MSGPACK)
+            {
+                order_writer_t out(text);
+
+                out.put_msgpack_array(orders.size());
+                for (size_t i = 0; i < orders.size(); i++)
+                {
+                    out.put(orders[i].data(), orders[i].size());
+                }
+                out.flush();
+            }
+            else
+            {
+                *text = "[";
+                for (size_t i = 0; i < orders.size(); i++)
+                {
+                    *text += (i == 0) ? ("") : (", ");
+                    *text += orders[i];
+                }
+                *text += "]";
+            }
+
+            if (cache != NULL)
+            {
+                cached.mqtt_order = *text;
+                cached.placedItems = order->items.size() - unplaceable;
+                cached.unplacedItems = unplaceable;
+                cache->insert(key, cached);
+            }
+
+        }   /* pack_multi_box() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase order_stream_t.
+         * @param  numThreads  Número de hilos de colocación (0 = uno por núcleo).
+         * @param  engine      Motor de colocación de cada box_t.
+         */
+        order_stream_t(unsigned numThreads, packingEngine_t engine) : pool(numThreads)
+        {
+            traceln(STREAM_TAG, "order_stream_t()");
+
+            this->engine = engine;
+            this->multiBox = false;
+            this->cache = NULL;
+            this->format = ORDER_FORMAT_JSON;
+            this->window = STREAM_WINDOW * pool.get_num_threads();
+
+            traceln(STREAM_TAG, "order_stream_t() - END");
+
+        }   /* order_stream_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Activa el reparto de cada pedido en varias cajas. Cada línea de
+         *         salida pasa a ser un array JSON con una orden por caja (el tipo
+         *         de caja del pedido se ignora).
+         * @param  enable  Verdadero para repartir en varias cajas.
+         * @return void
+         */
+        void
+        set_multi_box(bool enable)
+        {
+            this->multiBox = enable;
+
+        }   /* set_multi_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece la caché de resultados (o NULL para no usarla).
+         * @param  cache  La caché.
+         * @return void
+         */
+        void
+        set_cache(packing_cache_t * cache)
+        {
+            this->cache = cache;
+
+        }   /* set_cache() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Establece el formato de las órdenes de salida.
+         * @param  format  ORDER_FORMAT_JSON (por defecto, una por línea) u
+         *                 ORDER_FORMAT_MSGPACK (objetos seguidos).
+         * @return void
+         */
+        void
+        set_format(orderFormat_t format)
+        {
+            this->format = format;
+
+        }   /* set_format() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Analiza una línea de entrada (JSON Lines o CSV).
+         * @param  line   La línea a analizar.
+         * @param  order  El pedido resultante.
+         * @return Verdadero si la línea es un pedido válido.
+         */
+        static bool
+        parse_order_line(const string & line, order_t * order)
+        {
+            size_t pos = 0;
+
+            order->items.clear();
+            skip_spaces(line, &pos);
+
+            return (((pos < line.size()) && (line[pos] == '{')) ?
+                    (parse_json_order(line, order)) : (parse_csv_order(line, order)));
+
+        }   /* parse_order_line() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Procesa todos los pedidos de in y escribe una orden por línea en out.
+         *         Las líneas vacías se ignoran; las que no son un pedido válido
+         *         (con un identificador desconocido o que ya no cabe en
+         *         sku_registry_t) generan una línea {"error": ...} para no
+         *         desalinear la salida.
+         * @param  in   Flujo de entrada.
+         * @param  out  Flujo de salida.
+         * @return Número de pedidos procesados.
+         */
+        size_t
+        run(istream & in, ostream & out)
+        {
+            traceln(STREAM_TAG, "run()");
+
+            string line;
+            size_t sequence = 0, lineNumber = 0;
+
+            slots.assign(window, string());
+            ready.assign(window, false);
+            nextToWrite = 0;
+            totalOrders = 0;
+            inputDone = false;
+
+            thread writer(&order_stream_t::writer_loop, this, &out);
+
+            while (getline(in, line))
+            {
+                lineNumber++;
+
+                size_t pos = 0;
+                skip_spaces(line, &pos);
+                if (pos == line.size())
+                {
+                    continue;
+                }
+
+                // 1) Esperar a que haya un hueco libre en la ventana.
+                {
+                    unique_lock<mutex> guard(lock);
+                    slotFree.wait(guard, [this, sequence]() { return ((sequence - nextToWrite) < window); });
+                }
+
+                // 2) Analizar el pedido y enviarlo a los hilos de colocación.
+                order_t * order = new order_t;
+
+                if (parse_order_line(line, order))
+                {
+                    packingEngine_t packEngine = engine;
+                    orderFormat_t packFormat = format;
+
+                    bool packMultiBox = multiBox;
+                    packing_cache_t * packCache = cache;
+
+                    pool.submit([this, order, sequence, packEngine, packFormat, packMultiBox, packCache]()
+                    {
+                        order_result_t result;
+
+                        if (packMultiBox)
+                        {
+                            pack_multi_box(order, packEngine, packFormat, &(result.mqtt_order), packCache);
+                        }
+                        else
+                        {
+                            batch_packer_t::pack_order(order, packEngine, true, packFormat, &result, packCache);
+                        }
+
+                        delete order;
+                        publish(sequence, &(result.mqtt_order));
+                    });
+                }
+                else
+                {
+                    // Un item sin sitio en sku_registry_t invalida el pedido.
+                    bool registryFull = !(order->items.empty()) && !(order->items.back().is_registered());
+                    string error;
+
+                    error_order((registryFull) ? ("registro de SKU lleno") : ("pedido no valido"),
+                                lineNumber, format, &error);
+
+                    delete order;
+                    publish(sequence, &error);
+                }
+
+                sequence++;
+            }
+
+            // 3) Avisar al escritor de que no habrá más pedidos.
+            {
+                lock_guard<mutex> guard(lock);
+                totalOrders = sequence;
+                inputDone = true;
+                slotReady.notify_one();
+            }
+
+            writer.join();
+
+            traceln(STREAM_TAG, "run() - END");
+            return (sequence);
+
+        }   /* run() */
+};
+
+#endif /* ORDER_STREAM_T_H */
+
+/*** end of file ***/
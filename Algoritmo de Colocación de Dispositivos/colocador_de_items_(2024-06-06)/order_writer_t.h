@@ -0,0 +1,514 @@
+/**
+ * @file     order_writer_t.h
+ *
+ * @brief    Escritor secuencial de la orden JSON para el robot industrial.
+ *
+ * Los números se escriben con std::to_chars (sin locale ni reservas de
+ * memoria) y los valores con decimales se guardan en punto fijo, en décimas
+ * de mm o de grado, así que "120.5" sale siempre igual. El destino puede ser:
+ *
+ *  - un búfer del llamante: se escribe directamente en él; si no cabe todo,
+ *    se marca como truncado y se sigue contando lo que habría ocupado,
+ *  - un descriptor de fichero: se acumula en un búfer interno de
+ *    ORDER_WRITER_CHUNK bytes que se vacía con write(),
+ *  - un string (o un pmr::string): igual que el descriptor, pero se añade
+ *    al string.
+ *
+ * Para la orden binaria (ORDER_FORMAT_MSGPACK) hay además funciones que
+ * escriben los tipos de MessagePack que usa box_t::write_msgpack_order().
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del escritor de órdenes
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef ORDER_WRITER_T_H
+#define ORDER_WRITER_T_H
+
+#include <algorithm>
+#include <charconv>
+#include <errno.h>
+#include <memory_resource>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include "defines.h"
+#include "logger.h"
+
+using namespace std;
+
+// static const char * ORDER_WRITER_TAG = __FILE__;
+static const char * ORDER_WRITER_TAG = "order_writer_t.h";
+
+// Tamaño del búfer interno para los destinos descriptor y string.
+#define ORDER_WRITER_CHUNK 1024
+
+class order_writer_t
+{
+    private:
+
+        // ATRIBUTOS.
+        char chunk[ORDER_WRITER_CHUNK];
+        char * buffer;     // destino (búfer del llamante o chunk)
+        size_t capacity;
+        size_t used;       // bytes en buffer
+        size_t written;    // bytes totales escritos (o que se habrían escrito)
+        int fd;            // -1 si no se escribe en un descriptor
+        void * text;       // string o pmr::string (NULL si no se escribe en uno)
+        void (* append)(void * text, const char * data, size_t n);
+        bool truncated;
+        bool failed;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade n bytes al final de un string del tipo String.
+         */
+        template <typename String>
+        static void
+        append_to(void * text, const char * data, size_t n)
+        {
+            ((String *)text)->append(data, n);
+
+        }   /* append_to() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vacía chunk en el descriptor o en el string.
+         */
+        void
+        drain(void)
+        {
+            if (text != NULL)
+            {
+                append(text, chunk, used);
+            }
+            else if ((fd >= 0) && !failed)
+            {
+                size_t done = 0;
+
+                while (done < used)
+                {
+                    ssize_t n = ::write(fd, chunk + done, used - done);
+
+                    if ((n < 0) && (errno == EINTR))
+                    {
+                        continue;
+                    }
+
+                    if (n <= 0)
+                    {
+                        errorln(ORDER_WRITER_TAG, "drain() - error de escritura");
+                        failed = true;
+                        break;
+                    }
+                    done += n;
+                }
+            }
+
+            used = 0;
+
+        }   /* drain() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Deja al menos n bytes libres en buffer (si se puede).
+         * @return Verdadero si caben.
+         */
+        bool
+        reserve(size_t n)
+        {
+            if ((used + n) > capacity)
+            {
+                if (buffer == chunk)
+                {
+                    drain();
+                }
+                else
+                {
+                    truncated = true;
+                }
+            }
+
+            return ((used + n) <= capacity);
+
+        }   /* reserve() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe en un búfer del llamante (no se termina con '\0').
+         * @param  buffer    El búfer.
+         * @param  capacity  Su tamaño en bytes.
+         */
+        order_writer_t(char * buffer, size_t capacity)
+        {
+            this->buffer = buffer;
+            this->capacity = capacity;
+            this->used = 0;
+            this->written = 0;
+            this->fd = -1;
+            this->text = NULL;
+            this->append = NULL;
+            this->truncated = false;
+            this->failed = false;
+
+        }   /* order_writer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe en un descriptor de fichero (con un búfer interno).
+         * @param  fd  El descriptor.
+         */
+        order_writer_t(int fd) : order_writer_t(chunk, ORDER_WRITER_CHUNK)
+        {
+            this->fd = fd;
+
+        }   /* order_writer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade al final de un string (con un búfer interno).
+         * @param  text  El string.
+         */
+        order_writer_t(string * text) : order_writer_t(chunk, ORDER_WRITER_CHUNK)
+        {
+            this->text = text;
+            this->append = append_to<string>;
+
+        }   /* order_writer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade al final de un pmr::string (con un búfer interno).
+         * @param  text  El string.
+         */
+        order_writer_t(pmr::string * text) : order_writer_t(chunk, ORDER_WRITER_CHUNK)
+        {
+            this->text = text;
+            this->append = append_to<pmr::string>;
+
+        }   /* order_writer_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  El destructor de la clase order_writer_t (vacía el búfer interno).
+         */
+        ~order_writer_t(void)
+        {
+            flush();
+
+        }   /* ~order_writer_t() */
+
+        order_writer_t(const order_writer_t &) = delete;
+        order_writer_t & operator=(const order_writer_t &) = delete;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe n bytes.
+         * @param  data  Los bytes.
+         * @param  n     Cuántos.
+         * @return void
+         */
+        void
+        put(const char * data, size_t n)
+        {
+            written += n;
+
+            // Con el búfer del llamante ya truncado no se escribe nada más.
+            while ((n > 0) && !truncated)
+            {
+                if (!(reserve(1)))
+                {
+                    return; // búfer del llamante lleno
+                }
+
+                size_t part = std::min(n, capacity - used);
+                memcpy(buffer + used, data, part);
+                used += part;
+                data += part;
+                n -= part;
+            }
+
+        }   /* put() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe una cadena terminada en '\0'.
+         * @param  text  La cadena.
+         * @return void
+         */
+        void
+        put(const char * text)
+        {
+            put(text, strlen(text));
+
+        }   /* put() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un entero.
+         * @param  value  El valor.
+         * @return void
+         */
+        void
+        put_int(long value)
+        {
+            char digits[24];
+            to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+            put(digits, result.ptr - digits);
+
+        }   /* put_int() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un valor en punto fijo con un decimal.
+         * @param  tenths  El valor multiplicado por 10 (1205 se escribe "120.5").
+         * @return void
+         */
+        void
+        put_fixed1(long tenths)
+        {
+            char digits[24];
+            char * p = digits;
+            unsigned long magnitude = (tenths < 0) ? (0UL - (unsigned long)tenths) : ((unsigned long)tenths);
+
+            if (tenths < 0)
+            {
+                *p++ = '-';
+            }
+
+            p = std::to_chars(p, digits + sizeof(digits) - 2, magnitude / 10).ptr;
+            *p++ = '.';
+            *p++ = (char)('0' + (magnitude % 10));
+
+            put(digits, p - digits);
+
+        }   /* put_fixed1() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un byte.
+         * @param  value  El byte.
+         * @return void
+         */
+        void
+        put_byte(uint8_t value)
+        {
+            put((const char *)(&value), 1);
+
+        }   /* put_byte() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un entero de 16 o 32 bits en orden big-endian (el de
+         *         MessagePack).
+         * @param  value  El valor.
+         * @param  bytes  2 o 4.
+         * @return void
+         */
+        void
+        put_big_endian(uint32_t value, int bytes)
+        {
+            char data[4];
+
+            for (int b = 0; b < bytes; b++)
+            {
+                data[b] = (char)(value >> (8 * (bytes - 1 - b)));
+            }
+
+            put(data, bytes);
+
+        }   /* put_big_endian() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: cabecera de un mapa de n pares (n < 16).
+         */
+        void
+        put_msgpack_map(uint8_t n)
+        {
+            put_byte(0x80 | n);
+
+        }   /* put_msgpack_map() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: cabecera de un array. Con fixed16 siempre se usa
+         *         el formato array 16 (3 bytes), para que lo que sigue esté en
+         *         una posición fija.
+         */
+        void
+        put_msgpack_array(uint32_t n, bool fixed16 = false)
+        {
+            if ((n < 16) && !fixed16)
+            {
+                put_byte(0x90 | n);
+            }
+            else if (n <= 0xFFFF)
+            {
+                put_byte(0xdc);
+                put_big_endian(n, 2);
+            }
+            else
+            {
+                put_byte(0xdd);
+                put_big_endian(n, 4);
+            }
+
+        }   /* put_msgpack_array() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: cadena de texto.
+         */
+        void
+        put_msgpack_str(const char * text, size_t n)
+        {
+            if (n < 32)
+            {
+                put_byte(0xa0 | n);
+            }
+            else if (n <= 0xFF)
+            {
+                put_byte(0xd9);
+                put_byte(n);
+            }
+            else if (n <= 0xFFFF)
+            {
+                put_byte(0xda);
+                put_big_endian(n, 2);
+            }
+            else
+            {
+                put_byte(0xdb);
+                put_big_endian(n, 4);
+            }
+
+            put(text, n);
+
+        }   /* put_msgpack_str() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: entero sin signo en el formato más corto.
+         */
+        void
+        put_msgpack_uint(uint32_t value)
+        {
+            if (value < 128)
+            {
+                put_byte(value);
+            }
+            else if (value <= 0xFF)
+            {
+                put_byte(0xcc);
+                put_byte(value);
+            }
+            else if (value <= 0xFFFF)
+            {
+                put_byte(0xcd);
+                put_big_endian(value, 2);
+            }
+            else
+            {
+                put_byte(0xce);
+                put_big_endian(value, 4);
+            }
+
+        }   /* put_msgpack_uint() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: entero de 16 bits sin signo, siempre en 3 bytes.
+         */
+        void
+        put_msgpack_uint16(uint16_t value)
+        {
+            put_byte(0xcd);
+            put_big_endian(value, 2);
+
+        }   /* put_msgpack_uint16() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  MessagePack: valor en punto fijo con un decimal como float 32
+         *         (5 bytes; las décimas de .0 y .5 se representan exactas).
+         * @param  tenths  El valor multiplicado por 10.
+         */
+        void
+        put_msgpack_fixed1(long tenths)
+        {
+            float value = tenths / 10.0f;
+            uint32_t bits;
+
+            memcpy(&bits, &value, sizeof(bits));
+            put_byte(0xca);
+            put_big_endian(bits, 4);
+
+        }   /* put_msgpack_fixed1() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vacía el búfer interno (no hace nada con un búfer del llamante).
+         * @param  void
+         * @return void
+         */
+        void
+        flush(void)
+        {
+            if ((buffer == chunk) && (used > 0))
+            {
+                drain();
+            }
+
+        }   /* flush() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve los bytes escritos hasta ahora (con un búfer del
+         *         llamante truncado, los que se habrían escrito).
+         * @param  void
+         * @return Número de bytes.
+         */
+        size_t
+        get_written(void)
+        {
+            return written;
+
+        }   /* get_written() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el búfer del llamante se ha quedado pequeño.
+         * @param  void
+         * @return Verdadero o falso.
+         */
+        bool
+        is_truncated(void)
+        {
+            return truncated;
+
+        }   /* is_truncated() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si ha fallado alguna escritura en el descriptor.
+         * @param  void
+         * @return Verdadero o falso.
+         */
+        bool
+        has_failed(void)
+        {
+            return failed;
+
+        }   /* has_failed() */
+};
+
+#endif /* ORDER_WRITER_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,418 @@
+/**
+ * @file     packing_cache_t.h
+ *
+ * @brief    Caché de resultados de colocación con expulsión LRU.
+ *
+ * Los pedidos del almacén se repiten mucho: la misma mezcla de dispositivos
+ * vuelve una y otra vez, aunque en distinto orden. La clave de la caché es el
+ * multiconjunto de identificadores (ordenados), junto con el tipo de caja y
+ * las opciones que cambian el resultado (motor, caja automática, reparto en
+ * varias cajas y formato de la orden). El valor es la orden JSON ya generada
+ * y el número de items colocados y sin colocar, así que un acierto no vuelve
+ * a colocar nada.
+ *
+ * La caché tiene un tamaño máximo (se expulsa la entrada usada hace más
+ * tiempo), contadores de aciertos, fallos y expulsiones, y se puede guardar
+ * en un fichero y cargar de él para arrancar en caliente. Es segura entre
+ * hilos.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la caché de colocaciones
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef PACKING_CACHE_T_H
+#define PACKING_CACHE_T_H
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+
+using namespace std;
+
+// static const char * CACHE_TAG = __FILE__;
+static const char * CACHE_TAG = "packing_cache_t.h";
+
+// Número máximo de entradas por defecto.
+#define PACKING_CACHE_CAPACITY 4096
+
+// Primera línea del fichero de la caché (cambia si cambia el formato).
+#define PACKING_CACHE_HEADER "# packing_cache_t 1"
+
+typedef struct
+{
+    string mqtt_order;     // JSON format
+    size_t placedItems;    // items colocados
+    size_t unplacedItems;  // items que no han cabido
+
+} cached_packing_t;
+
+class packing_cache_t
+{
+    private:
+
+        typedef pair<string, cached_packing_t> entry_t;
+
+        // ATRIBUTOS.
+        size_t capacity;
+        list<entry_t> entries; // de la más reciente a la más antigua
+        unordered_map<string, list<entry_t>::iterator> index;
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        mutex lock;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Expulsa las entradas más antiguas hasta respetar la capacidad.
+         *         Se llama con lock tomado.
+         */
+        void
+        evict(void)
+        {
+            while (entries.size() > capacity)
+            {
+                index.erase(entries.back().first);
+                entries.pop_back();
+                evictions++;
+            }
+
+        }   /* evict() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escapa los saltos de línea, tabuladores y barras para guardar
+         *         un campo en una sola línea del fichero.
+         */
+        static string
+        escape(const string & text)
+        {
+            string answer;
+
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                if (text[i] == '\\')
+                {
+                    answer += "\\\\";
+                }
+                else if (text[i] == '\n')
+                {
+                    answer += "\\n";
+                }
+                else if (text[i] == '\t')
+                {
+                    answer += "\\t";
+                }
+                else
+                {
+                    answer += text[i];
+                }
+            }
+
+            return (answer);
+
+        }   /* escape() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Deshace escape().
+         */
+        static string
+        unescape(const string & text)
+        {
+            string answer;
+
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                if ((text[i] == '\\') && ((i + 1) < text.size()))
+                {
+                    i++;
+                    answer += (text[i] == 'n') ? ('\n') : ((text[i] == 't') ? ('\t') : (text[i]));
+                }
+                else
+                {
+                    answer += text[i];
+                }
+            }
+
+            return (answer);
+
+        }   /* unescape() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase packing_cache_t.
+         * @param  capacity  Número máximo de entradas.
+         */
+        packing_cache_t(size_t capacity = PACKING_CACHE_CAPACITY)
+        {
+            traceln(CACHE_TAG, "packing_cache_t()");
+
+            this->capacity = std::max((size_t)1, capacity);
+            this->hits = 0;
+            this->misses = 0;
+            this->evictions = 0;
+
+            traceln(CACHE_TAG, "packing_cache_t() - END");
+
+        }   /* packing_cache_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula la clave canónica de un pedido: las opciones seguidas
+         *         de los identificadores ordenados, de modo que dos pedidos con
+         *         los mismos dispositivos en distinto orden tienen la misma clave.
+         * @param  items       Los items del pedido.
+         * @param  boxType     El tipo de caja (se ignora con autoBox o multiBox).
+         * @param  autoBox     Elegir la caja más pequeña.
+         * @param  multiBox    Repartir el pedido en varias cajas.
+         * @param  engine      Motor de colocación.
+         * @param  singleLine  Orden JSON en una sola línea.
+         * @param  format      Formato de la orden.
+         * @return La clave.
+         */
+        static string
+        make_key(list<item_t> * items, boxType_t boxType, bool autoBox, bool multiBox,
+                 packingEngine_t engine, bool singleLine, orderFormat_t format = ORDER_FORMAT_JSON)
+        {
+            vector<string> ids;
+            string key;
+
+            ids.reserve(items->size());
+            for (list<item_t>::iterator it = items->begin(); (it != items->end()); ++it)
+            {
+                ids.push_back(it->get_item_id());
+            }
+            sort(ids.begin(), ids.end());
+
+            key = (multiBox) ? ("multi") : ((autoBox) ? ("auto") : (to_string((int)boxType)));
+            key += "|" + to_string((int)engine) +
+                   ((format == ORDER_FORMAT_MSGPACK) ? ("|b|") : ((singleLine) ? ("|1|") : ("|0|")));
+
+            // Cada identificador va precedido de su longitud: así ningún
+            // identificador (aunque tenga comas) se confunde con dos.
+            for (size_t i = 0; i < ids.size(); i++)
+            {
+                key += to_string(ids[i].size()) + ":" + ids[i];
+            }
+
+            return (key);
+
+        }   /* make_key() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca un pedido en la caché. Si está, pasa a ser la entrada
+         *         más reciente.
+         * @param  key     La clave (ver make_key()).
+         * @param  result  Donde se copia el resultado guardado.
+         * @return Verdadero si estaba en la caché.
+         */
+        bool
+        lookup(const string & key, cached_packing_t * result)
+        {
+            lock_guard<mutex> guard(lock);
+
+            unordered_map<string, list<entry_t>::iterator>::iterator found = index.find(key);
+
+            if (found == index.end())
+            {
+                misses++;
+                return (false);
+            }
+
+            entries.splice(entries.begin(), entries, found->second);
+            *result = found->second->second;
+            hits++;
+
+            return (true);
+
+        }   /* lookup() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda (o reemplaza) el resultado de un pedido.
+         * @param  key     La clave (ver make_key()).
+         * @param  result  El resultado.
+         * @return void
+         */
+        void
+        insert(const string & key, const cached_packing_t & result)
+        {
+            lock_guard<mutex> guard(lock);
+
+            unordered_map<string, list<entry_t>::iterator>::iterator found = index.find(key);
+
+            if (found != index.end())
+            {
+                found->second->second = result;
+                entries.splice(entries.begin(), entries, found->second);
+                return;
+            }
+
+            entries.push_front(make_pair(key, result));
+            index[key] = entries.begin();
+            evict();
+
+        }   /* insert() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Carga entradas de un fichero guardado con save(). Si el fichero
+         *         no existe o es de otro formato no se carga nada.
+         * @param  path  Ruta del fichero.
+         * @return Número de entradas cargadas.
+         */
+        size_t
+        load(const char * path)
+        {
+            traceln(CACHE_TAG, "load()");
+
+            ifstream file(path);
+            string line;
+            vector<entry_t> loaded;
+
+            if (!(file.is_open()) || !(getline(file, line)) || (line != PACKING_CACHE_HEADER))
+            {
+                traceln(CACHE_TAG, "load() - END");
+                return (0);
+            }
+
+            // Cada línea: clave \t colocados \t sin colocar \t orden escapada.
+            while (getline(file, line))
+            {
+                size_t a = line.find('\t');
+                size_t b = (a == string::npos) ? (a) : (line.find('\t', a + 1));
+                size_t c = (b == string::npos) ? (b) : (line.find('\t', b + 1));
+
+                if (c == string::npos)
+                {
+                    continue;
+                }
+
+                entry_t e;
+                e.first = unescape(line.substr(0, a));
+                e.second.placedItems = strtoul(line.c_str() + a + 1, NULL, 10);
+                e.second.unplacedItems = strtoul(line.c_str() + b + 1, NULL, 10);
+                e.second.mqtt_order = unescape(line.substr(c + 1));
+                loaded.push_back(e);
+            }
+
+            // El fichero va de la más reciente a la más antigua: se insertan al
+            // revés para conservar el orden LRU.
+            for (size_t i = loaded.size(); i > 0; i--)
+            {
+                insert(loaded[i - 1].first, loaded[i - 1].second);
+            }
+
+            traceln(CACHE_TAG, "load() - END");
+            return (loaded.size());
+
+        }   /* load() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda todas las entradas en un fichero, de la más reciente a
+         *         la más antigua.
+         * @param  path  Ruta del fichero.
+         * @return Verdadero si se ha podido escribir.
+         */
+        bool
+        save(const char * path)
+        {
+            traceln(CACHE_TAG, "save()");
+
+            lock_guard<mutex> guard(lock);
+            ofstream file(path);
+
+            if (!(file.is_open()))
+            {
+                traceln(CACHE_TAG, "save() - END");
+                return (false);
+            }
+
+            file << PACKING_CACHE_HEADER << '\n';
+            for (list<entry_t>::iterator it = entries.begin(); (it != entries.end()); ++it)
+            {
+                file << escape(it->first) << '\t' << it->second.placedItems << '\t'
+                     << it->second.unplacedItems << '\t' << escape(it->second.mqtt_order) << '\n';
+            }
+
+            traceln(CACHE_TAG, "save() - END");
+            return (file.good());
+
+        }   /* save() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de entradas guardadas.
+         * @param  void
+         * @return Número de entradas.
+         */
+        size_t
+        get_size(void)
+        {
+            lock_guard<mutex> guard(lock);
+            return entries.size();
+
+        }   /* get_size() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de búsquedas con acierto.
+         * @param  void
+         * @return Aciertos.
+         */
+        size_t
+        get_hits(void)
+        {
+            lock_guard<mutex> guard(lock);
+            return hits;
+
+        }   /* get_hits() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de búsquedas sin acierto.
+         * @param  void
+         * @return Fallos.
+         */
+        size_t
+        get_misses(void)
+        {
+            lock_guard<mutex> guard(lock);
+            return misses;
+
+        }   /* get_misses() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de entradas expulsadas por falta de sitio.
+         * @param  void
+         * @return Expulsiones.
+         */
+        size_t
+        get_evictions(void)
+        {
+            lock_guard<mutex> guard(lock);
+            return evictions;
+
+        }   /* get_evictions() */
+};
+
+#endif /* PACKING_CACHE_T_H */
+
+/*** end of file ***/
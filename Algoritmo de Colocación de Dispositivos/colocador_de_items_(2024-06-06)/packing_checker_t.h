@@ -0,0 +1,385 @@
+/**
+ * @file     packing_checker_t.h
+ *
+ * @brief    Comprobación independiente de una colocación terminada.
+ *
+ * No usa nada del estado de box_t ni de placement_validator_t: parte solo de
+ * las posiciones finales de los items colocados y comprueba que cada uno está
+ * dentro de la caja, no se solapa con ningún otro y tiene apoyada al menos
+ * SUPPORT_MIN_RATIO de su base.
+ *
+ * Los solapes se buscan con un barrido en x. Los items que cortan el plano de
+ * barrido se cortan en y con el que entra si empiezan dentro de su intervalo
+ * en y (se buscan en un set ordenado por min_y) o si contienen su min_y (se
+ * buscan en un árbol de segmentos sobre las y). Así solo se recorren los
+ * pares que se cruzan a la vez en x y en y: el coste es O(n log n + k), con k
+ * esos pares (en una colocación válida, los items apilados uno sobre otro).
+ * El apoyo se suma agrupando los items por la altura de su cara superior: a
+ * cada item le cuestan los que tienen la cara superior a la altura de su base.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del comprobador
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef PACKING_CHECKER_T_H
+#define PACKING_CHECKER_T_H
+
+#include <algorithm>
+#include <list>
+#include <memory_resource>
+#include <set>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "placement_validator_t.h"
+
+using namespace std;
+
+// static const char * CHECKER_TAG = __FILE__;
+static const char * CHECKER_TAG = "packing_checker_t.h";
+
+typedef enum
+{
+    CHECK_OK,
+    CHECK_OUTSIDE_BOX,   // el item first se sale de la caja
+    CHECK_OVERLAP,       // los items first y second se solapan
+    CHECK_UNSUPPORTED    // el item first no tiene apoyo suficiente
+
+} checkResult_t;
+
+// Resultado de una comprobación: el primer error encontrado y los items
+// afectados (por su posición en la lista de items colocados).
+typedef struct
+{
+    checkResult_t result;
+    size_t first;
+    size_t second;
+
+} check_report_t;
+
+class packing_checker_t
+{
+    private:
+
+        // Un evento del barrido en x: entrada o salida de un item.
+        typedef struct
+        {
+            uint16_t x;
+            bool isStart;
+            uint32_t index;
+
+        } event_t;
+
+        // Árbol de segmentos sobre las hojas [ys[i], ys[i + 1]). Un item
+        // activo está en los O(log n) nodos que cubren su intervalo
+        // [min_y, max_y), así que los que contienen una y están en el camino
+        // de la raíz a su hoja. Al salir un item solo se marca en alive: sus
+        // entradas se quitan al pasar por sus nodos.
+        typedef struct
+        {
+            vector<uint16_t> ys;
+            vector< vector<uint32_t> > nodes;
+            vector<char> alive;
+
+        } y_tree_t;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda el item index en los nodos que cubren las hojas
+         *         [first, last) (node cubre [lo, hi)).
+         */
+        static void
+        tree_insert(y_tree_t * tree, size_t node, size_t lo, size_t hi,
+                    size_t first, size_t last, uint32_t index)
+        {
+            if ((last <= lo) || (hi <= first))
+            {
+                return;
+            }
+
+            if ((first <= lo) && (hi <= last))
+            {
+                tree->nodes[node].push_back(index);
+                return;
+            }
+
+            size_t mid = (lo + hi) / 2;
+
+            tree_insert(tree, 2 * node, lo, mid, first, last, index);
+            tree_insert(tree, 2 * node + 1, mid, hi, first, last, index);
+
+        }   /* tree_insert() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca, entre los items activos que contienen la hoja leaf, uno
+         *         que se corte en z con s.
+         * @return El índice del item, o spaces.size() si no hay ninguno.
+         */
+        static uint32_t
+        tree_stab(y_tree_t * tree, size_t leaf, const vector<space_t> & spaces, space_t s)
+        {
+            size_t node = 1, lo = 0, hi = tree->ys.size() - 1;
+
+            while (true)
+            {
+                vector<uint32_t> & list = tree->nodes[node];
+                size_t kept = 0;
+
+                for (size_t k = 0; k < list.size(); k++)
+                {
+                    if (!(tree->alive[list[k]]))
+                    {
+                        continue;
+                    }
+
+                    list[kept++] = list[k];
+
+                    space_t o = spaces[list[k]];
+                    if ((s.min_z() < o.max_z()) && (o.min_z() < s.max_z()))
+                    {
+                        return (list[k]);
+                    }
+                }
+                list.resize(kept);
+
+                if ((hi - lo) == 1)
+                {
+                    return (spaces.size());
+                }
+
+                size_t mid = (lo + hi) / 2;
+
+                node = (leaf < mid) ? (2 * node) : (2 * node + 1);
+                lo = (leaf < mid) ? (lo) : (mid);
+                hi = (leaf < mid) ? (mid) : (hi);
+            }
+
+        }   /* tree_stab() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Área de la intersección en xy de dos espacios (0 si no se cortan).
+         */
+        static uint32_t
+        overlap_xy(space_t a, space_t b)
+        {
+            int dx = (int)std::min(a.max_x(), b.max_x()) - (int)std::max(a.min_x(), b.min_x());
+            int dy = (int)std::min(a.max_y(), b.max_y()) - (int)std::max(a.min_y(), b.min_y());
+
+            return (((dx > 0) && (dy > 0)) ? ((uint32_t)(dx * dy)) : (0));
+
+        }   /* overlap_xy() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Busca un par de espacios que se solapen con un barrido en x.
+         * @return Verdadero si hay solape (y lo deja en report).
+         */
+        static bool
+        find_overlap(vector<space_t> & spaces, check_report_t * report)
+        {
+            vector<event_t> events;
+            set<pair<uint16_t, uint32_t>> active; // (min_y, índice) de los que cortan el plano
+            y_tree_t tree;
+
+            events.reserve(2 * spaces.size());
+            for (uint32_t i = 0; i < spaces.size(); i++)
+            {
+                if ((spaces[i].min_x() < spaces[i].max_x()) && (spaces[i].min_y() < spaces[i].max_y()))
+                {
+                    events.push_back({spaces[i].min_x(), true, i});
+                    events.push_back({spaces[i].max_x(), false, i});
+                    tree.ys.push_back(spaces[i].min_y());
+                    tree.ys.push_back(spaces[i].max_y());
+                }
+            }
+
+            if (events.empty())
+            {
+                return (false);
+            }
+
+            sort(tree.ys.begin(), tree.ys.end());
+            tree.ys.erase(unique(tree.ys.begin(), tree.ys.end()), tree.ys.end());
+            tree.nodes.resize(4 * tree.ys.size());
+            tree.alive.assign(spaces.size(), false);
+
+            // A la misma x, las salidas van antes que las entradas: dos items
+            // que solo se tocan no se solapan.
+            sort(events.begin(), events.end(), [](const event_t & a, const event_t & b)
+            {
+                return ((a.x != b.x) ? (a.x < b.x) : (!(a.isStart) && b.isStart));
+            });
+
+            for (size_t e = 0; e < events.size(); e++)
+            {
+                space_t s = spaces[events[e].index];
+
+                if (!(events[e].isStart))
+                {
+                    active.erase(make_pair(s.min_y(), events[e].index));
+                    tree.alive[events[e].index] = false;
+                    continue;
+                }
+
+                size_t first = lower_bound(tree.ys.begin(), tree.ys.end(), s.min_y()) - tree.ys.begin();
+                size_t last = lower_bound(tree.ys.begin(), tree.ys.end(), s.max_y()) - tree.ys.begin();
+                uint32_t other = tree_stab(&tree, first, spaces, s);
+
+                // Los activos que empiezan dentro de (s.min_y(), s.max_y()); los
+                // que empiezan en s.min_y() o antes ya los ha mirado tree_stab().
+                for (set<pair<uint16_t, uint32_t>>::iterator it = active.lower_bound(make_pair((uint16_t)(s.min_y() + 1), (uint32_t)0));
+                    ((other == spaces.size()) && (it != active.end()) && (it->first < s.max_y())); ++it)
+                {
+                    space_t o = spaces[it->second];
+
+                    if ((s.min_z() < o.max_z()) && (o.min_z() < s.max_z()))
+                    {
+                        other = it->second;
+                    }
+                }
+
+                if (other != spaces.size())
+                {
+                    report->result = CHECK_OVERLAP;
+                    report->first = std::min(other, events[e].index);
+                    report->second = std::max(other, events[e].index);
+                    return (true);
+                }
+
+                active.insert(make_pair(s.min_y(), events[e].index));
+                tree.alive[events[e].index] = true;
+                tree_insert(&tree, 1, 0, tree.ys.size() - 1, first, last, events[e].index);
+            }
+
+            return (false);
+
+        }   /* find_overlap() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Comprueba las posiciones de los items colocados.
+         * @param  boxSize  El tamaño interior de la caja.
+         * @param  placed   Los items colocados (con su posición final).
+         * @param  report   Donde se deja el primer error (puede ser NULL).
+         * @return Verdadero si la colocación es válida.
+         */
+        static bool
+        check(space_t boxSize, const pmr::list<item_t> & placed, check_report_t * report = NULL)
+        {
+            traceln(CHECKER_TAG, "check()");
+
+            check_report_t local;
+            vector<space_t> spaces;
+
+            if (report == NULL)
+            {
+                report = &local;
+            }
+            report->result = CHECK_OK;
+            report->first = 0;
+            report->second = 0;
+
+            spaces.reserve(placed.size());
+            for (pmr::list<item_t>::const_iterator it = placed.begin(); (it != placed.end()); ++it)
+            {
+                spaces.push_back(it->get_posInBox());
+            }
+
+            // 1) Dentro de la caja.
+            for (size_t i = 0; i < spaces.size(); i++)
+            {
+                if ((spaces[i].max_x() > boxSize.max_x()) || (spaces[i].max_y() > boxSize.max_y()) ||
+                    (spaces[i].max_z() > boxSize.max_z()))
+                {
+                    report->result = CHECK_OUTSIDE_BOX;
+                    report->first = i;
+                    traceln(CHECKER_TAG, "check() - END");
+                    return (false);
+                }
+            }
+
+            // 2) Sin solapes.
+            if (find_overlap(spaces, report))
+            {
+                traceln(CHECKER_TAG, "check() - END");
+                return (false);
+            }
+
+            // 3) Con apoyo. Sin solapes, las caras superiores a la misma altura
+            //    tampoco se solapan: basta con sumar las intersecciones.
+            vector<pair<uint16_t, uint32_t>> tops; // (max_z, índice)
+
+            tops.reserve(spaces.size());
+            for (uint32_t i = 0; i < spaces.size(); i++)
+            {
+                tops.push_back(make_pair(spaces[i].max_z(), i));
+            }
+            sort(tops.begin(), tops.end());
+
+            for (size_t i = 0; i < spaces.size(); i++)
+            {
+                space_t s = spaces[i];
+                uint32_t base = (uint32_t)(s.max_x() - s.min_x()) * (s.max_y() - s.min_y());
+                uint32_t supported = 0;
+
+                if ((s.min_z() == 0) || (base == 0))
+                {
+                    continue;
+                }
+
+                vector<pair<uint16_t, uint32_t>>::const_iterator it =
+                    lower_bound(tops.begin(), tops.end(), make_pair(s.min_z(), (uint32_t)0));
+
+                for (; ((it != tops.end()) && (it->first == s.min_z())); ++it)
+                {
+                    supported += overlap_xy(s, spaces[it->second]);
+                }
+
+                if (((double)supported / base) < SUPPORT_MIN_RATIO)
+                {
+                    report->result = CHECK_UNSUPPORTED;
+                    report->first = i;
+                    traceln(CHECKER_TAG, "check() - END");
+                    return (false);
+                }
+            }
+
+            traceln(CHECKER_TAG, "check() - END");
+            return (true);
+
+        }   /* check() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de un resultado.
+         * @param  result  El resultado.
+         * @return El nombre.
+         */
+        static const char *
+        result_name(checkResult_t result)
+        {
+            switch (result)
+            {
+                case CHECK_OK:          return ("ok");
+                case CHECK_OUTSIDE_BOX: return ("fuera de la caja");
+                case CHECK_OVERLAP:     return ("solape");
+                default:                return ("sin apoyo");
+            }
+
+        }   /* result_name() */
+};
+
+#endif /* PACKING_CHECKER_T_H */
+
+/*** end of file ***/
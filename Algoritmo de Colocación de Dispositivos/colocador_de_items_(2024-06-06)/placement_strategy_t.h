@@ -0,0 +1,225 @@
+/**
+ * @file     placement_strategy_t.h
+ *
+ * @brief    Interfaz común de las estrategias de colocación de box_t.
+ *
+ * Una estrategia recibe un placement_job_t con los items a colocar (ya
+ * ordenados según el itemOrder_t de la caja), el validador común y las
+ * opciones de la caja. Solo decide dónde proponer cada item: toda posición
+ * pasa por placement_validator_t y se registra con commit(), de modo que
+ * todas las estrategias comparten validación y salida (calculate_TCP_pose()
+ * y generate_mqtt_order() de box_t) y se pueden comparar entre sí.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la interfaz de estrategias
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef PLACEMENT_STRATEGY_T_H
+#define PLACEMENT_STRATEGY_T_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "placement_validator_t.h"
+#include "undo_log_t.h"
+#include "failed_skus_t.h"
+
+using namespace std;
+
+// static const char * STRATEGY_TAG = __FILE__;
+static const char * STRATEGY_TAG = "placement_strategy_t.h";
+
+typedef struct
+{
+    space_t boxSize;                    // tamaño interior de la caja
+    pmr::list<item_t> * itemsToPlace;   // los items que no se coloquen se quedan aquí
+    pmr::list<item_t> * placedItems;    // los items colocados, en orden de colocación
+    placement_validator_t * validator;
+    undo_log_t * undoLog;               // registro de deshacer de box_t (o NULL)
+    bool allowRotation;                 // probar los items girados 90º sobre z
+    function<bool(void)> isCancelled;   // cancelación cooperativa de box_t
+
+} placement_job_t;
+
+class placement_strategy_t
+{
+    protected:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Registra la colocación de un item: lo pasa de itemsToPlace a
+         *         placedItems (sin copiarlo) y lo añade al validador.
+         * @param  job       El trabajo de colocación.
+         * @param  it        El item de itemsToPlace que se coloca.
+         * @param  position  La posición del item (ya validada).
+         * @param  rotated   Verdadero si se coloca girado 90º sobre z.
+         * @return El iterador al siguiente item de itemsToPlace.
+         */
+        static pmr::list<item_t>::iterator
+        commit(placement_job_t * job, pmr::list<item_t>::iterator it, space_t position, bool rotated)
+        {
+            it->set_posInBox(position);
+            it->set_rotated(rotated);
+            if (job->undoLog == NULL)
+            {
+                pmr::list<item_t>::iterator next = std::next(it);
+
+                job->validator->add(position);
+                job->placedItems->splice(job->placedItems->end(), *(job->itemsToPlace), it);
+
+                return (next);
+            }
+
+            job->undoLog->validator_add(job->validator, position);
+
+            return (job->undoLog->place_item(job->itemsToPlace, job->placedItems, it));
+
+        }   /* commit() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el tamaño de un item en la orientación indicada.
+         * @param  it       El item.
+         * @param  rotated  Verdadero para el tamaño girado 90º sobre z.
+         * @return El tamaño con origen en (0, 0, 0).
+         */
+        static space_t
+        oriented_size(pmr::list<item_t>::iterator it, bool rotated)
+        {
+            return ((rotated) ? (it->get_rotated_size()) : (it->get_size()));
+
+        }   /* oriented_size() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Número de orientaciones que hay que probar para un item.
+         * @param  job  El trabajo de colocación.
+         * @param  it   El item.
+         * @return 1 (solo la original) o 2 (original y girada).
+         */
+        static int
+        num_orientations(placement_job_t * job, pmr::list<item_t>::iterator it)
+        {
+            return ((job->allowRotation && it->can_rotate()) ? (2) : (1));
+
+        }   /* num_orientations() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El destructor de la clase placement_strategy_t.
+         * @param  void
+         */
+        virtual ~placement_strategy_t(void)
+        {
+
+        }   /* ~placement_strategy_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nombre de la estrategia (para comparativas).
+         * @param  void
+         * @return El nombre.
+         */
+        virtual const char *
+        get_name(void) = 0;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca todos los items que pueda de job->itemsToPlace.
+         * @param  job  El trabajo de colocación.
+         * @return void
+         */
+        virtual void
+        place(placement_job_t * job) = 0;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula la clave de ordenación (de mayor a menor) de un item.
+         * @param  item   El item.
+         * @param  order  La regla de ordenación (distinta de ORDER_INPUT).
+         * @return La clave.
+         */
+        static uint64_t
+        sort_key(item_t * item, itemOrder_t order)
+        {
+            space_t s = item->get_size();
+            uint64_t footprint = (uint64_t)s.max_x() * s.max_y();
+
+            if (order == ORDER_VOLUME_DESC)
+            {
+                return (footprint * s.max_z());
+            }
+            else if (order == ORDER_FOOTPRINT_DESC)
+            {
+                return ((footprint << 16) | s.max_z());
+            }
+            else // (order == ORDER_HEIGHT_DESC)
+            {
+                return (((uint64_t)s.max_z() << 32) | footprint);
+            }
+
+        }   /* sort_key() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Ordena los items según la regla indicada. La ordenación es
+         *         estable: a igualdad de clave se respeta el orden del pedido.
+         * @param  items  Los items a ordenar.
+         * @param  order  La regla de ordenación.
+         * @return void
+         */
+        static void
+        sort_items(pmr::list<item_t> * items, itemOrder_t order)
+        {
+            traceln(STRATEGY_TAG, "sort_items()");
+
+            if (order == ORDER_INPUT)
+            {
+                traceln(STRATEGY_TAG, "sort_items() - END");
+                return;
+            }
+
+            pmr::vector< pair<uint64_t, pmr::list<item_t>::iterator> > keys(
+                items->get_allocator().resource());
+
+            for (pmr::list<item_t>::iterator it = items->begin(); (it != items->end()); ++it)
+            {
+                keys.push_back(make_pair(sort_key(&(*it), order), it));
+            }
+
+            stable_sort(keys.begin(), keys.end(),
+                        [](const pair<uint64_t, pmr::list<item_t>::iterator> & a,
+                           const pair<uint64_t, pmr::list<item_t>::iterator> & b)
+                        {
+                            return (a.first > b.first);
+                        });
+
+            // splice() mueve los nodos sin copiar los items.
+            pmr::list<item_t> sorted(items->get_allocator());
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                sorted.splice(sorted.end(), *items, keys[i].second);
+            }
+            items->swap(sorted);
+
+            traceln(STRATEGY_TAG, "sort_items() - END");
+
+        }   /* sort_items() */
+};
+
+#endif /* PLACEMENT_STRATEGY_T_H */
+
+/*** end of file ***/
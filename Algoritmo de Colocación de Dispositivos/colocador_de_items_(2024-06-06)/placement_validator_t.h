@@ -0,0 +1,308 @@
+/**
+ * @file     placement_validator_t.h
+ *
+ * @brief    Validación común de las posiciones propuestas por cualquier motor
+ *           o estrategia de colocación.
+ *
+ * Una posición es válida si está dentro de la caja, no se solapa con ningún
+ * item ya colocado y su base está apoyada (en el suelo o sobre la cara
+ * superior de otros items) al menos en SUPPORT_MIN_RATIO de su superficie.
+ * Los items colocados se guardan también en una rejilla de vóxeles: si la
+ * región está libre en la rejilla no hace falta recorrer la lista.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del validador común
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef PLACEMENT_VALIDATOR_T_H
+#define PLACEMENT_VALIDATOR_T_H
+
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "voxel_grid_t.h"
+
+using namespace std;
+
+// static const char * VALIDATOR_TAG = __FILE__;
+static const char * VALIDATOR_TAG = "placement_validator_t.h";
+
+// Fracción mínima de la base de un item que tiene que estar apoyada.
+#define SUPPORT_MIN_RATIO 0.75
+
+class placement_validator_t
+{
+    private:
+
+        // ATRIBUTOS.
+        space_t boxSize;
+        pmr::vector<space_t> placed;
+        voxel_grid_t grid; // unión de los items colocados
+        uint64_t placedVolume;
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase placement_validator_t.
+         * @param  resource  De donde sale la lista de posiciones.
+         */
+        placement_validator_t(pmr::memory_resource * resource = pmr::get_default_resource()) :
+            placed(resource)
+        {
+            traceln(VALIDATOR_TAG, "placement_validator_t()");
+            reset(space_t(0, 0, 0, 480, 300, 240));
+            traceln(VALIDATOR_TAG, "placement_validator_t() - END");
+
+        }   /* placement_validator_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vacía el validador y lo ajusta a las dimensiones de la caja.
+         * @param  boxSize  El tamaño interior de la caja.
+         * @return void
+         */
+        void
+        reset(space_t boxSize)
+        {
+            this->boxSize = boxSize;
+            this->placed.clear();
+            this->grid.reset(boxSize);
+            this->placedVolume = 0;
+
+        }   /* reset() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si la posición está dentro de la caja.
+         * @param  candidate  La posición a comprobar.
+         * @return Verdadero o falso.
+         */
+        bool
+        is_inside_box(space_t candidate)
+        {
+            return ((candidate.max_x() <= boxSize.max_x()) &&
+                    (candidate.max_y() <= boxSize.max_y()) &&
+                    (candidate.max_z() <= boxSize.max_z()));
+
+        }   /* is_inside_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si la posición no se solapa con ningún item colocado.
+         * @param  candidate  La posición a comprobar.
+         * @return Verdadero o falso.
+         */
+        bool
+        is_free(space_t candidate)
+        {
+            // La rejilla redondea hacia fuera: si está libre, seguro que no hay solape.
+            if (grid.is_region_free(candidate))
+            {
+                return (true);
+            }
+
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                if ((candidate.min_x() < placed[i].max_x()) && (placed[i].min_x() < candidate.max_x()) &&
+                    (candidate.min_y() < placed[i].max_y()) && (placed[i].min_y() < candidate.max_y()) &&
+                    (candidate.min_z() < placed[i].max_z()) && (placed[i].min_z() < candidate.max_z()))
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+
+        }   /* is_free() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula qué fracción de la base de la posición está apoyada en
+         *         el suelo o en la cara superior de los items colocados.
+         * @param  candidate  La posición a comprobar.
+         * @return Un valor entre 0 y 1.
+         */
+        double
+        support_ratio(space_t candidate)
+        {
+            uint32_t base = (uint32_t)(candidate.max_x() - candidate.min_x()) *
+                            (candidate.max_y() - candidate.min_y());
+            uint32_t supported = 0;
+
+            if ((candidate.min_z() == 0) || (base == 0))
+            {
+                return (1.0);
+            }
+
+            // Los items colocados no se solapan, así que las caras superiores a
+            // la misma altura tampoco: basta con sumar las intersecciones.
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                if (placed[i].max_z() == candidate.min_z())
+                {
+                    int dx = (int)std::min(candidate.max_x(), placed[i].max_x()) -
+                             (int)std::max(candidate.min_x(), placed[i].min_x());
+                    int dy = (int)std::min(candidate.max_y(), placed[i].max_y()) -
+                             (int)std::max(candidate.min_y(), placed[i].min_y());
+
+                    if ((dx > 0) && (dy > 0))
+                    {
+                        supported += dx * dy;
+                    }
+                }
+            }
+
+            return ((double)supported / base);
+
+        }   /* support_ratio() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Comprueba todas las condiciones: dentro de la caja, sin solape
+         *         y con apoyo suficiente.
+         * @param  candidate  La posición a comprobar.
+         * @return Verdadero si la posición es válida.
+         */
+        bool
+        is_valid(space_t candidate)
+        {
+            return (is_inside_box(candidate) && is_free(candidate) &&
+                    (support_ratio(candidate) >= SUPPORT_MIN_RATIO));
+
+        }   /* is_valid() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Registra un item colocado.
+         * @param  position  La posición del item dentro de la caja.
+         * @return void
+         */
+        void
+        add(space_t position)
+        {
+            placed.push_back(position);
+            grid.set_region(position);
+            placedVolume += (uint64_t)(position.max_x() - position.min_x()) *
+                            (position.max_y() - position.min_y()) *
+                            (position.max_z() - position.min_z());
+
+        }   /* add() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Quita el último item registrado. La rejilla no se toca: sigue
+         *         siendo válida (solo marca de más) hasta que se llame a
+         *         rebuild_grid() o se restaure lo que marcó add() (así lo hace
+         *         undo_log_t).
+         * @param  void
+         * @return void
+         */
+        void
+        remove_last(void)
+        {
+            space_t position = placed.back();
+
+            placed.pop_back();
+            placedVolume -= (uint64_t)(position.max_x() - position.min_x()) *
+                            (position.max_y() - position.min_y()) *
+                            (position.max_z() - position.min_z());
+
+        }   /* remove_last() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve a construir la rejilla a partir de los items registrados.
+         * @param  void
+         * @return void
+         */
+        void
+        rebuild_grid(void)
+        {
+            grid.reset(boxSize);
+
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                grid.set_region(placed[i]);
+            }
+
+        }   /* rebuild_grid() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la rejilla de los items colocados.
+         * @param  void
+         * @return La rejilla.
+         */
+        voxel_grid_t *
+        get_grid(void)
+        {
+            return &grid;
+
+        }   /* get_grid() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos validadores tienen los mismos items, en el mismo
+         *         orden, y la misma rejilla.
+         * @param  other  El otro validador.
+         * @return Verdadero o falso.
+         */
+        bool
+        equals(placement_validator_t & other)
+        {
+            if ((boxSize != other.boxSize) || (placed.size() != other.placed.size()) ||
+                (placedVolume != other.placedVolume) || !(grid.equals(other.grid)))
+            {
+                return (false);
+            }
+
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                if (placed[i] != other.placed[i])
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+
+        }   /* equals() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve las posiciones de los items colocados.
+         * @param  void
+         * @return Las posiciones, en orden de colocación.
+         */
+        const pmr::vector<space_t> &
+        get_placed(void)
+        {
+            return placed;
+
+        }   /* get_placed() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el volumen ocupado por los items colocados.
+         * @param  void
+         * @return Volumen en mm³.
+         */
+        uint64_t
+        get_placed_volume(void)
+        {
+            return placedVolume;
+
+        }   /* get_placed_volume() */
+};
+
+#endif /* PLACEMENT_VALIDATOR_T_H */
+
+/*** end of file ***/
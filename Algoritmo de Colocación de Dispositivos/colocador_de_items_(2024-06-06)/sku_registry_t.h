@@ -0,0 +1,219 @@
+/**
+ * @file     sku_registry_t.h
+ *
+ * @brief    Registro global de los identificadores de item (SKU).
+ *
+ * Cada identificador distinto se guarda una sola vez y recibe un índice de
+ * 16 bits; item_t guarda solo ese índice, así que copiar un item no copia
+ * ninguna cadena. El registro también guarda lo que se deduce del
+ * identificador (el tipo de item), que se calcula una única vez por SKU.
+ *
+ * Las entradas se guardan en bloques que no se mueven nunca: leer el
+ * identificador de un índice ya registrado no toma ningún mutex, buscar el
+ * índice de un identificador ya registrado lo toma compartido (los hilos no se
+ * bloquean entre sí) y solo registrar un SKU nuevo lo toma en exclusiva.
+ *
+ * Caben SKU_REGISTRY_CAPACITY identificadores distintos. Con el registro
+ * lleno, intern() devuelve SKU_REGISTRY_FULL en lugar de un índice: el item no
+ * tiene identificador y quien lo ha creado tiene que rechazarlo (ver
+ * item_t::is_registered()).
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del registro de SKU
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef SKU_REGISTRY_T_H
+#define SKU_REGISTRY_T_H
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "defines.h"
+#include "logger.h"
+
+using namespace std;
+
+// static const char * SKU_REGISTRY_TAG = __FILE__;
+static const char * SKU_REGISTRY_TAG = "sku_registry_t.h";
+
+// Entradas por bloque y número máximo de bloques. El último índice de 16
+// bits no se usa: es el que devuelve intern() con el registro lleno.
+#define SKU_REGISTRY_BLOCK    256
+#define SKU_REGISTRY_BLOCKS   256
+#define SKU_REGISTRY_CAPACITY ((size_t)SKU_REGISTRY_BLOCK * SKU_REGISTRY_BLOCKS - 1)
+#define SKU_REGISTRY_FULL     0xFFFF
+
+// Información del identificador vacío (la entrada 0).
+#define SKU_INFO_UNKNOWN 0xFF
+
+class sku_registry_t
+{
+    private:
+
+        typedef struct
+        {
+            string id;
+            uint8_t info; // lo que devuelve la función de clasificación
+
+        } entry_t;
+
+        // ATRIBUTOS.
+        shared_mutex lock; // protege index y count
+        unordered_map<string, uint16_t> index;
+        atomic<entry_t *> blocks[SKU_REGISTRY_BLOCKS];
+        size_t count;
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase sku_registry_t. La entrada 0 es el
+         *         identificador vacío.
+         */
+        sku_registry_t(void)
+        {
+            for (size_t b = 0; b < SKU_REGISTRY_BLOCKS; b++)
+            {
+                blocks[b].store(NULL, memory_order_relaxed);
+            }
+
+            blocks[0].store(new entry_t[SKU_REGISTRY_BLOCK], memory_order_release);
+            blocks[0].load(memory_order_relaxed)[0].info = SKU_INFO_UNKNOWN;
+            index[string()] = 0;
+            count = 1;
+
+        }   /* sku_registry_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  El destructor de la clase sku_registry_t.
+         */
+        ~sku_registry_t(void)
+        {
+            for (size_t b = 0; b < SKU_REGISTRY_BLOCKS; b++)
+            {
+                delete [] blocks[b].load(memory_order_relaxed);
+            }
+
+        }   /* ~sku_registry_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la entrada de un índice ya registrado.
+         */
+        entry_t &
+        entry(uint16_t sku)
+        {
+            return (blocks[sku / SKU_REGISTRY_BLOCK].load(memory_order_acquire)[sku % SKU_REGISTRY_BLOCK]);
+
+        }   /* entry() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el registro global (se crea la primera vez).
+         * @param  void
+         * @return El registro.
+         */
+        static sku_registry_t &
+        instance(void)
+        {
+            static sku_registry_t registry;
+            return registry;
+
+        }   /* instance() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el índice de un identificador, registrándolo si es
+         *         nuevo. Para un identificador nuevo se llama una vez a
+         *         classify, con el mutex tomado en exclusiva.
+         * @param  id        El identificador.
+         * @param  classify  Calcula la información del identificador.
+         * @return El índice, o SKU_REGISTRY_FULL si el identificador es nuevo
+         *         y el registro está lleno.
+         */
+        uint16_t
+        intern(const string & id, uint8_t (* classify)(const string &))
+        {
+            // 1) Identificador ya registrado: basta con el mutex compartido.
+            {
+                shared_lock<shared_mutex> reader(lock);
+
+                unordered_map<string, uint16_t>::const_iterator found = index.find(id);
+
+                if (found != index.end())
+                {
+                    return (found->second);
+                }
+            }
+
+            // 2) Identificador nuevo: otro hilo puede haberlo registrado entre
+            //    los dos bloqueos, así que se vuelve a buscar.
+            lock_guard<shared_mutex> guard(lock);
+
+            unordered_map<string, uint16_t>::iterator found = index.find(id);
+
+            if (found != index.end())
+            {
+                return (found->second);
+            }
+
+            if (count >= SKU_REGISTRY_CAPACITY)
+            {
+                errorln(SKU_REGISTRY_TAG, "intern() - registro lleno");
+                return (SKU_REGISTRY_FULL);
+            }
+
+            size_t b = count / SKU_REGISTRY_BLOCK;
+            if (blocks[b].load(memory_order_relaxed) == NULL)
+            {
+                blocks[b].store(new entry_t[SKU_REGISTRY_BLOCK], memory_order_release);
+            }
+
+            entry_t & e = blocks[b].load(memory_order_relaxed)[count % SKU_REGISTRY_BLOCK];
+            e.id = id;
+            e.info = classify(id);
+
+            index[id] = (uint16_t)count;
+            return ((uint16_t)(count++));
+
+        }   /* intern() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el identificador de un índice.
+         * @param  sku  El índice (devuelto por intern(), distinto de
+         *              SKU_REGISTRY_FULL).
+         * @return El identificador.
+         */
+        const string &
+        get_id(uint16_t sku)
+        {
+            return (entry(sku).id);
+
+        }   /* get_id() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la información de un índice.
+         * @param  sku  El índice (devuelto por intern(), distinto de
+         *              SKU_REGISTRY_FULL).
+         * @return La información calculada al registrarlo.
+         */
+        uint8_t
+        get_info(uint16_t sku)
+        {
+            return (entry(sku).info);
+
+        }   /* get_info() */
+};
+
+#endif /* SKU_REGISTRY_T_H */
+
+/*** end of file ***/
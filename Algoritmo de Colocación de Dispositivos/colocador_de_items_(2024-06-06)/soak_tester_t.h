@@ -0,0 +1,479 @@
+/**
+ * @file     soak_tester_t.h
+ *
+ * @brief    Prueba de carga: compara un motor de colocación con la referencia
+ *           en muchos pedidos sintéticos.
+ *
+ * Cada pedido de un order_generator_t se coloca dos veces: con la referencia
+ * (box_t con ENGINE_SPACE_LIST, en el orden de entrada y sin índice espacial
+ * ni rejilla, es decir, el recorrido de spaceInUse original) y con el motor y
+ * la ordenación a probar, con las optimizaciones activas. Las dos colocaciones
+ * se comprueban con packing_checker_t y se cuenta que no se pierda ningún
+ * item. Si el candidato es el mismo algoritmo que la referencia, además tiene
+ * que dar exactamente las mismas posiciones; si no, se comparan los items
+ * colocados y el llenado. Además, las posiciones de la referencia se repiten
+ * con place_item_at() y se deshacen con rollback(), comparando la caja con
+ * otra que no ha llegado a colocarlas. Los pedidos se reparten entre los hilos de un
+ * work_stealing_pool_t y los que fallan se guardan en el formato de entrada
+ * de order_stream_t, para repetirlos con --input.
+ *
+ * Antes de los pedidos sintéticos se colocan con exact_packer_t los pedidos
+ * de SOAK_EXACT_ORDERS: si la búsqueda dice que su colocación es óptima,
+ * ningún motor heurístico puede dar una mejor.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la prueba de carga
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef SOAK_TESTER_T_H
+#define SOAK_TESTER_T_H
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "item_t.h"
+#include "box_t.h"
+#include "exact_packer_t.h"
+#include "order_generator_t.h"
+#include "packing_checker_t.h"
+#include "work_stealing_pool_t.h"
+
+using namespace std;
+
+// static const char * SOAK_TAG = __FILE__;
+static const char * SOAK_TAG = "soak_tester_t.h";
+
+// Pedidos que procesa cada tarea del grupo de hilos y máximo de pedidos
+// fallidos que se guardan.
+#define SOAK_CHUNK_SIZE   64
+#define SOAK_MAX_FAILURES 20
+
+// Nodos que puede recorrer exact_packer_t en cada pedido de SOAK_EXACT_ORDERS.
+#define SOAK_EXACT_MAX_NODES 1000000
+
+// Pedidos en los que exact_packer_t ha dicho alguna vez que su colocación era
+// óptima cuando un motor heurístico daba una mejor (lista terminada en NULL).
+typedef struct
+{
+    boxType_t boxType;
+    const char * items[EXACT_MAX_ITEMS + 1];
+
+} soak_exact_order_t;
+
+#define SOAK_NUM_EXACT_ORDERS 1
+static const soak_exact_order_t SOAK_EXACT_ORDERS[SOAK_NUM_EXACT_ORDERS] =
+{
+    // El ereader tiene que ir sobre las dos fundas para quedarse en 60 de alto.
+    {BOX_S, {"telefono_B_funda", "telefono_B_funda", "reloj_B_01", "reloj_B_01",
+             "tablet_A_01", "ereader_A_01", "tablet_A_funda", NULL}}
+};
+
+typedef struct
+{
+    size_t orders;
+    size_t items;
+    size_t invalidReference;   // la referencia no pasa packing_checker_t
+    size_t invalidCandidate;   // el candidato no pasa packing_checker_t
+    size_t lostItems;          // colocados + sin colocar != items del pedido
+    size_t mismatches;         // posiciones distintas (solo mismo algoritmo)
+    size_t rollbackMismatches; // rollback() no deja la caja como estaba
+    size_t exactMismatches;    // exact_packer_t da por óptima una colocación peor
+    size_t candidateFewer;     // el candidato coloca menos items
+    size_t candidateMore;      // el candidato coloca más items
+    double referenceFill;      // suma del llenado de la referencia
+    double candidateFill;      // suma del llenado del candidato
+    double seconds;
+    vector<string> failures;   // pedidos fallidos (una línea JSON cada uno)
+
+} soak_stats_t;
+
+class soak_tester_t
+{
+    private:
+
+        // ATRIBUTOS.
+        work_stealing_pool_t pool;
+        packingEngine_t engine;
+        itemOrder_t itemOrder;
+        epScore_t epScore;
+        mutex lock; // protege la suma de las estadísticas
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un pedido en el formato JSON Lines de order_stream_t,
+         *         con el motivo del fallo.
+         */
+        static string
+        describe(uint64_t index, boxType_t boxType, const list<item_t> & items, const string & reason)
+        {
+            string line = "{\"pedido\": " + to_string(index) + ", \"fallo\": \"" + reason +
+                          "\", \"tipo_caja\": \"" + ((boxType == BOX_S) ? ("S") : ((boxType == BOX_M) ? ("M") : ("L"))) +
+                          "\", \"dispositivos\": [";
+
+            for (list<item_t>::const_iterator it = items.begin(); (it != items.end()); ++it)
+            {
+                line += ((it == items.begin()) ? ("\"") : (", \"")) + it->get_item_id() + "\"";
+            }
+
+            return (line + "]}");
+
+        }   /* describe() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos cajas han colocado los mismos items en las
+         *         mismas posiciones y en el mismo orden.
+         */
+        static bool
+        same_placement(box_t & a, box_t & b)
+        {
+            const pmr::list<item_t> & pa = a.get_placed_items();
+            const pmr::list<item_t> & pb = b.get_placed_items();
+
+            if ((pa.size() != pb.size()) || (a.get_num_items_to_place() != b.get_num_items_to_place()))
+            {
+                return (false);
+            }
+
+            for (pmr::list<item_t>::const_iterator ia = pa.begin(), ib = pb.begin();
+                (ia != pa.end()); ++ia, ++ib)
+            {
+                if ((ia->get_sku() != ib->get_sku()) || (ia->get_posInBox() != ib->get_posInBox()))
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+
+        }   /* same_placement() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca con place_item_at() el primer item por colocar del
+         *         mismo SKU que placed, en la posición y con el giro de placed.
+         */
+        static bool
+        place_like(box_t * box, const item_t & placed)
+        {
+            space_t position = placed.get_posInBox();
+            point_t origin = {position.min_x(), position.min_y(), position.min_z()};
+            size_t index = 0;
+
+            for (pmr::list<item_t>::const_iterator it = box->get_items_to_place().begin();
+                (it != box->get_items_to_place().end()); ++it, index++)
+            {
+                if (it->get_sku() == placed.get_sku())
+                {
+                    return (box->place_item_at(index, origin, placed.is_rotated()));
+                }
+            }
+
+            return (false);
+
+        }   /* place_like() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Comprueba rollback() con las posiciones de la referencia: una
+         *         caja coloca todas, deshace la segunda mitad y se compara con
+         *         otra que solo ha colocado la primera; las dos colocan la
+         *         segunda mitad y se vuelven a comparar; al final la primera lo
+         *         deshace todo y se compara con una caja vacía.
+         */
+        static bool
+        check_rollback(boxType_t boxType, list<item_t> * items, box_t & reference)
+        {
+            const pmr::list<item_t> & placed = reference.get_placed_items();
+            size_t half = placed.size() / 2;
+            size_t n = 0;
+            bool answer = true;
+
+            box_t trial(boxType, items);
+            box_t expected(boxType, items);
+            size_t start = trial.checkpoint();
+            size_t middle = start;
+
+            for (pmr::list<item_t>::const_iterator it = placed.begin();
+                (it != placed.end()) && (answer == true); ++it, n++)
+            {
+                if (n == half)
+                {
+                    middle = trial.checkpoint();
+                }
+
+                answer = place_like(&trial, *it) && ((n >= half) || place_like(&expected, *it));
+            }
+
+            trial.rollback(middle);
+            answer = answer && trial.same_state(expected);
+
+            n = 0;
+            for (pmr::list<item_t>::const_iterator it = placed.begin();
+                (it != placed.end()) && (answer == true); ++it, n++)
+            {
+                if (n >= half)
+                {
+                    answer = place_like(&trial, *it) && place_like(&expected, *it);
+                }
+            }
+            answer = answer && trial.same_state(expected);
+
+            box_t empty(boxType, items);
+            trial.rollback(start);
+
+            return (answer && trial.same_state(empty));
+
+        }   /* check_rollback() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca un pedido con exact_packer_t y, si la colocación es
+         *         óptima, la compara con la de cada motor heurístico.
+         * @return El motivo del fallo, o una cadena vacía si no falla.
+         */
+        static string
+        check_exact(boxType_t boxType, list<item_t> * items)
+        {
+            exact_options_t options = {boxType, false, ENGINE_SPACE_LIST, 0, SOAK_EXACT_MAX_NODES};
+            exact_packer_t packer(options);
+            exact_report_t report;
+            check_report_t check;
+            box_t * exact = NULL;
+            string reason;
+
+            packer.solve(items, &exact, &report);
+
+            if (!(packing_checker_t::check(box_t::size_of(boxType), exact->get_placed_items(), &check)))
+            {
+                reason = string("exacta: ") + packing_checker_t::result_name(check.result);
+            }
+
+            for (int e = ENGINE_SPACE_LIST; (e <= ENGINE_LAYERS) && (report.optimal) && (reason.empty()); e++)
+            {
+                box_t heuristic(boxType, items);
+                heuristic.set_engine((packingEngine_t)e);
+                heuristic.place_items_in_box();
+
+                if (exact_packer_t::is_better_box(&heuristic, exact))
+                {
+                    reason = "exacta: óptima peor que el motor " + to_string(e);
+                }
+            }
+
+            delete exact;
+            return (reason);
+
+        }   /* check_exact() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Coloca y compara un pedido (se ejecuta en cualquier hilo).
+         */
+        void
+        test_order(const order_generator_t & generator, uint64_t index, soak_stats_t * stats)
+        {
+            list<item_t> items;
+            boxType_t boxType;
+            check_report_t report;
+
+            generator.generate(index, &items, &boxType);
+
+            space_t boxSize = box_t::size_of(boxType);
+            size_t numItems = items.size();
+            string reason;
+
+            box_t reference(boxType, &items);
+            reference.set_use_space_index(false);
+            reference.set_use_occupancy_grid(false);
+            reference.place_items_in_box();
+
+            box_t candidate(boxType, &items);
+            candidate.set_engine(engine);
+            candidate.set_item_order(itemOrder);
+            candidate.set_ep_score(epScore);
+            candidate.place_items_in_box();
+
+            stats->orders++;
+            stats->items += numItems;
+            stats->referenceFill += reference.get_fill_ratio();
+            stats->candidateFill += candidate.get_fill_ratio();
+
+            if (!(packing_checker_t::check(boxSize, reference.get_placed_items(), &report)))
+            {
+                stats->invalidReference++;
+                reason = string("referencia: ") + packing_checker_t::result_name(report.result);
+            }
+
+            if (!(packing_checker_t::check(boxSize, candidate.get_placed_items(), &report)))
+            {
+                stats->invalidCandidate++;
+                reason = string("candidato: ") + packing_checker_t::result_name(report.result);
+            }
+
+            if (((reference.get_num_placed_items() + reference.get_num_items_to_place()) != numItems) ||
+                ((candidate.get_num_placed_items() + candidate.get_num_items_to_place()) != numItems))
+            {
+                stats->lostItems++;
+                reason = "items perdidos";
+            }
+
+            if (!(check_rollback(boxType, &items, reference)))
+            {
+                stats->rollbackMismatches++;
+                reason = "rollback";
+            }
+
+            if ((engine == ENGINE_SPACE_LIST) && (itemOrder == ORDER_INPUT))
+            {
+                if (!(same_placement(reference, candidate)))
+                {
+                    stats->mismatches++;
+                    reason = "posiciones distintas";
+                }
+            }
+            else if (candidate.get_num_placed_items() < reference.get_num_placed_items())
+            {
+                stats->candidateFewer++;
+            }
+            else if (candidate.get_num_placed_items() > reference.get_num_placed_items())
+            {
+                stats->candidateMore++;
+            }
+
+            if (!(reason.empty()) && (stats->failures.size() < SOAK_MAX_FAILURES))
+            {
+                stats->failures.push_back(describe(index, boxType, items, reason));
+            }
+
+        }   /* test_order() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Suma las estadísticas de una tarea a las totales.
+         */
+        void
+        merge(const soak_stats_t & part, soak_stats_t * total)
+        {
+            lock_guard<mutex> guard(lock);
+
+            total->orders += part.orders;
+            total->items += part.items;
+            total->invalidReference += part.invalidReference;
+            total->invalidCandidate += part.invalidCandidate;
+            total->lostItems += part.lostItems;
+            total->mismatches += part.mismatches;
+            total->rollbackMismatches += part.rollbackMismatches;
+            total->exactMismatches += part.exactMismatches;
+            total->candidateFewer += part.candidateFewer;
+            total->candidateMore += part.candidateMore;
+            total->referenceFill += part.referenceFill;
+            total->candidateFill += part.candidateFill;
+
+            for (size_t i = 0; (i < part.failures.size()) && (total->failures.size() < SOAK_MAX_FAILURES); i++)
+            {
+                total->failures.push_back(part.failures[i]);
+            }
+
+        }   /* merge() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase soak_tester_t.
+         * @param  numThreads  Número de hilos (0 = uno por núcleo).
+         * @param  engine      Motor a probar.
+         * @param  itemOrder   Ordenación de los items a probar.
+         * @param  epScore     Puntuación de los puntos extremos a probar.
+         */
+        soak_tester_t(unsigned numThreads, packingEngine_t engine, itemOrder_t itemOrder,
+                      epScore_t epScore = EP_SCORE_ZXY) : pool(numThreads)
+        {
+            traceln(SOAK_TAG, "soak_tester_t()");
+
+            this->engine = engine;
+            this->itemOrder = itemOrder;
+            this->epScore = epScore;
+
+            traceln(SOAK_TAG, "soak_tester_t() - END");
+
+        }   /* soak_tester_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Prueba los pedidos 0 .. numOrders - 1 del generador.
+         * @param  generator  El generador de pedidos.
+         * @param  numOrders  Número de pedidos.
+         * @param  stats      Donde se dejan las estadísticas.
+         * @return Verdadero si no ha fallado ningún pedido.
+         */
+        bool
+        run(const order_generator_t & generator, size_t numOrders, soak_stats_t * stats)
+        {
+            traceln(SOAK_TAG, "run()");
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+            *stats = soak_stats_t();
+
+            for (size_t i = 0; i < SOAK_NUM_EXACT_ORDERS; i++)
+            {
+                list<item_t> items;
+
+                for (size_t k = 0; SOAK_EXACT_ORDERS[i].items[k] != NULL; k++)
+                {
+                    items.push_back(item_t(SOAK_EXACT_ORDERS[i].items[k]));
+                }
+
+                string reason = check_exact(SOAK_EXACT_ORDERS[i].boxType, &items);
+
+                if (!(reason.empty()))
+                {
+                    stats->exactMismatches++;
+                    stats->failures.push_back(describe(i, SOAK_EXACT_ORDERS[i].boxType, items, reason));
+                }
+            }
+
+            for (size_t first = 0; first < numOrders; first += SOAK_CHUNK_SIZE)
+            {
+                size_t last = std::min(first + SOAK_CHUNK_SIZE, numOrders);
+
+                pool.submit([this, &generator, stats, first, last]()
+                {
+                    soak_stats_t part = soak_stats_t();
+
+                    for (size_t i = first; i < last; i++)
+                    {
+                        test_order(generator, i, &part);
+                    }
+
+                    merge(part, stats);
+                });
+            }
+
+            pool.wait_idle();
+
+            stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            traceln(SOAK_TAG, "run() - END");
+
+            return ((stats->invalidReference == 0) && (stats->invalidCandidate == 0) &&
+                    (stats->lostItems == 0) && (stats->mismatches == 0) &&
+                    (stats->rollbackMismatches == 0) && (stats->exactMismatches == 0));
+
+        }   /* run() */
+};
+
+#endif /* SOAK_TESTER_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,783 @@
+/**
+ * @file     space_index_t.h
+ *
+ * @brief    Índice espacial (árbol de AABBs) sobre la lista spaceInUse.
+ *
+ * El índice guarda una copia de las coordenadas de cada espacio ocupado en un
+ * árbol de volúmenes envolventes (BVH). Cada nodo interno almacena la caja que
+ * engloba a todos sus hijos, de modo que las consultas de contención y de
+ * solapamiento descartan ramas enteras sin recorrer toda la lista.
+ *
+ * rebuild() construye el árbol desde cero dividiendo por la mediana. Después,
+ * cada cambio de spaceInUse se aplica en su sitio: insert() baja por la rama
+ * que menos crece y añade el espacio al hueco libre de la hoja (si está
+ * llena, la divide en dos) y remove() lo quita de su hoja y ajusta las cajas
+ * de la rama hacia arriba. Ambos cuestan O(profundidad). Cuando el árbol ha
+ * recibido más cambios que espacios tiene, o una rama se hace demasiado
+ * profunda, se vuelve a construir con sus propios espacios.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del índice espacial
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef SPACE_INDEX_T_H
+#define SPACE_INDEX_T_H
+
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+
+using namespace std;
+
+// static const char * SPACE_INDEX_TAG = __FILE__;
+static const char * SPACE_INDEX_TAG = "space_index_t.h";
+
+// Número máximo de espacios que se guardan en una hoja al construir el árbol.
+#define SPACE_INDEX_LEAF_SIZE 4
+
+// Huecos de cada hoja: los que quedan libres los ocupa insert().
+#define SPACE_INDEX_LEAF_CAPACITY 8
+
+// Profundidad a partir de la cual se vuelve a construir el árbol (las
+// consultas usan una pila de 64 nodos).
+#define SPACE_INDEX_MAX_DEPTH 32
+
+// Valor de count de los nodos internos y de parent de la raíz.
+#define SPACE_INDEX_NONE 0xFFFFFFFF
+
+class space_index_t
+{
+    private:
+
+        // Caja alineada con los ejes: [0..2] = min (x, y, z), [3..5] = max (x, y, z).
+        typedef struct
+        {
+            uint16_t c[6];
+
+        } aabb_t;
+
+        // Nodo del árbol. Si count != SPACE_INDEX_NONE es una hoja con los
+        // espacios [first, first + count) del vector leaves (su hueco llega
+        // hasta first + SPACE_INDEX_LEAF_CAPACITY), si no, first y second son
+        // los índices de sus dos hijos.
+        typedef struct
+        {
+            aabb_t box;
+            uint32_t first;
+            uint32_t second;
+            uint32_t count;
+            uint32_t parent;
+
+        } node_t;
+
+        // ATRIBUTOS.
+        pmr::vector<node_t> nodes;
+        pmr::vector<aabb_t> leaves;
+        pmr::vector<aabb_t> scratch; // espacios a partir de los que se construye
+        size_t live;                 // espacios indexados
+        size_t updates;              // insert() y remove() desde la última construcción
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si la caja a contiene por completo a la caja b.
+         */
+        static bool
+        contains(const aabb_t & a, const aabb_t & b)
+        {
+            return ((a.c[0] <= b.c[0]) && (a.c[1] <= b.c[1]) && (a.c[2] <= b.c[2]) &&
+                    (a.c[3] >= b.c[3]) && (a.c[4] >= b.c[4]) && (a.c[5] >= b.c[5]));
+
+        }   /* contains() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si el interior de la caja a se solapa con el de la caja b
+         *         (compartir una cara no se considera solapamiento).
+         */
+        static bool
+        overlaps(const aabb_t & a, const aabb_t & b)
+        {
+            return ((a.c[0] < b.c[3]) && (b.c[0] < a.c[3]) &&
+                    (a.c[1] < b.c[4]) && (b.c[1] < a.c[4]) &&
+                    (a.c[2] < b.c[5]) && (b.c[2] < a.c[5]));
+
+        }   /* overlaps() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos cajas son iguales.
+         */
+        static bool
+        equals(const aabb_t & a, const aabb_t & b)
+        {
+            return ((a.c[0] == b.c[0]) && (a.c[1] == b.c[1]) && (a.c[2] == b.c[2]) &&
+                    (a.c[3] == b.c[3]) && (a.c[4] == b.c[4]) && (a.c[5] == b.c[5]));
+
+        }   /* equals() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la caja vacía: min > max, así que no contiene ni se
+         *         solapa con nada y no cambia la caja a la que se une.
+         */
+        static aabb_t
+        empty_box(void)
+        {
+            aabb_t box = {{0xFFFF, 0xFFFF, 0xFFFF, 0, 0, 0}};
+            return box;
+
+        }   /* empty_box() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Amplía la caja a para que englobe también a la caja b.
+         */
+        static void
+        extend(aabb_t & a, const aabb_t & b)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                a.c[k]     = std::min(a.c[k],     b.c[k]);
+                a.c[k + 3] = std::max(a.c[k + 3], b.c[k + 3]);
+            }
+
+        }   /* extend() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula el volumen de una caja (0 si está vacía).
+         */
+        static uint64_t
+        volume(const aabb_t & a)
+        {
+            if ((a.c[3] < a.c[0]) || (a.c[4] < a.c[1]) || (a.c[5] < a.c[2]))
+            {
+                return (0);
+            }
+
+            return ((uint64_t)(a.c[3] - a.c[0]) * (a.c[4] - a.c[1]) * (a.c[5] - a.c[2]));
+
+        }   /* volume() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Convierte un space_t en un aabb_t.
+         */
+        static aabb_t
+        to_aabb(space_t space)
+        {
+            aabb_t box = {{space.min_x(), space.min_y(), space.min_z(),
+                           space.max_x(), space.max_y(), space.max_z()}};
+            return box;
+
+        }   /* to_aabb() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade una hoja con los espacios de un rango y le reserva su
+         *         hueco completo en leaves.
+         * @param  boxes   Primer espacio del rango.
+         * @param  count   Número de espacios (como mucho SPACE_INDEX_LEAF_CAPACITY).
+         * @param  parent  Índice del nodo padre.
+         * @return Índice del nodo creado.
+         */
+        uint32_t
+        add_leaf(const aabb_t * boxes, uint32_t count, uint32_t parent)
+        {
+            node_t node;
+
+            node.box    = empty_box();
+            node.first  = leaves.size();
+            node.second = 0;
+            node.count  = count;
+            node.parent = parent;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                extend(node.box, boxes[i]);
+                leaves.push_back(boxes[i]);
+            }
+            leaves.resize(node.first + SPACE_INDEX_LEAF_CAPACITY, empty_box());
+
+            nodes.push_back(node);
+            return (nodes.size() - 1);
+
+        }   /* add_leaf() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Construye recursivamente el subárbol de scratch[first, last).
+         * @param  first   Primer espacio del rango.
+         * @param  last    Uno más allá del último espacio del rango.
+         * @param  parent  Índice del nodo padre (SPACE_INDEX_NONE para la raíz).
+         * @return Índice del nodo creado.
+         */
+        uint32_t
+        build(uint32_t first, uint32_t last, uint32_t parent)
+        {
+            // 1) Si caben en una hoja, no se divide más.
+            if ((last - first) <= SPACE_INDEX_LEAF_SIZE)
+            {
+                return (add_leaf(scratch.data() + first, last - first, parent));
+            }
+
+            // 2) Calcular la caja envolvente del rango.
+            uint32_t index = nodes.size();
+            node_t node;
+
+            node.box = empty_box();
+            for (uint32_t i = first; i < last; i++)
+            {
+                extend(node.box, scratch[i]);
+            }
+
+            node.first  = 0;
+            node.second = 0;
+            node.count  = SPACE_INDEX_NONE;
+            node.parent = parent;
+            nodes.push_back(node);
+
+            // 3) Dividir por la mediana de los centros en el eje más largo.
+            int axis = 0;
+            for (int k = 1; k < 3; k++)
+            {
+                if ((node.box.c[k + 3] - node.box.c[k]) > (node.box.c[axis + 3] - node.box.c[axis]))
+                {
+                    axis = k;
+                }
+            }
+
+            uint32_t middle = first + ((last - first) / 2);
+            nth_element(scratch.begin() + first, scratch.begin() + middle, scratch.begin() + last,
+                        [axis](const aabb_t & a, const aabb_t & b)
+                        {
+                            return ((a.c[axis] + a.c[axis + 3]) < (b.c[axis] + b.c[axis + 3]));
+                        });
+
+            uint32_t left  = build(first, middle, index);
+            uint32_t right = build(middle, last, index);
+
+            nodes[index].first  = left;
+            nodes[index].second = right;
+
+            return (index);
+
+        }   /* build() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Construye el árbol desde cero con los espacios de scratch.
+         * @param  void
+         * @return void
+         */
+        void
+        build_tree(void)
+        {
+            nodes.clear();
+            leaves.clear();
+
+            live = scratch.size();
+            updates = 0;
+
+            if (scratch.empty())
+            {
+                add_leaf(NULL, 0, SPACE_INDEX_NONE);
+            }
+            else
+            {
+                build(0, scratch.size(), SPACE_INDEX_NONE);
+            }
+
+        }   /* build_tree() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Copia los espacios que contiene el árbol (en el orden de sus
+         *         hojas).
+         * @param  out  Donde se dejan.
+         * @return void
+         */
+        void
+        collect(pmr::vector<aabb_t> * out)
+        {
+            out->clear();
+
+            for (size_t i = 0; i < nodes.size(); i++)
+            {
+                if (nodes[i].count != SPACE_INDEX_NONE)
+                {
+                    out->insert(out->end(), leaves.begin() + nodes[i].first,
+                                leaves.begin() + nodes[i].first + nodes[i].count);
+                }
+            }
+
+        }   /* collect() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve a construir el árbol con los espacios que ya contiene.
+         * @param  void
+         * @return void
+         */
+        void
+        repack(void)
+        {
+            traceln(SPACE_INDEX_TAG, "repack()");
+
+            collect(&scratch);
+            build_tree();
+
+            traceln(SPACE_INDEX_TAG, "repack() - END");
+
+        }   /* repack() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Divide una hoja llena en dos hojas, por la mediana del eje más
+         *         largo, y añade un espacio más. La hoja pasa a ser un nodo
+         *         interno con las dos nuevas como hijos.
+         * @param  index  Índice de la hoja.
+         * @param  box    El espacio que no cabía.
+         * @return void
+         */
+        void
+        split(uint32_t index, const aabb_t & box)
+        {
+            aabb_t all[SPACE_INDEX_LEAF_CAPACITY + 1];
+            node_t leaf = nodes[index];
+            int axis = 0;
+
+            for (uint32_t i = 0; i < leaf.count; i++)
+            {
+                all[i] = leaves[leaf.first + i];
+            }
+            all[leaf.count] = box;
+
+            for (int k = 1; k < 3; k++)
+            {
+                if ((leaf.box.c[k + 3] - leaf.box.c[k]) > (leaf.box.c[axis + 3] - leaf.box.c[axis]))
+                {
+                    axis = k;
+                }
+            }
+
+            sort(all, all + leaf.count + 1,
+                 [axis](const aabb_t & a, const aabb_t & b)
+                 {
+                     return ((a.c[axis] + a.c[axis + 3]) < (b.c[axis] + b.c[axis + 3]));
+                 });
+
+            // La primera mitad se queda en el hueco de la hoja y la segunda va a
+            // uno nuevo.
+            uint32_t half = (leaf.count + 1) / 2;
+            node_t node;
+
+            node.box    = empty_box();
+            node.first  = leaf.first;
+            node.second = 0;
+            node.count  = half;
+            node.parent = index;
+
+            for (uint32_t i = 0; i < half; i++)
+            {
+                leaves[leaf.first + i] = all[i];
+                extend(node.box, all[i]);
+            }
+
+            nodes.push_back(node);
+            uint32_t left = nodes.size() - 1;
+            uint32_t right = add_leaf(all + half, leaf.count + 1 - half, index);
+
+            nodes[index].first  = left;
+            nodes[index].second = right;
+            nodes[index].count  = SPACE_INDEX_NONE;
+
+        }   /* split() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Recalcula las cajas desde un nodo hasta la raíz, parando en
+         *         cuanto una no cambia.
+         * @param  index  Índice del primer nodo.
+         * @return void
+         */
+        void
+        refit(uint32_t index)
+        {
+            while (index != SPACE_INDEX_NONE)
+            {
+                node_t & node = nodes[index];
+                aabb_t box = empty_box();
+
+                if (node.count != SPACE_INDEX_NONE)
+                {
+                    for (uint32_t i = node.first; i < (node.first + node.count); i++)
+                    {
+                        extend(box, leaves[i]);
+                    }
+                }
+                else
+                {
+                    extend(box, nodes[node.first].box);
+                    extend(box, nodes[node.second].box);
+                }
+
+                if (equals(box, node.box))
+                {
+                    break;
+                }
+
+                node.box = box;
+                index = node.parent;
+            }
+
+        }   /* refit() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase space_index_t.
+         * @param  resource  De donde salen los nodos del árbol.
+         */
+        space_index_t(pmr::memory_resource * resource = pmr::get_default_resource()) :
+            nodes(resource), leaves(resource), scratch(resource)
+        {
+            traceln(SPACE_INDEX_TAG, "space_index_t()");
+
+            this->live = 0;
+            this->updates = 0;
+
+            traceln(SPACE_INDEX_TAG, "space_index_t() - END");
+
+        }   /* space_index_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Reconstruye el índice a partir de la lista de espacios en uso.
+         * @param  spaces  Lista de espacios que se desea indexar.
+         * @return void
+         */
+        void
+        rebuild(pmr::list<space_t> & spaces)
+        {
+            traceln(SPACE_INDEX_TAG, "rebuild()");
+
+            scratch.clear();
+
+            for (pmr::list<space_t>::iterator it = spaces.begin();
+                (it != spaces.end()); ++it)
+            {
+                scratch.push_back(to_aabb(*it));
+            }
+
+            build_tree();
+
+            traceln(SPACE_INDEX_TAG, "rebuild() - END");
+
+        }   /* rebuild() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade un espacio al índice sin reconstruirlo.
+         * @param  space  El espacio añadido a spaceInUse.
+         * @return void
+         */
+        void
+        insert(space_t space)
+        {
+            traceln(SPACE_INDEX_TAG, "insert()");
+
+            aabb_t box = to_aabb(space);
+            uint32_t index = 0;
+            int depth = 0;
+
+            if (nodes.empty())
+            {
+                scratch.clear();
+                build_tree();
+            }
+
+            // 1) Bajar por el hijo cuya caja crece menos (a igualdad, el más
+            //    pequeño), ampliando las cajas del camino.
+            while (nodes[index].count == SPACE_INDEX_NONE)
+            {
+                extend(nodes[index].box, box);
+
+                const node_t & node = nodes[index];
+                aabb_t a = nodes[node.first].box;
+                aabb_t b = nodes[node.second].box;
+                uint64_t volumeA = volume(a), volumeB = volume(b);
+
+                extend(a, box);
+                extend(b, box);
+
+                uint64_t growA = volume(a) - volumeA;
+                uint64_t growB = volume(b) - volumeB;
+
+                index = ((growA < growB) || ((growA == growB) && (volumeA <= volumeB))) ?
+                        (node.first) : (node.second);
+                depth++;
+            }
+
+            // 2) Guardarlo en el hueco de la hoja o, si está llena, dividirla.
+            extend(nodes[index].box, box);
+
+            if (nodes[index].count < SPACE_INDEX_LEAF_CAPACITY)
+            {
+                leaves[nodes[index].first + nodes[index].count] = box;
+                nodes[index].count++;
+            }
+            else
+            {
+                split(index, box);
+                depth++;
+            }
+
+            live++;
+            updates++;
+
+            // 3) Si el árbol se ha desequilibrado, construirlo de nuevo.
+            if ((depth >= SPACE_INDEX_MAX_DEPTH) || (updates > (live + SPACE_INDEX_LEAF_CAPACITY)))
+            {
+                repack();
+            }
+
+            traceln(SPACE_INDEX_TAG, "insert() - END");
+
+        }   /* insert() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Quita del índice un espacio igual a space (si hay varios
+         *         iguales, uno de ellos).
+         * @param  space  El espacio quitado de spaceInUse.
+         * @return Verdadero si estaba en el índice.
+         */
+        bool
+        remove(space_t space)
+        {
+            traceln(SPACE_INDEX_TAG, "remove()");
+
+            aabb_t query = to_aabb(space);
+            uint32_t stack[64];
+            int top = 0;
+
+            if (!(nodes.empty()))
+            {
+                stack[top++] = 0;
+            }
+
+            while (top > 0)
+            {
+                uint32_t index = stack[--top];
+                node_t & node = nodes[index];
+
+                // Solo las ramas que contienen al espacio pueden guardarlo.
+                if (!(contains(node.box, query)))
+                {
+                    continue;
+                }
+
+                if (node.count == SPACE_INDEX_NONE)
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.second;
+                    continue;
+                }
+
+                for (uint32_t i = node.first; i < (node.first + node.count); i++)
+                {
+                    if (equals(leaves[i], query))
+                    {
+                        // El último espacio de la hoja ocupa su hueco.
+                        leaves[i] = leaves[node.first + node.count - 1];
+                        node.count--;
+                        refit(index);
+
+                        live--;
+                        updates++;
+                        if (updates > (live + SPACE_INDEX_LEAF_CAPACITY))
+                        {
+                            repack();
+                        }
+
+                        traceln(SPACE_INDEX_TAG, "remove() - END");
+                        return (true);
+                    }
+                }
+            }
+
+            traceln(SPACE_INDEX_TAG, "remove() - END");
+            return (false);
+
+        }   /* remove() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si algún espacio indexado contiene por completo a space,
+         *         es decir, si space es subconjunto de algún espacio en uso.
+         * @param  space  El espacio a consultar.
+         * @return Verdadero o falso.
+         */
+        bool
+        any_contains(space_t space)
+        {
+            traceln(SPACE_INDEX_TAG, "any_contains()");
+
+            aabb_t query = to_aabb(space);
+            uint32_t stack[64];
+            int top = 0;
+            bool answer = false;
+
+            if (!(nodes.empty()))
+            {
+                stack[top++] = 0;
+            }
+
+            while ((top > 0) && (answer == false))
+            {
+                const node_t & node = nodes[stack[--top]];
+
+                // Si la caja del nodo no contiene a query, ningún hijo lo hará.
+                if (!(contains(node.box, query)))
+                {
+                    continue;
+                }
+
+                if (node.count != SPACE_INDEX_NONE)
+                {
+                    for (uint32_t i = node.first; i < (node.first + node.count); i++)
+                    {
+                        if (contains(leaves[i], query))
+                        {
+                            answer = true;
+                        }
+                    }
+                }
+                else
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.second;
+                }
+            }
+
+            traceln(SPACE_INDEX_TAG, "any_contains() - END");
+            return (answer);
+
+        }   /* any_contains() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si algún espacio indexado se solapa con space.
+         * @param  space  El espacio a consultar.
+         * @return Verdadero o falso.
+         */
+        bool
+        any_overlaps(space_t space)
+        {
+            traceln(SPACE_INDEX_TAG, "any_overlaps()");
+
+            aabb_t query = to_aabb(space);
+            uint32_t stack[64];
+            int top = 0;
+            bool answer = false;
+
+            if (!(nodes.empty()))
+            {
+                stack[top++] = 0;
+            }
+
+            while ((top > 0) && (answer == false))
+            {
+                const node_t & node = nodes[stack[--top]];
+
+                if (!(overlaps(node.box, query)))
+                {
+                    continue;
+                }
+
+                if (node.count != SPACE_INDEX_NONE)
+                {
+                    for (uint32_t i = node.first; i < (node.first + node.count); i++)
+                    {
+                        if (overlaps(leaves[i], query))
+                        {
+                            answer = true;
+                        }
+                    }
+                }
+                else
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.second;
+                }
+            }
+
+            traceln(SPACE_INDEX_TAG, "any_overlaps() - END");
+            return (answer);
+
+        }   /* any_overlaps() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos índices contienen los mismos espacios, aunque
+         *         sus árboles tengan otra forma.
+         * @param  other  El otro índice.
+         * @return Verdadero o falso.
+         */
+        bool
+        same_spaces(space_index_t & other)
+        {
+            if (live != other.live)
+            {
+                return (false);
+            }
+
+            collect(&scratch);
+            other.collect(&other.scratch);
+
+            auto before = [](const aabb_t & a, const aabb_t & b)
+                          {
+                              return lexicographical_compare(a.c, a.c + 6, b.c, b.c + 6);
+                          };
+            sort(scratch.begin(), scratch.end(), before);
+            sort(other.scratch.begin(), other.scratch.end(), before);
+
+            for (size_t i = 0; i < scratch.size(); i++)
+            {
+                if (!(equals(scratch[i], other.scratch[i])))
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+
+        }   /* same_spaces() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de espacios indexados.
+         * @param  void
+         * @return Número de espacios.
+         */
+        size_t
+        size(void)
+        {
+            return live;
+
+        }   /* size() */
+};
+
+#endif /* SPACE_INDEX_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,416 @@
+/**
+ * @file     space_soa_t.h
+ *
+ * @brief    Copia de la lista spaceInUse en forma de estructura de arrays.
+ *
+ * Cada coordenada (min_x ... max_z) se guarda en su propio array de uint16_t,
+ * de modo que una misma comparación se aplica a varios espacios a la vez: 16
+ * por instrucción con AVX2 y 8 con SSE2. Los espacios que no llenan un bloque
+ * completo se tratan con la versión escalar.
+ *
+ * Las instrucciones comparan enteros de 16 bits con signo: es correcto porque
+ * ninguna coordenada de la caja llega a 32768 mm.
+ *
+ * Los arrays salen del memory_resource de la caja (ver order_arena_t) y se
+ * crean ya con sitio para SPACE_SOA_RESERVE espacios.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de los espacios en arrays
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef SPACE_SOA_T_H
+#define SPACE_SOA_T_H
+
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// static const char * SPACE_SOA_TAG = __FILE__;
+static const char * SPACE_SOA_TAG = "space_soa_t.h";
+
+// Espacios para los que se reserva sitio al crear los arrays.
+#define SPACE_SOA_RESERVE 64
+
+class space_soa_t
+{
+    private:
+
+        // ATRIBUTOS.
+        pmr::vector<uint16_t> minX, minY, minZ;
+        pmr::vector<uint16_t> maxX, maxY, maxZ;
+        pmr::vector<pmr::list<space_t>::iterator> nodes; // nodo de la lista de cada espacio
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase space_soa_t.
+         * @param  resource  De donde salen los arrays.
+         */
+        space_soa_t(pmr::memory_resource * resource = pmr::get_default_resource()) :
+            minX(resource), minY(resource), minZ(resource),
+            maxX(resource), maxY(resource), maxZ(resource), nodes(resource)
+        {
+            traceln(SPACE_SOA_TAG, "space_soa_t()");
+
+            minX.reserve(SPACE_SOA_RESERVE); minY.reserve(SPACE_SOA_RESERVE); minZ.reserve(SPACE_SOA_RESERVE);
+            maxX.reserve(SPACE_SOA_RESERVE); maxY.reserve(SPACE_SOA_RESERVE); maxZ.reserve(SPACE_SOA_RESERVE);
+            nodes.reserve(SPACE_SOA_RESERVE);
+
+            traceln(SPACE_SOA_TAG, "space_soa_t() - END");
+
+        }   /* space_soa_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve a copiar la lista de espacios, en el mismo orden.
+         * @param  spaces  Lista de espacios que se desea copiar.
+         * @return void
+         */
+        void
+        rebuild(pmr::list<space_t> & spaces)
+        {
+            traceln(SPACE_SOA_TAG, "rebuild()");
+
+            const size_t n = spaces.size();
+            size_t i = 0;
+
+            minX.resize(n); minY.resize(n); minZ.resize(n);
+            maxX.resize(n); maxY.resize(n); maxZ.resize(n);
+            nodes.resize(n);
+
+            for (pmr::list<space_t>::iterator it = spaces.begin();
+                (it != spaces.end()); ++it, i++)
+            {
+                minX[i] = it->min_x(); minY[i] = it->min_y(); minZ[i] = it->min_z();
+                maxX[i] = it->max_x(); maxY[i] = it->max_y(); maxZ[i] = it->max_z();
+                nodes[i] = it;
+            }
+
+            traceln(SPACE_SOA_TAG, "rebuild() - END");
+
+        }   /* rebuild() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Quita los espacios marcados, conservando el orden de los demás
+         *         (como rebuild() tras borrarlos de la lista, sin recorrerla).
+         * @param  erased  Un valor por espacio: distinto de 0 para quitarlo.
+         * @return void
+         */
+        void
+        remove_marked(const uint8_t * erased)
+        {
+            traceln(SPACE_SOA_TAG, "remove_marked()");
+
+            const size_t n = minX.size();
+            size_t kept = 0;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                if (erased[i] == 0)
+                {
+                    minX[kept] = minX[i]; minY[kept] = minY[i]; minZ[kept] = minZ[i];
+                    maxX[kept] = maxX[i]; maxY[kept] = maxY[i]; maxZ[kept] = maxZ[i];
+                    nodes[kept] = nodes[i];
+                    kept++;
+                }
+            }
+
+            minX.resize(kept); minY.resize(kept); minZ.resize(kept);
+            maxX.resize(kept); maxY.resize(kept); maxZ.resize(kept);
+            nodes.resize(kept);
+
+            traceln(SPACE_SOA_TAG, "remove_marked() - END");
+
+        }   /* remove_marked() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si algún espacio contiene por completo a space, es
+         *         decir, si space es subconjunto de alguno de ellos.
+         * @param  space  El espacio a consultar.
+         * @return Verdadero o falso.
+         */
+        bool
+        any_contains(space_t space)
+        {
+            traceln(SPACE_SOA_TAG, "any_contains()");
+
+            const size_t n = minX.size();
+            size_t i = 0;
+            bool answer = false;
+
+            #if defined(__AVX2__)
+            // 16 espacios por instrucción. Un carril queda a 0 en "outside"
+            // solo si su espacio contiene a space.
+            const __m256i qMinX = _mm256_set1_epi16(space.min_x());
+            const __m256i qMinY = _mm256_set1_epi16(space.min_y());
+            const __m256i qMinZ = _mm256_set1_epi16(space.min_z());
+            const __m256i qMaxX = _mm256_set1_epi16(space.max_x());
+            const __m256i qMaxY = _mm256_set1_epi16(space.max_y());
+            const __m256i qMaxZ = _mm256_set1_epi16(space.max_z());
+
+            for (; ((i + 16) <= n) && (answer == false); i += 16)
+            {
+                __m256i outside = _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&minX[i])), qMinX);
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&minY[i])), qMinY));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&minZ[i])), qMinZ));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(qMaxX, _mm256_loadu_si256((const __m256i *)(&maxX[i]))));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(qMaxY, _mm256_loadu_si256((const __m256i *)(&maxY[i]))));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(qMaxZ, _mm256_loadu_si256((const __m256i *)(&maxZ[i]))));
+
+                answer = ((uint32_t)_mm256_movemask_epi8(outside) != 0xFFFFFFFFu);
+            }
+            #elif defined(__SSE2__)
+            // 8 espacios por instrucción.
+            const __m128i qMinX = _mm_set1_epi16(space.min_x());
+            const __m128i qMinY = _mm_set1_epi16(space.min_y());
+            const __m128i qMinZ = _mm_set1_epi16(space.min_z());
+            const __m128i qMaxX = _mm_set1_epi16(space.max_x());
+            const __m128i qMaxY = _mm_set1_epi16(space.max_y());
+            const __m128i qMaxZ = _mm_set1_epi16(space.max_z());
+
+            for (; ((i + 8) <= n) && (answer == false); i += 8)
+            {
+                __m128i outside = _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&minX[i])), qMinX);
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&minY[i])), qMinY));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&minZ[i])), qMinZ));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(qMaxX, _mm_loadu_si128((const __m128i *)(&maxX[i]))));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(qMaxY, _mm_loadu_si128((const __m128i *)(&maxY[i]))));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(qMaxZ, _mm_loadu_si128((const __m128i *)(&maxZ[i]))));
+
+                answer = (_mm_movemask_epi8(outside) != 0xFFFF);
+            }
+            #endif
+
+            // Versión escalar (espacios restantes).
+            for (; (i < n) && (answer == false); i++)
+            {
+                answer = ((minX[i] <= space.min_x()) && (minY[i] <= space.min_y()) &&
+                          (minZ[i] <= space.min_z()) && (maxX[i] >= space.max_x()) &&
+                          (maxY[i] >= space.max_y()) && (maxZ[i] >= space.max_z()));
+            }
+
+            traceln(SPACE_SOA_TAG, "any_contains() - END");
+            return (answer);
+
+        }   /* any_contains() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Marca los espacios que space contiene por completo (los que
+         *         son subconjunto de space, incluido él mismo si está).
+         * @param  space      El espacio que domina.
+         * @param  dominated  Array de size() posiciones: 1 si el espacio i es
+         *                    subconjunto de space, 0 si no.
+         * @return Número de espacios marcados.
+         */
+        size_t
+        dominated_by(space_t space, uint8_t * dominated)
+        {
+            traceln(SPACE_SOA_TAG, "dominated_by()");
+
+            const size_t n = minX.size();
+            size_t i = 0;
+            size_t count = 0;
+
+            #if defined(__AVX2__) || defined(__SSE2__)
+            // Se compara con el mismo esquema que any_contains() pero con los
+            // papeles cambiados; los 16 bits de cada carril se empaquetan a 8.
+            const __m128i one = _mm_set1_epi8(1);
+            #endif
+
+            #if defined(__AVX2__)
+            const __m256i qMinX = _mm256_set1_epi16(space.min_x());
+            const __m256i qMinY = _mm256_set1_epi16(space.min_y());
+            const __m256i qMinZ = _mm256_set1_epi16(space.min_z());
+            const __m256i qMaxX = _mm256_set1_epi16(space.max_x());
+            const __m256i qMaxY = _mm256_set1_epi16(space.max_y());
+            const __m256i qMaxZ = _mm256_set1_epi16(space.max_z());
+
+            for (; (i + 16) <= n; i += 16)
+            {
+                __m256i outside = _mm256_cmpgt_epi16(qMinX, _mm256_loadu_si256((const __m256i *)(&minX[i])));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(qMinY, _mm256_loadu_si256((const __m256i *)(&minY[i]))));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(qMinZ, _mm256_loadu_si256((const __m256i *)(&minZ[i]))));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&maxX[i])), qMaxX));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&maxY[i])), qMaxY));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)(&maxZ[i])), qMaxZ));
+
+                __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(outside),
+                                                 _mm256_extracti128_si256(outside, 1));
+                _mm_storeu_si128((__m128i *)(&dominated[i]), _mm_andnot_si128(packed, one));
+                count += 16 - (__builtin_popcount((uint32_t)_mm_movemask_epi8(packed)));
+            }
+            #elif defined(__SSE2__)
+            const __m128i qMinX = _mm_set1_epi16(space.min_x());
+            const __m128i qMinY = _mm_set1_epi16(space.min_y());
+            const __m128i qMinZ = _mm_set1_epi16(space.min_z());
+            const __m128i qMaxX = _mm_set1_epi16(space.max_x());
+            const __m128i qMaxY = _mm_set1_epi16(space.max_y());
+            const __m128i qMaxZ = _mm_set1_epi16(space.max_z());
+
+            for (; (i + 8) <= n; i += 8)
+            {
+                __m128i outside = _mm_cmpgt_epi16(qMinX, _mm_loadu_si128((const __m128i *)(&minX[i])));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(qMinY, _mm_loadu_si128((const __m128i *)(&minY[i]))));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(qMinZ, _mm_loadu_si128((const __m128i *)(&minZ[i]))));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&maxX[i])), qMaxX));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&maxY[i])), qMaxY));
+                outside = _mm_or_si128(outside, _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)(&maxZ[i])), qMaxZ));
+
+                __m128i packed = _mm_packs_epi16(outside, outside);
+                _mm_storel_epi64((__m128i *)(&dominated[i]), _mm_andnot_si128(packed, one));
+                count += 8 - (__builtin_popcount((uint32_t)_mm_movemask_epi8(packed) & 0xFF));
+            }
+            #endif
+
+            // Versión escalar (espacios restantes).
+            for (; i < n; i++)
+            {
+                dominated[i] = ((minX[i] >= space.min_x()) && (minY[i] >= space.min_y()) &&
+                                (minZ[i] >= space.min_z()) && (maxX[i] <= space.max_x()) &&
+                                (maxY[i] <= space.max_y()) && (maxZ[i] <= space.max_z()));
+                count += dominated[i];
+            }
+
+            traceln(SPACE_SOA_TAG, "dominated_by() - END");
+            return (count);
+
+        }   /* dominated_by() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula el mínimo de max_x, max_y y max_z de todos los espacios.
+         * @param  limit  Valor inicial (el resultado nunca es mayor).
+         * @return El mínimo de cada coordenada.
+         */
+        point_t
+        min_of_max(point_t limit)
+        {
+            traceln(SPACE_SOA_TAG, "min_of_max()");
+
+            const size_t n = minX.size();
+            size_t i = 0;
+            point_t answer = limit;
+
+            #if defined(__AVX2__)
+            __m256i accX = _mm256_set1_epi16(limit.x);
+            __m256i accY = _mm256_set1_epi16(limit.y);
+            __m256i accZ = _mm256_set1_epi16(limit.z);
+
+            for (; (i + 16) <= n; i += 16)
+            {
+                accX = _mm256_min_epi16(accX, _mm256_loadu_si256((const __m256i *)(&maxX[i])));
+                accY = _mm256_min_epi16(accY, _mm256_loadu_si256((const __m256i *)(&maxY[i])));
+                accZ = _mm256_min_epi16(accZ, _mm256_loadu_si256((const __m256i *)(&maxZ[i])));
+            }
+
+            alignas(32) uint16_t lanes[3][16];
+            _mm256_store_si256((__m256i *)(lanes[0]), accX);
+            _mm256_store_si256((__m256i *)(lanes[1]), accY);
+            _mm256_store_si256((__m256i *)(lanes[2]), accZ);
+
+            for (int k = 0; k < 16; k++)
+            {
+                if (lanes[0][k] < answer.x) { answer.x = lanes[0][k]; }
+                if (lanes[1][k] < answer.y) { answer.y = lanes[1][k]; }
+                if (lanes[2][k] < answer.z) { answer.z = lanes[2][k]; }
+            }
+            #elif defined(__SSE2__)
+            __m128i accX = _mm_set1_epi16(limit.x);
+            __m128i accY = _mm_set1_epi16(limit.y);
+            __m128i accZ = _mm_set1_epi16(limit.z);
+
+            for (; (i + 8) <= n; i += 8)
+            {
+                accX = _mm_min_epi16(accX, _mm_loadu_si128((const __m128i *)(&maxX[i])));
+                accY = _mm_min_epi16(accY, _mm_loadu_si128((const __m128i *)(&maxY[i])));
+                accZ = _mm_min_epi16(accZ, _mm_loadu_si128((const __m128i *)(&maxZ[i])));
+            }
+
+            alignas(16) uint16_t lanes[3][8];
+            _mm_store_si128((__m128i *)(lanes[0]), accX);
+            _mm_store_si128((__m128i *)(lanes[1]), accY);
+            _mm_store_si128((__m128i *)(lanes[2]), accZ);
+
+            for (int k = 0; k < 8; k++)
+            {
+                if (lanes[0][k] < answer.x) { answer.x = lanes[0][k]; }
+                if (lanes[1][k] < answer.y) { answer.y = lanes[1][k]; }
+                if (lanes[2][k] < answer.z) { answer.z = lanes[2][k]; }
+            }
+            #endif
+
+            // Versión escalar (espacios restantes).
+            for (; i < n; i++)
+            {
+                if (maxX[i] < answer.x) { answer.x = maxX[i]; }
+                if (maxY[i] < answer.y) { answer.y = maxY[i]; }
+                if (maxZ[i] < answer.z) { answer.z = maxZ[i]; }
+            }
+
+            traceln(SPACE_SOA_TAG, "min_of_max() - END");
+            return (answer);
+
+        }   /* min_of_max() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el nodo de la lista del que se copió el espacio i.
+         * @param  i  Posición del espacio (en el orden de la lista).
+         * @return Iterador al nodo.
+         */
+        pmr::list<space_t>::iterator
+        node(size_t i)
+        {
+            return nodes[i];
+
+        }   /* node() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos copias tienen los mismos espacios en el mismo
+         *         orden (los nodos de la lista no se comparan).
+         * @param  other  La otra copia.
+         * @return Verdadero o falso.
+         */
+        bool
+        same_spaces(space_soa_t & other)
+        {
+            return ((minX == other.minX) && (minY == other.minY) && (minZ == other.minZ) &&
+                    (maxX == other.maxX) && (maxY == other.maxY) && (maxZ == other.maxZ));
+
+        }   /* same_spaces() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de espacios.
+         * @param  void
+         * @return Número de espacios.
+         */
+        size_t
+        size(void)
+        {
+            return minX.size();
+
+        }   /* size() */
+};
+
+#endif /* SPACE_SOA_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,299 @@
+/**
+ * @file     trace_ring_t.h
+ *
+ * @brief    Búfer circular binario para las trazas del logger.
+ *
+ * Con LOG_TO_RING a 1, los mensajes del logger no se imprimen al momento: se
+ * guarda un registro binario (nivel, instante, etiqueta, formato y hasta
+ * TRACE_RING_ARGS argumentos enteros) en un búfer circular de TRACE_RING_SIZE
+ * entradas. Guardar un registro no formatea nada ni reserva memoria; el texto
+ * solo se genera al volcar el búfer con dump(), por ejemplo al terminar el
+ * programa o tras un fallo (ver install_post_mortem()). Las etiquetas y los
+ * formatos tienen que ser literales, porque solo se guarda el puntero.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del búfer de trazas
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef TRACE_RING_T_H
+#define TRACE_RING_T_H
+
+#include <atomic>
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+using namespace std;
+
+// Número de registros del búfer (potencia de 2) y de argumentos por registro.
+#define TRACE_RING_SIZE 4096
+#define TRACE_RING_ARGS 8
+
+class trace_ring_t
+{
+    private:
+
+        typedef struct
+        {
+            atomic<uint64_t> sequence; // índice del registro + 1 (0 = vacío)
+            int64_t nanoseconds;       // desde el primer registro del búfer
+            int level;
+            int numArgs;
+            const char * tag;
+            const char * format;
+            int64_t args[TRACE_RING_ARGS];
+
+        } record_t;
+
+        // ATRIBUTOS.
+        record_t records[TRACE_RING_SIZE];
+        atomic<uint64_t> next;
+        chrono::steady_clock::time_point start;
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase trace_ring_t.
+         */
+        trace_ring_t(void)
+        {
+            for (size_t i = 0; i < TRACE_RING_SIZE; i++)
+            {
+                records[i].sequence.store(0, memory_order_relaxed);
+            }
+
+            next.store(0, memory_order_relaxed);
+            start = chrono::steady_clock::now();
+
+        }   /* trace_ring_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve la etiqueta de texto de un nivel del logger.
+         */
+        static const char *
+        level_name(int level)
+        {
+            static const char * NAMES[7] = {"NONE", "FATAL", "ERROR", "WARN", "INFO", "DEBUG", "TRACE"};
+            return (((level >= 0) && (level <= 6)) ? (NAMES[level]) : ("?"));
+
+        }   /* level_name() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe un formato de printf sustituyendo cada conversión por
+         *         el siguiente argumento guardado (los enteros se pasan siempre
+         *         como long long, sea cual sea el modificador de longitud).
+         */
+        static void
+        print_format(FILE * out, const char * format, const int64_t * args, int numArgs)
+        {
+            int used = 0;
+
+            for (const char * p = format; (*p != '\0'); p++)
+            {
+                if (*p != '%')
+                {
+                    fputc(*p, out);
+                    continue;
+                }
+
+                if (p[1] == '%')
+                {
+                    fputc('%', out);
+                    p++;
+                    continue;
+                }
+
+                // %[flags][ancho][.precisión][longitud]conversión
+                char spec[32] = "%";
+                size_t length = 1;
+
+                for (p++; (*p != '\0') && (strchr("-+ #0123456789.", *p) != NULL); p++)
+                {
+                    if (length < (sizeof(spec) - 4))
+                    {
+                        spec[length++] = *p;
+                    }
+                }
+
+                while ((*p != '\0') && (strchr("hlLqjzt", *p) != NULL))
+                {
+                    p++;
+                }
+
+                if (*p == '\0')
+                {
+                    break;
+                }
+
+                if ((used < numArgs) && (strchr("diouxXc", *p) != NULL))
+                {
+                    if (*p != 'c')
+                    {
+                        spec[length++] = 'l';
+                        spec[length++] = 'l';
+                    }
+                    spec[length++] = *p;
+                    spec[length] = '\0';
+
+                    if (*p == 'c')
+                    {
+                        fprintf(out, spec, (int)args[used]);
+                    }
+                    else
+                    {
+                        fprintf(out, spec, (long long)args[used]);
+                    }
+                }
+                else
+                {
+                    fputc('?', out); // conversión no soportada o sin argumento
+                }
+
+                used++;
+            }
+
+        }   /* print_format() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelca el búfer global por stderr (al salir o tras una señal).
+         */
+        static void
+        dump_at_exit(void)
+        {
+            instance().dump(stderr);
+
+        }   /* dump_at_exit() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelca el búfer global por stderr y vuelve a lanzar la señal.
+         */
+        static void
+        dump_on_signal(int signum)
+        {
+            signal(signum, SIG_DFL);
+            fprintf(stderr, "--- señal %d: últimas trazas ---\n", signum);
+            instance().dump(stderr);
+            raise(signum);
+
+        }   /* dump_on_signal() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el búfer global (se crea la primera vez).
+         * @param  void
+         * @return El búfer.
+         */
+        static trace_ring_t &
+        instance(void)
+        {
+            static trace_ring_t ring;
+            return ring;
+
+        }   /* instance() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda un registro. Si el búfer está lleno se pisa el más
+         *         antiguo. Se puede llamar desde varios hilos a la vez.
+         * @param  level   Nivel del mensaje.
+         * @param  tag     Etiqueta (literal).
+         * @param  format  Formato de printf (literal).
+         * @param  args    Argumentos enteros del formato.
+         * @return void
+         */
+        template <typename... Args>
+        void
+        record(int level, const char * tag, const char * format, Args... args)
+        {
+            static_assert(sizeof...(Args) <= TRACE_RING_ARGS, "demasiados argumentos para trace_ring_t");
+            static_assert(conjunction<bool_constant<is_integral<Args>::value || is_enum<Args>::value>...>::value,
+                          "trace_ring_t solo guarda argumentos enteros");
+
+            uint64_t index = next.fetch_add(1, memory_order_relaxed);
+            record_t & r = records[index & (TRACE_RING_SIZE - 1)];
+            int64_t values[TRACE_RING_ARGS + 1] = {((int64_t)args)...};
+
+            r.sequence.store(0, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+
+            r.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            r.level = level;
+            r.numArgs = (int)sizeof...(Args);
+            r.tag = tag;
+            r.format = format;
+            memcpy(r.args, values, sizeof(r.args));
+
+            r.sequence.store(index + 1, memory_order_release);
+
+        }   /* record() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Escribe los registros guardados, del más antiguo al más
+         *         reciente, con el mismo formato que el logger y el instante en
+         *         microsegundos. Los registros que se están escribiendo en ese
+         *         momento se saltan.
+         * @param  out  Donde se escriben.
+         * @return Número de registros escritos.
+         */
+        size_t
+        dump(FILE * out)
+        {
+            uint64_t last = next.load(memory_order_acquire);
+            uint64_t first = (last > TRACE_RING_SIZE) ? (last - TRACE_RING_SIZE) : (0);
+            size_t written = 0;
+
+            for (uint64_t index = first; index < last; index++)
+            {
+                record_t & r = records[index & (TRACE_RING_SIZE - 1)];
+
+                if (r.sequence.load(memory_order_acquire) != (index + 1))
+                {
+                    continue;
+                }
+
+                fprintf(out, "%12.3f [%s] %s: ", r.nanoseconds / 1000.0, level_name(r.level), r.tag);
+                print_format(out, r.format, r.args, r.numArgs);
+                fputc('\n', out);
+                written++;
+            }
+
+            fflush(out);
+            return (written);
+
+        }   /* dump() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelca el búfer por stderr al terminar el programa y también
+         *         si el programa muere por SIGSEGV, SIGABRT, SIGFPE o SIGBUS.
+         * @param  void
+         * @return void
+         */
+        static void
+        install_post_mortem(void)
+        {
+            atexit(dump_at_exit);
+            signal(SIGSEGV, dump_on_signal);
+            signal(SIGABRT, dump_on_signal);
+            signal(SIGFPE,  dump_on_signal);
+            signal(SIGBUS,  dump_on_signal);
+
+        }   /* install_post_mortem() */
+};
+
+#endif /* TRACE_RING_T_H */
+
+/*** end of file ***/
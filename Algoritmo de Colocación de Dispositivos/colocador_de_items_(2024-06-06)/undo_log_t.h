@@ -0,0 +1,372 @@
+/**
+ * @file     undo_log_t.h
+ *
+ * @brief    Registro de deshacer (undo log) del estado de colocación de box_t.
+ *
+ * Mientras está activo, cada cambio de spaceInUse, itemsToPlace, placedItems,
+ * del validador y de las rejillas de vóxeles se hace a través de este
+ * registro, que apunta lo necesario para deshacerlo. Los nodos no se
+ * destruyen: los items colocados pasan con splice() de itemsToPlace a
+ * placedItems y los espacios borrados a una lista "cementerio"; al deshacer
+ * vuelven con splice() a su posición, así que ni se copian items ni se
+ * invalidan iteradores. De cada marca en una rejilla se guardan las filas que
+ * toca, y al deshacer se copian de vuelta. El índice espacial se deshace con
+ * sus propios insert() y remove().
+ *
+ * Tomar un punto de control cuesta O(1) y volver a él, O(cambios desde
+ * entonces): un cambio cuesta al deshacerlo lo mismo que costó hacerlo.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del registro de deshacer
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef UNDO_LOG_T_H
+#define UNDO_LOG_T_H
+
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+#include "item_t.h"
+#include "placement_validator_t.h"
+#include "space_index_t.h"
+#include "voxel_grid_t.h"
+
+using namespace std;
+
+// static const char * UNDO_LOG_TAG = __FILE__;
+static const char * UNDO_LOG_TAG = "undo_log_t.h";
+
+typedef enum
+{
+    UNDO_PLACE_ITEM,    // item pasado de itemsToPlace al final de placedItems
+    UNDO_ERASE_SPACE,   // espacio borrado de spaceInUse
+    UNDO_PUSH_SPACE,    // espacio añadido al principio de spaceInUse
+    UNDO_SET_SPACE,     // espacio de spaceInUse modificado
+    UNDO_VALIDATOR_ADD, // posición añadida al validador
+    UNDO_SET_REGION     // región marcada en una rejilla de vóxeles
+
+} undoType_t;
+
+class undo_log_t
+{
+    private:
+
+        // Un cambio registrado. Solo se usan los campos de su tipo.
+        typedef struct
+        {
+            undoType_t type;
+            pmr::list<item_t>::iterator itemNext;  // posición a la que vuelve
+            pmr::list<space_t>::iterator space;    // nodo afectado de spaceInUse
+            pmr::list<space_t>::iterator spaceNext;
+            space_t oldSpace;                      // o la región marcada
+            voxel_grid_t * grid;                   // rejilla marcada
+            size_t words;                          // sus filas, desde savedWords[words]
+
+        } entry_t;
+
+        // ATRIBUTOS.
+        pmr::vector<entry_t> entries;
+        pmr::list<space_t> spaceGraveyard; // mismo memory_resource que spaceInUse
+        pmr::vector<uint64_t> savedWords;  // filas de las rejillas antes de marcarlas
+        bool enabled;
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase undo_log_t.
+         * @param  resource  El memory_resource de las listas de la caja (splice()
+         *                   solo puede mover nodos entre listas del mismo).
+         */
+        undo_log_t(pmr::memory_resource * resource = pmr::get_default_resource()) :
+            entries(resource), spaceGraveyard(resource), savedWords(resource)
+        {
+            this->enabled = false;
+
+        }   /* undo_log_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si se están registrando los cambios.
+         * @param  void
+         * @return Verdadero o falso.
+         */
+        bool
+        is_enabled(void)
+        {
+            return enabled;
+
+        }   /* is_enabled() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Activa el registro y devuelve la posición actual, a la que se
+         *         puede volver con undo_to().
+         * @param  void
+         * @return La marca del punto de control.
+         */
+        size_t
+        mark(void)
+        {
+            enabled = true;
+            return (entries.size());
+
+        }   /* mark() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Olvida todos los cambios registrados (el estado actual se
+         *         queda como está) y desactiva el registro.
+         * @param  void
+         * @return void
+         */
+        void
+        clear(void)
+        {
+            entries.clear();
+            spaceGraveyard.clear();
+            savedWords.clear();
+            enabled = false;
+
+        }   /* clear() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Pasa un item de itemsToPlace al final de placedItems. El nodo
+         *         se mueve con splice(): el item no se copia.
+         * @param  items   La lista itemsToPlace.
+         * @param  placed  La lista placedItems.
+         * @param  it      El item a mover.
+         * @return El iterador al siguiente item de itemsToPlace.
+         */
+        pmr::list<item_t>::iterator
+        place_item(pmr::list<item_t> * items, pmr::list<item_t> * placed,
+                   pmr::list<item_t>::iterator it)
+        {
+            pmr::list<item_t>::iterator next = std::next(it);
+
+            placed->splice(placed->end(), *items, it);
+
+            if (enabled)
+            {
+                entry_t e;
+                e.type = UNDO_PLACE_ITEM;
+                e.itemNext = next;
+                entries.push_back(e);
+            }
+
+            return (next);
+
+        }   /* place_item() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Borra un espacio de spaceInUse.
+         * @param  spaces  La lista.
+         * @param  it      El espacio a borrar.
+         * @return El iterador al siguiente espacio.
+         */
+        pmr::list<space_t>::iterator
+        erase_space(pmr::list<space_t> * spaces, pmr::list<space_t>::iterator it)
+        {
+            if (!enabled)
+            {
+                return (spaces->erase(it));
+            }
+
+            entry_t e;
+            e.type = UNDO_ERASE_SPACE;
+            e.space = it;
+            e.spaceNext = std::next(it);
+            entries.push_back(e);
+
+            spaceGraveyard.splice(spaceGraveyard.end(), *spaces, it);
+            return (e.spaceNext);
+
+        }   /* erase_space() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade un espacio al principio de spaceInUse.
+         * @param  spaces  La lista.
+         * @param  space   El espacio a añadir.
+         * @return void
+         */
+        void
+        push_front_space(pmr::list<space_t> * spaces, space_t space)
+        {
+            spaces->push_front(space);
+
+            if (enabled)
+            {
+                entry_t e;
+                e.type = UNDO_PUSH_SPACE;
+                e.space = spaces->begin();
+                entries.push_back(e);
+            }
+
+        }   /* push_front_space() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Apunta el valor de un espacio antes de modificarlo.
+         * @param  it  El espacio que se va a modificar.
+         * @return void
+         */
+        void
+        before_set_space(pmr::list<space_t>::iterator it)
+        {
+            if (enabled)
+            {
+                entry_t e;
+                e.type = UNDO_SET_SPACE;
+                e.space = it;
+                e.oldSpace = *it;
+                entries.push_back(e);
+            }
+
+        }   /* before_set_space() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade una posición al validador.
+         * @param  validator  El validador.
+         * @param  position   La posición.
+         * @return void
+         */
+        void
+        validator_add(placement_validator_t * validator, space_t position)
+        {
+            if (enabled)
+            {
+                entry_t e;
+                e.type = UNDO_VALIDATOR_ADD;
+                e.oldSpace = position;
+                e.grid = validator->get_grid();
+                e.words = savedWords.size();
+                e.grid->save_region(position, &savedWords);
+                entries.push_back(e);
+            }
+
+            validator->add(position);
+
+        }   /* validator_add() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Marca una región en una rejilla de vóxeles.
+         * @param  grid    La rejilla.
+         * @param  region  La región.
+         * @return void
+         */
+        void
+        set_region(voxel_grid_t * grid, space_t region)
+        {
+            if (enabled)
+            {
+                entry_t e;
+                e.type = UNDO_SET_REGION;
+                e.oldSpace = region;
+                e.grid = grid;
+                e.words = savedWords.size();
+                grid->save_region(region, &savedWords);
+                entries.push_back(e);
+            }
+
+            grid->set_region(region);
+
+        }   /* set_region() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Deshace, en orden inverso, todos los cambios posteriores a la
+         *         marca. Los nodos vuelven a su posición con splice().
+         * @param  mark          La marca devuelta por mark().
+         * @param  itemsToPlace  La lista itemsToPlace de la caja.
+         * @param  placedItems   La lista placedItems de la caja.
+         * @param  spaceInUse    La lista spaceInUse de la caja.
+         * @param  validator     El validador de la caja.
+         * @param  index         El índice espacial de spaceInUse (o NULL si no
+         *                       se usa).
+         * @return Número de cambios deshechos.
+         */
+        size_t
+        undo_to(size_t mark, pmr::list<item_t> * itemsToPlace, pmr::list<item_t> * placedItems,
+                pmr::list<space_t> * spaceInUse, placement_validator_t * validator,
+                space_index_t * index)
+        {
+            traceln(UNDO_LOG_TAG, "undo_to()");
+
+            size_t undone = 0;
+
+            while (entries.size() > mark)
+            {
+                entry_t & e = entries.back();
+
+                switch (e.type)
+                {
+                    case UNDO_PLACE_ITEM:
+                        itemsToPlace->splice(e.itemNext, *placedItems, std::prev(placedItems->end()));
+                        break;
+
+                    case UNDO_ERASE_SPACE:
+                        spaceInUse->splice(e.spaceNext, spaceGraveyard, e.space);
+                        if (index != NULL)
+                        {
+                            index->insert(*(e.space));
+                        }
+                        break;
+
+                    case UNDO_PUSH_SPACE:
+                        if (index != NULL)
+                        {
+                            index->remove(*(e.space));
+                        }
+                        spaceInUse->erase(e.space);
+                        break;
+
+                    case UNDO_SET_SPACE:
+                        if (index != NULL)
+                        {
+                            index->remove(*(e.space));
+                            index->insert(e.oldSpace);
+                        }
+                        *(e.space) = e.oldSpace;
+                        break;
+
+                    case UNDO_VALIDATOR_ADD:
+                        validator->remove_last();
+                        e.grid->restore_region(e.oldSpace, savedWords.data() + e.words);
+                        savedWords.resize(e.words);
+                        break;
+
+                    case UNDO_SET_REGION:
+                        e.grid->restore_region(e.oldSpace, savedWords.data() + e.words);
+                        savedWords.resize(e.words);
+                        break;
+
+                    default:
+                        break;
+                }
+
+                entries.pop_back();
+                undone++;
+            }
+
+            traceln(UNDO_LOG_TAG, "undo_to() - END");
+            return (undone);
+
+        }   /* undo_to() */
+};
+
+#endif /* UNDO_LOG_T_H */
+
+/*** end of file ***/
@@ -0,0 +1,296 @@
+/**
+ * @file     voxel_grid_t.h
+ *
+ * @brief    Rejilla de ocupación por vóxeles empaquetada en palabras de 64 bits.
+ *
+ * La caja se divide en vóxeles de VOXEL_SIZE mm. Cada capa z se guarda como
+ * VOXEL_MAX_Y filas y cada fila como VOXEL_WORDS palabras de 64 bits (un bit
+ * por vóxel en el eje x). Comprobar si una región está libre se reduce a un
+ * AND con una máscara por fila, vectorizado con AVX2 cuando está disponible
+ * (dos filas por instrucción) y con una versión escalar en caso contrario.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial de la rejilla de vóxeles
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef VOXEL_GRID_T_H
+#define VOXEL_GRID_T_H
+
+#include <string.h>
+#include <memory_resource>
+#include <vector>
+#include "defines.h"
+#include "logger.h"
+#include "space_t.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// static const char * VOXEL_GRID_TAG = __FILE__;
+static const char * VOXEL_GRID_TAG = "voxel_grid_t.h";
+
+// Resolución de la rejilla (mm). Todas las medidas de cajas y dispositivos son múltiplos.
+#define VOXEL_SIZE 5
+
+// Dimensiones máximas en vóxeles (caja L: 480 x 300 x 240 mm).
+#define VOXEL_MAX_X (480 / VOXEL_SIZE)
+#define VOXEL_MAX_Y (300 / VOXEL_SIZE)
+#define VOXEL_MAX_Z (240 / VOXEL_SIZE)
+#define VOXEL_WORDS ((VOXEL_MAX_X + 63) / 64)
+
+class voxel_grid_t
+{
+    private:
+
+        // ATRIBUTOS.
+        alignas(32) uint64_t words[VOXEL_MAX_Z][VOXEL_MAX_Y][VOXEL_WORDS];
+        uint16_t cellsX, cellsY, cellsZ;
+
+        // Rango de vóxeles [x0, x1) x [y0, y1) x [z0, z1) que cubre una región.
+        typedef struct
+        {
+            uint16_t x0, y0, z0, x1, y1, z1;
+
+        } cells_t;
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula los vóxeles que cubren una región (redondeando el mínimo
+         *         hacia abajo y el máximo hacia arriba) recortados a la caja.
+         */
+        cells_t
+        to_cells(space_t region)
+        {
+            cells_t cells;
+
+            cells.x0 = region.min_x() / VOXEL_SIZE;
+            cells.y0 = region.min_y() / VOXEL_SIZE;
+            cells.z0 = region.min_z() / VOXEL_SIZE;
+            cells.x1 = (region.max_x() + VOXEL_SIZE - 1) / VOXEL_SIZE;
+            cells.y1 = (region.max_y() + VOXEL_SIZE - 1) / VOXEL_SIZE;
+            cells.z1 = (region.max_z() + VOXEL_SIZE - 1) / VOXEL_SIZE;
+
+            if (cells.x1 > cellsX) { cells.x1 = cellsX; }
+            if (cells.y1 > cellsY) { cells.y1 = cellsY; }
+            if (cells.z1 > cellsZ) { cells.z1 = cellsZ; }
+
+            return (cells);
+
+        }   /* to_cells() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Calcula la máscara de los bits [x0, x1) para cada palabra de una fila.
+         */
+        static void
+        row_mask(uint16_t x0, uint16_t x1, uint64_t mask[VOXEL_WORDS])
+        {
+            for (int w = 0; w < VOXEL_WORDS; w++)
+            {
+                int lo = (int)x0 - (w * 64);
+                int hi = (int)x1 - (w * 64);
+
+                lo = (lo < 0) ? (0) : (lo);
+                hi = (hi > 64) ? (64) : (hi);
+
+                if (hi <= lo)
+                {
+                    mask[w] = 0;
+                }
+                else
+                {
+                    uint64_t upper = (hi == 64) ? (~0ULL) : ((1ULL << hi) - 1);
+                    mask[w] = upper & ~((1ULL << lo) - 1);
+                }
+            }
+
+        }   /* row_mask() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase voxel_grid_t.
+         * @param  void
+         */
+        voxel_grid_t(void)
+        {
+            traceln(VOXEL_GRID_TAG, "voxel_grid_t()");
+            reset(space_t(0, 0, 0, 480, 300, 240));
+            traceln(VOXEL_GRID_TAG, "voxel_grid_t() - END");
+
+        }   /* voxel_grid_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vacía la rejilla y la ajusta a las dimensiones de la caja.
+         * @param  boxSize  El tamaño interior de la caja.
+         * @return void
+         */
+        void
+        reset(space_t boxSize)
+        {
+            traceln(VOXEL_GRID_TAG, "reset()");
+
+            cellsX = boxSize.max_x() / VOXEL_SIZE;
+            cellsY = boxSize.max_y() / VOXEL_SIZE;
+            cellsZ = boxSize.max_z() / VOXEL_SIZE;
+
+            memset(words, 0, sizeof(words));
+
+            traceln(VOXEL_GRID_TAG, "reset() - END");
+
+        }   /* reset() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Marca como ocupados todos los vóxeles que tocan la región.
+         * @param  region  La región a marcar.
+         * @return void
+         */
+        void
+        set_region(space_t region)
+        {
+            traceln(VOXEL_GRID_TAG, "set_region()");
+
+            cells_t c = to_cells(region);
+            uint64_t mask[VOXEL_WORDS];
+
+            row_mask(c.x0, c.x1, mask);
+
+            for (uint16_t z = c.z0; z < c.z1; z++)
+            {
+                for (uint16_t y = c.y0; y < c.y1; y++)
+                {
+                    for (int w = 0; w < VOXEL_WORDS; w++)
+                    {
+                        words[z][y][w] |= mask[w];
+                    }
+                }
+            }
+
+            traceln(VOXEL_GRID_TAG, "set_region() - END");
+
+        }   /* set_region() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Guarda las palabras de las filas que tocan la región, para
+         *         poder deshacer un set_region() con restore_region().
+         * @param  region  La región que se va a marcar.
+         * @param  saved   Donde se añaden las palabras.
+         * @return void
+         */
+        void
+        save_region(space_t region, pmr::vector<uint64_t> * saved)
+        {
+            cells_t c = to_cells(region);
+            size_t layer = (c.y1 > c.y0) ? ((c.y1 - c.y0) * VOXEL_WORDS) : (0);
+
+            // Las filas de una capa son contiguas.
+            for (uint16_t z = c.z0; z < c.z1; z++)
+            {
+                saved->insert(saved->end(), &words[z][c.y0][0], &words[z][c.y0][0] + layer);
+            }
+
+        }   /* save_region() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Vuelve a dejar las filas que tocan la región como las guardó
+         *         save_region().
+         * @param  region  La misma región que se pasó a save_region().
+         * @param  saved   Las palabras guardadas.
+         * @return void
+         */
+        void
+        restore_region(space_t region, const uint64_t * saved)
+        {
+            cells_t c = to_cells(region);
+            size_t layer = (c.y1 > c.y0) ? ((c.y1 - c.y0) * VOXEL_WORDS) : (0);
+
+            for (uint16_t z = c.z0; z < c.z1; z++, saved += layer)
+            {
+                memcpy(&words[z][c.y0][0], saved, layer * sizeof(uint64_t));
+            }
+
+        }   /* restore_region() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si dos rejillas marcan exactamente los mismos vóxeles.
+         * @param  other  La otra rejilla.
+         * @return Verdadero o falso.
+         */
+        bool
+        equals(const voxel_grid_t & other) const
+        {
+            return ((cellsX == other.cellsX) && (cellsY == other.cellsY) && (cellsZ == other.cellsZ) &&
+                    (memcmp(words, other.words, sizeof(words)) == 0));
+
+        }   /* equals() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Indica si ninguno de los vóxeles que tocan la región está ocupado.
+         * @param  region  La región a consultar.
+         * @return Verdadero si la región está libre.
+         */
+        bool
+        is_region_free(space_t region)
+        {
+            traceln(VOXEL_GRID_TAG, "is_region_free()");
+
+            cells_t c = to_cells(region);
+            uint64_t mask[VOXEL_WORDS];
+            uint64_t acc = 0;
+
+            row_mask(c.x0, c.x1, mask);
+
+            for (uint16_t z = c.z0; (z < c.z1) && (acc == 0); z++)
+            {
+                uint16_t y = c.y0;
+
+                #if defined(__AVX2__) && (VOXEL_WORDS == 2)
+                // Dos filas (4 palabras) por instrucción.
+                const __m256i vmask = _mm256_set_epi64x(mask[1], mask[0], mask[1], mask[0]);
+                __m256i vacc = _mm256_setzero_si256();
+
+                for (; (y + 2) <= c.y1; y += 2)
+                {
+                    __m256i rows = _mm256_loadu_si256((const __m256i *)(&words[z][y][0]));
+                    vacc = _mm256_or_si256(vacc, _mm256_and_si256(rows, vmask));
+                }
+
+                if (!(_mm256_testz_si256(vacc, vacc)))
+                {
+                    acc = 1;
+                }
+                #endif
+
+                // Versión escalar (y filas restantes).
+                for (; y < c.y1; y++)
+                {
+                    for (int w = 0; w < VOXEL_WORDS; w++)
+                    {
+                        acc |= (words[z][y][w] & mask[w]);
+                    }
+                }
+            }
+
+            traceln(VOXEL_GRID_TAG, "is_region_free() - END");
+            return (acc == 0);
+
+        }   /* is_region_free() */
+};
+
+#endif /* VOXEL_GRID_T_H */
+
+/*** end of file ***/
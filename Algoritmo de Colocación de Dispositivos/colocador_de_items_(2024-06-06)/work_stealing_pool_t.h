@@ -0,0 +1,259 @@
+/**
+ * @file     work_stealing_pool_t.h
+ *
+ * @brief    Grupo de hilos con robo de tareas (work stealing).
+ *
+ * Cada hilo tiene su propia cola de tareas. Un hilo saca tareas del final de
+ * su cola y, cuando se queda sin trabajo, roba tareas del principio de la cola
+ * de otro hilo. Así la carga se reparte sola aunque unas tareas (pedidos)
+ * cuesten mucho más que otras. Los hilos sin trabajo duermen en una variable
+ * de condición hasta que submit() encola una tarea o se destruye el grupo.
+ *
+ * @version  0.7   (2026/10/18) Prototipo inicial del grupo de hilos
+ *
+ * @author   Grupo PR2-A04' <mbelmar@etsinf.upv.es>
+ *
+ * @date     Octubre, 2026
+ * @section  PR2-GIIROB
+ */
+
+#ifndef WORK_STEALING_POOL_T_H
+#define WORK_STEALING_POOL_T_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "logger.h"
+
+using namespace std;
+
+// static const char * POOL_TAG = __FILE__;
+static const char * POOL_TAG = "work_stealing_pool_t.h";
+
+class work_stealing_pool_t
+{
+    private:
+
+        // Cola de tareas de un hilo.
+        typedef struct
+        {
+            mutex lock;
+            deque< function<void(void)> > tasks;
+
+        } worker_queue_t;
+
+        // ATRIBUTOS.
+        vector< unique_ptr<worker_queue_t> > queues;
+        vector<thread> workers;
+        atomic<size_t> pending;     // tareas enviadas y aún no terminadas
+        atomic<long> queued;        // tareas en las colas, sin empezar (puede
+                                    // bajar un momento de 0 si una tarea se
+                                    // saca antes de que submit() la cuente)
+        atomic<size_t> nextQueue;   // reparto round-robin de submit()
+        atomic<bool> stopping;
+        mutex sleepLock;
+        condition_variable wakeUp;  // hay tareas nuevas o hay que salir
+        condition_variable allDone; // pending ha llegado a 0
+
+        /******************************************************************************/
+        /*!
+         * @brief  Saca una tarea de la cola propia (por el final) o, si está
+         *         vacía, la roba de la cola de otro hilo (por el principio).
+         * @param  self  Índice del hilo que busca trabajo.
+         * @param  task  Devuelve la tarea obtenida.
+         * @return Verdadero si se ha obtenido una tarea.
+         */
+        bool
+        take_task(size_t self, function<void(void)> * task)
+        {
+            {
+                lock_guard<mutex> guard(queues[self]->lock);
+
+                if (!(queues[self]->tasks.empty()))
+                {
+                    *task = std::move(queues[self]->tasks.back());
+                    queues[self]->tasks.pop_back();
+                    queued.fetch_sub(1);
+                    return (true);
+                }
+            }
+
+            for (size_t i = 1; i < queues.size(); i++)
+            {
+                worker_queue_t * victim = queues[(self + i) % queues.size()].get();
+                lock_guard<mutex> guard(victim->lock);
+
+                if (!(victim->tasks.empty()))
+                {
+                    *task = std::move(victim->tasks.front());
+                    victim->tasks.pop_front();
+                    queued.fetch_sub(1);
+                    return (true);
+                }
+            }
+
+            return (false);
+
+        }   /* take_task() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Bucle de cada hilo: ejecuta tareas hasta que se destruye el grupo.
+         * @param  self  Índice del hilo.
+         * @return void
+         */
+        void
+        worker_loop(size_t self)
+        {
+            traceln(POOL_TAG, "worker_loop()");
+
+            function<void(void)> task;
+
+            while (!(stopping.load()))
+            {
+                if (take_task(self, &task))
+                {
+                    task();
+                    task = nullptr;
+
+                    if (pending.fetch_sub(1) == 1)
+                    {
+                        lock_guard<mutex> guard(sleepLock);
+                        allDone.notify_all();
+                    }
+                }
+                else
+                {
+                    // submit() y el destructor cambian queued y stopping con
+                    // sleepLock tomado, así que no se pierde ningún aviso.
+                    unique_lock<mutex> guard(sleepLock);
+                    wakeUp.wait(guard, [this]() { return ((queued.load() > 0) || stopping.load()); });
+                }
+            }
+
+            traceln(POOL_TAG, "worker_loop() - END");
+
+        }   /* worker_loop() */
+
+    public:
+
+        /******************************************************************************/
+        /*!
+         * @brief  El constructor de la clase work_stealing_pool_t.
+         * @param  numThreads  Número de hilos (0 = uno por núcleo).
+         */
+        work_stealing_pool_t(unsigned numThreads)
+        {
+            traceln(POOL_TAG, "work_stealing_pool_t()");
+
+            if (numThreads == 0)
+            {
+                numThreads = thread::hardware_concurrency();
+                numThreads = (numThreads == 0) ? (1) : (numThreads);
+            }
+
+            pending = 0;
+            queued = 0;
+            nextQueue = 0;
+            stopping = false;
+
+            for (unsigned i = 0; i < numThreads; i++)
+            {
+                queues.push_back(unique_ptr<worker_queue_t>(new worker_queue_t));
+            }
+
+            for (unsigned i = 0; i < numThreads; i++)
+            {
+                workers.push_back(thread(&work_stealing_pool_t::worker_loop, this, (size_t)i));
+            }
+
+            traceln(POOL_TAG, "work_stealing_pool_t() - END");
+
+        }   /* work_stealing_pool_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  El destructor de la clase work_stealing_pool_t. Espera a que
+         *         terminen las tareas pendientes y detiene los hilos.
+         * @param  void
+         */
+        ~work_stealing_pool_t(void)
+        {
+            traceln(POOL_TAG, "~work_stealing_pool_t()");
+
+            wait_idle();
+            {
+                lock_guard<mutex> guard(sleepLock);
+                stopping = true;
+            }
+            wakeUp.notify_all();
+
+            for (size_t i = 0; i < workers.size(); i++)
+            {
+                workers[i].join();
+            }
+
+            traceln(POOL_TAG, "~work_stealing_pool_t() - END");
+
+        }   /* ~work_stealing_pool_t() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Añade una tarea al grupo.
+         * @param  task  La tarea a ejecutar.
+         * @return void
+         */
+        void
+        submit(function<void(void)> task)
+        {
+            size_t target = nextQueue.fetch_add(1) % queues.size();
+
+            pending.fetch_add(1);
+            {
+                lock_guard<mutex> guard(queues[target]->lock);
+                queues[target]->tasks.push_back(std::move(task));
+            }
+            {
+                lock_guard<mutex> guard(sleepLock);
+                queued.fetch_add(1);
+            }
+            wakeUp.notify_one();
+
+        }   /* submit() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Bloquea hasta que todas las tareas enviadas han terminado.
+         * @param  void
+         * @return void
+         */
+        void
+        wait_idle(void)
+        {
+            unique_lock<mutex> guard(sleepLock);
+            allDone.wait(guard, [this]() { return (pending.load() == 0); });
+
+        }   /* wait_idle() */
+
+        /******************************************************************************/
+        /*!
+         * @brief  Devuelve el número de hilos del grupo.
+         * @param  void
+         * @return Número de hilos.
+         */
+        size_t
+        get_num_threads(void)
+        {
+            return workers.size();
+
+        }   /* get_num_threads() */
+};
+
+#endif /* WORK_STEALING_POOL_T_H */
+
+/*** end of file ***/
@@ -9,6 +9,7 @@ Subprogramas para (fill_box): (copy_object) y (pick_dispositivo).
 # IMPORTACIONES NECESARIAS
 
 from json.__init__ import loads as json_loads
+from struct import calcsize, unpack_from
 import numpy as np
 
 from robodk.robolink import ITEM_TYPE_FRAME, ITEM_TYPE_PROGRAM
@@ -81,6 +82,94 @@ def stop_all():
 
     ### end def stop_all() ###
 
+def msgpack_loads(data, pos=0):
+    """
+    Decodifica el valor MessagePack que empieza en data[pos] y devuelve el
+    valor y la posición siguiente. Solo admite los tipos que puede escribir
+    el colocador de items (mapas, arrays, cadenas, enteros y float).
+    """
+
+    tag = data[pos]
+    pos += 1
+
+    if tag <= 0x7f:                                 # positive fixint
+        return tag, pos
+    if tag >= 0xe0:                                 # negative fixint
+        return tag - 0x100, pos
+    if 0x80 <= tag <= 0x8f or tag in (0xde, 0xdf):  # map
+        if tag <= 0x8f:
+            size = tag & 0x0f
+        else:
+            size = unpack_from('>H' if tag == 0xde else '>I', data, pos)[0]
+            pos += 2 if tag == 0xde else 4
+        value = {}
+        for _ in range(size):
+            key, pos = msgpack_loads(data, pos)
+            value[key], pos = msgpack_loads(data, pos)
+        return value, pos
+    if 0x90 <= tag <= 0x9f or tag in (0xdc, 0xdd):  # array
+        if tag <= 0x9f:
+            size = tag & 0x0f
+        else:
+            size = unpack_from('>H' if tag == 0xdc else '>I', data, pos)[0]
+            pos += 2 if tag == 0xdc else 4
+        value = []
+        for _ in range(size):
+            element, pos = msgpack_loads(data, pos)
+            value.append(element)
+        return value, pos
+    if 0xa0 <= tag <= 0xbf or tag in (0xd9, 0xda, 0xdb):  # str
+        if tag <= 0xbf:
+            size = tag & 0x1f
+        else:
+            width = {0xd9: 1, 0xda: 2, 0xdb: 4}[tag]
+            size = int.from_bytes(data[pos:pos + width], 'big')
+            pos += width
+        return data[pos:pos + size].decode('UTF-8'), pos + size
+
+    formats = {0xca: '>f', 0xcb: '>d', 0xcc: '>B', 0xcd: '>H', 0xce: '>I',
+               0xcf: '>Q', 0xd0: '>b', 0xd1: '>h', 0xd2: '>i', 0xd3: '>q'}
+    if tag in formats:
+        return unpack_from(formats[tag], data, pos)[0], pos + calcsize(formats[tag])
+    if tag == 0xc0:
+        return None, pos
+    if tag in (0xc2, 0xc3):
+        return tag == 0xc3, pos
+
+    raise ValueError('Tipo MessagePack no soportado: 0x%02x' % tag)
+
+    ### end def msgpack_loads() ###
+
+def parse_orden(payload):
+    """
+    Convierte la orden del robot industrial en un diccionario con el esquema
+    de la orden JSON ("item_1", "item_2", ...). La orden puede llegar en JSON
+    o en MessagePack, y con cualquiera de los dos esquemas: la ESP32-02
+    reenvía con serializeJson() la orden que ha leído, así que una orden
+    MessagePack llega como JSON con las claves "items" y "dispositivos". En el
+    esquema MessagePack la "posicion_place" de cada item ya es una lista de 6
+    números.
+    """
+
+    if payload[:1] == b'{':
+        orden = json_loads(payload.decode('UTF-8'))
+    else:
+        orden, _ = msgpack_loads(payload)
+
+    if "items" not in orden:
+        return orden
+
+    msg_dict = {"tipo_caja": orden["tipo_caja"],
+                "num_dispositivos": orden["num_dispositivos"]}
+
+    for i, item in enumerate(orden["items"], start=1):
+        msg_dict["item_" + str(i)] = {"dispositivo": orden["dispositivos"][item[0]],
+                                      "posicion_place": list(item[1:7])}
+
+    return msg_dict
+
+    ### end def parse_orden() ###
+
 def assemble_box(msg):
     """
     Esta función analiza el mensaje recibido (en concreto la información sobre
@@ -329,8 +418,8 @@ def fill_box(msg):
     # Establecer 'caja_llena' = "caja en proceso":
     RDK.setParam("caja_llena", "caja en proceso")
 
-    # El primer paso es parsear msg:
-    msg_dict = json_loads((msg.payload).decode('UTF-8'))
+    # El primer paso es parsear msg (JSON o MessagePack):
+    msg_dict = parse_orden(msg.payload)
 
     num_dispositivos = msg_dict["num_dispositivos"]
     tipo_caja = msg_dict["tipo_caja"]
@@ -343,8 +432,11 @@ def fill_box(msg):
 
         iterator = "item_" + str(i)
 
-        # Conversión de str a vector de posiciones:
-        pose_array = np.fromstring(msg_dict[iterator]["posicion_place"], sep=',')
+        # Conversión de str (o de la lista de la orden binaria) a vector de posiciones:
+        if isinstance(msg_dict[iterator]["posicion_place"], str):
+            pose_array = np.fromstring(msg_dict[iterator]["posicion_place"], sep=',')
+        else:
+            pose_array = np.array(msg_dict[iterator]["posicion_place"], dtype=float)
 
         place_pose = xyzrpw_2_pose(pose_array)
 
@@ -35,6 +35,14 @@ void consulta_BBDD_y_generar_orden(char * id_caja, JsonDocument * orden_id_caja)
     //              "posicion_place": "120.0, 225.0, 40.0, -180.0, 0.0, 0.0"
     //            }
     //          }
+    //
+    //       El colocador de items también genera la orden en MessagePack
+    //       (--format msgpack, ver box_t::write_msgpack_order()), que se
+    //       puede cargar en 'contenido_BBDD_id_caja' con deserializeMsgPack().
+    //       retenedor_camara_task() reenvía el documento con serializeJson(),
+    //       así que al robot le llega en JSON pero con el esquema MessagePack
+    //       ("items" y "dispositivos"); parse_orden() de functions.py acepta
+    //       los dos esquemas.
 }
 
 /*** end of file ***/
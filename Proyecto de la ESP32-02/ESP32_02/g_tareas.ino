@@ -101,7 +101,8 @@ void retenedor_camara_task(void * parameter)
 
             /* ENVIAR ORDEN AL ROBOT INDUSTRIAL */
 
-            // Serializar el JSON en un String.
+            // Serializar el JSON en un String (siempre en JSON, aunque el
+            // documento se haya leído en MessagePack: ver f_funciones.ino).
             String msg_json;
             serializeJson(contenido_BBDD_id_caja, msg_json);
 